@@ -0,0 +1,117 @@
+// Copyright Samuel Stark 2017
+
+// Runs a group of instances of one ROM for a number of frames, first one after another and then through GB::Lockstep,
+// and reports the frames per second of the whole group for each. Every instance gets its own pseudo-random input each frame,
+// the same both times, so the two runs must finish in exactly the same state.
+
+#include "gb/cpu.h"
+#include "gb/lockstep.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace{
+	constexpr unsigned int FRAME_CYCLES = 70224;
+
+	void on_vblank(GB::CPU& cpu){}
+
+	std::vector<std::unique_ptr<GB::CPU>> make_instances(const std::vector<uint8_t>& rom, int count){
+		std::array<uint8_t, GB::MMU::BIOS_SIZE> bios = {{ 0 }};
+		std::vector<std::unique_ptr<GB::CPU>> cpus;
+		for (int i = 0; i < count; i++){
+			cpus.emplace_back(new GB::CPU(bios, rom, on_vblank));
+			cpus.back()->reset();
+			cpus.back()->exit_bios();
+			cpus.back()->registers.pc = 0x100;
+		}
+		return cpus;
+	}
+
+	// A small LCG per instance, so the inputs don't depend on how the instances are run
+	uint8_t next_input(uint32_t& seed){
+		seed = seed * 1664525 + 1013904223;
+		return seed >> 24;
+	}
+
+	template<typename RunFrame>
+	double time_frames(std::vector<std::unique_ptr<GB::CPU>>& cpus, int frames, RunFrame run_frame){
+		std::vector<uint32_t> seeds;
+		for (size_t i = 0; i < cpus.size(); i++){
+			seeds.push_back(i + 1);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		for (int frame = 0; frame < frames; frame++){
+			for (size_t i = 0; i < cpus.size(); i++){
+				cpus[i]->input.set_pressed(next_input(seeds[i]));
+			}
+			run_frame();
+		}
+		auto end = std::chrono::steady_clock::now();
+		return std::chrono::duration<double>(end - start).count();
+	}
+}
+
+int main(int argc, char* argv[]){
+	if (argc < 2){
+		fprintf(stderr, "Usage: %s <rom> [instances] [frames]\n", argv[0]);
+		return 1;
+	}
+	const int instances = argc > 2 ? atoi(argv[2]) : 8;
+	const int frames = argc > 3 ? atoi(argv[3]) : 600;
+	if (instances < 1 || instances > GB::Lockstep::MAX_INSTANCES || frames < 1){
+		fprintf(stderr, "instances should be from 1 to %d, and frames at least 1\n", GB::Lockstep::MAX_INSTANCES);
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file){
+		fprintf(stderr, "Couldn't open %s\n", argv[1]);
+		return 1;
+	}
+	std::vector<uint8_t> rom((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	GB::CPU::limit_fps = false;
+
+	auto scalar_cpus = make_instances(rom, instances);
+	const double scalar_time = time_frames(scalar_cpus, frames, [&]{
+		for (auto& cpu : scalar_cpus){
+			const unsigned int start_cycles = cpu->clock_cycles;
+			while (!cpu->stopped && cpu->clock_cycles - start_cycles < FRAME_CYCLES){
+				cpu->step();
+			}
+		}
+	});
+
+	auto lockstep_cpus = make_instances(rom, instances);
+	std::vector<GB::CPU*> lanes;
+	for (auto& cpu : lockstep_cpus){
+		lanes.push_back(cpu.get());
+	}
+	GB::Lockstep lockstep(lanes);
+	const double lockstep_time = time_frames(lockstep_cpus, frames, [&]{
+		lockstep.run(FRAME_CYCLES);
+	});
+
+	int mismatches = 0;
+	for (int i = 0; i < instances; i++){
+		if (scalar_cpus[i]->save_state() != lockstep_cpus[i]->save_state()){
+			fprintf(stderr, "Instance %d finished in a different state under Lockstep\n", i);
+			mismatches++;
+		}
+	}
+
+	const double total_frames = static_cast<double>(frames) * instances;
+	const uint64_t total_instructions = lockstep.vector_instructions + lockstep.scalar_instructions;
+	fprintf(stdout, "%d instances, %d frames each\n", instances, frames);
+	fprintf(stdout, "One at a time: %8.1f frames/s\n", total_frames / scalar_time);
+	fprintf(stdout, "Lockstep:      %8.1f frames/s (%+.1f%%)\n", total_frames / lockstep_time, (scalar_time / lockstep_time - 1) * 100);
+	fprintf(stdout, "%.1f%% of instructions ran in lane kernels\n", total_instructions ? lockstep.vector_instructions * 100.0 / total_instructions : 0.0);
+
+	return mismatches > 0 ? 1 : 0;
+}
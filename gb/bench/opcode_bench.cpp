@@ -0,0 +1,184 @@
+// Copyright Samuel Stark 2017
+
+// Runs every opcode handler (and every CB handler) in a tight loop against a synthetic memory image,
+// and reports the time taken per instruction. Results can be saved as a baseline and compared later.
+
+#include "gb/cpu.h"
+#include "gb/instructions/instruction_set.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace{
+	constexpr uint16_t CODE_START = 0x0200;
+	constexpr int ITERATIONS = 200000;
+	constexpr int REPEATS = 5;
+	// Timings this close together are within the noise of the loop, so they never count as a regression
+	constexpr double MIN_REGRESSION_NS = 1.0;
+
+	struct Result{
+		std::string name;
+		std::string disassembly;
+		double ns_per_instruction;
+	};
+
+	void on_vblank(GB::CPU& cpu){}
+
+	// A 32kB ROM with no bank switching. Every operand reads as 0xFF80,
+	// so immediates, LDH (n) and (a16) all point into HRAM and relative jumps stay in ROM.
+	std::vector<uint8_t> make_rom(){
+		std::vector<uint8_t> rom(0x8000, 0x00);
+		const char name[] = "OPCODE BENCH";
+		memcpy(rom.data() + GB::RomData::ROM_OFFSET_NAME, name, sizeof(name) - 1);
+		rom[GB::RomData::ROM_OFFSET_TYPE] = GB::RomData::ROM_MBC1;
+		rom[GB::RomData::ROM_OFFSET_ROM_SIZE] = 0;
+		rom[GB::RomData::ROM_OFFSET_RAM_SIZE] = 0;
+
+		rom[CODE_START + 0] = 0x00; // The opcode itself isn't read, the handlers are called directly
+		rom[CODE_START + 1] = 0x80;
+		rom[CODE_START + 2] = 0xFF;
+		rom[CODE_START + 3] = 0x80;
+		rom[CODE_START + 4] = 0xFF;
+		return rom;
+	}
+
+	// Pointers all point into WRAM, SP has room to push and pop
+	GB::CPU::Registers make_registers(){
+		GB::CPU::Registers registers;
+		registers.af = 0x3C00;
+		registers.bc = 0xC080;
+		registers.de = 0xC100;
+		registers.hl = 0xC200;
+		registers.sp = 0xDFF0;
+		registers.pc = CODE_START;
+		return registers;
+	}
+
+	double time_handler(GB::CPU& cpu, uint8_t (*execute)(GB::CPU&), uint16_t operand_pc){
+		const GB::CPU::Registers registers = make_registers();
+		double best = 1e30;
+		for (int repeat = 0; repeat < REPEATS; repeat++){
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < ITERATIONS; i++){
+				cpu.registers = registers;
+				cpu.registers.pc = operand_pc;
+				cpu.clear_operand();
+				if (execute) execute(cpu);
+			}
+			auto end = std::chrono::steady_clock::now();
+			double ns = std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+			if (ns < best) best = ns;
+		}
+		return best;
+	}
+
+	std::map<std::string, double> load_baseline(const char* path){
+		std::map<std::string, double> baseline;
+		FILE* file = fopen(path, "r");
+		if (file == nullptr){
+			fprintf(stderr, "No baseline found at %s\n", path);
+			return baseline;
+		}
+		char name[32];
+		double ns;
+		while (fscanf(file, "%31s %lf", name, &ns) == 2){
+			baseline[name] = ns;
+		}
+		fclose(file);
+		return baseline;
+	}
+
+	void save_baseline(const char* path, const std::vector<Result>& results){
+		FILE* file = fopen(path, "w");
+		if (file == nullptr){
+			fprintf(stderr, "Couldn't write baseline to %s\n", path);
+			return;
+		}
+		for (const auto& result : results){
+			fprintf(file, "%s %.3f\n", result.name.c_str(), result.ns_per_instruction);
+		}
+		fclose(file);
+		fprintf(stdout, "Saved baseline to %s\n", path);
+	}
+}
+
+int main(int argc, char* argv[]){
+	const char* baseline_path = nullptr;
+	const char* save_path = nullptr;
+	double threshold_percent = 10.0;
+	for (int i = 1; i < argc; i++){
+		if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc){
+			baseline_path = argv[++i];
+		}else if (strcmp(argv[i], "--save-baseline") == 0 && i + 1 < argc){
+			save_path = argv[++i];
+		}else if (strcmp(argv[i], "--threshold") == 0 && i + 1 < argc){
+			threshold_percent = atof(argv[++i]);
+		}else{
+			fprintf(stderr, "Usage: %s [--baseline <file>] [--save-baseline <file>] [--threshold <percent>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	GB::CPU::limit_fps = false;
+	std::array<uint8_t, GB::MMU::BIOS_SIZE> bios = {{ 0 }};
+	GB::CPU cpu(bios, make_rom(), on_vblank);
+	cpu.reset();
+	cpu.exit_bios();
+
+	using GB::Instructions::Instruction;
+	using GB::Instructions::InstructionSet;
+
+	// Time the register restore on its own, so it can be taken off every result
+	const double overhead = time_handler(cpu, nullptr, CODE_START + 1);
+
+	std::vector<Result> results;
+	auto run = [&](const Instruction& instruction, const char* prefix, int opcode, uint16_t operand_pc){
+		if (strncmp(instruction.disassembly, "UNK", 3) == 0) return;
+
+		char name[16];
+		snprintf(name, sizeof(name), "%s%02x", prefix, opcode);
+		double ns = time_handler(cpu, instruction.execute, operand_pc) - overhead;
+		results.push_back({name, instruction.disassembly, ns > 0 ? ns : 0});
+	};
+	for (int opcode = 0; opcode <= 0xFF; opcode++){
+		run(InstructionSet::instructions[opcode], "", opcode, CODE_START + 1);
+	}
+	for (int opcode = 0; opcode <= 0xFF; opcode++){
+		run(InstructionSet::cb_instructions[opcode], "cb", opcode, CODE_START + 2);
+	}
+
+	std::map<std::string, double> baseline;
+	if (baseline_path != nullptr){
+		baseline = load_baseline(baseline_path);
+	}
+
+	int regressions = 0;
+	fprintf(stdout, "Loop overhead: %.2fns\n", overhead);
+	fprintf(stdout, "Opcode  Disassembly              ns/instr  Baseline   Change\n");
+	for (const auto& result : results){
+		fprintf(stdout, "%-6s  %-22s  %8.2f", result.name.c_str(), result.disassembly.c_str(), result.ns_per_instruction);
+
+		auto baseline_result = baseline.find(result.name);
+		if (baseline_result != baseline.end() && baseline_result->second > 0){
+			double change = (result.ns_per_instruction - baseline_result->second) * 100.0 / baseline_result->second;
+			bool regressed = change > threshold_percent && (result.ns_per_instruction - baseline_result->second) > MIN_REGRESSION_NS;
+			if (regressed) regressions++;
+			fprintf(stdout, "  %8.2f  %+6.1f%%%s", baseline_result->second, change, regressed ? "  REGRESSED" : "");
+		}
+		fprintf(stdout, "\n");
+	}
+
+	if (!baseline.empty()){
+		fprintf(stdout, "%d/%zu handlers regressed by more than %.1f%%\n", regressions, results.size(), threshold_percent);
+	}
+	if (save_path != nullptr){
+		save_baseline(save_path, results);
+	}
+
+	return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+#include "gb/audio_sink.h"
+#include "gb/band_limited_buffer.h"
+
+namespace GB{
+	class CPU;
+	class SaveState;
+
+	// The four sound channels, mapped to 0xFF10 to 0xFF3F.
+	// The APU doesn't do anything per step except count cycles. The channels are only run when a batch fills up,
+	// or just before a register is written so the write lands at the right time. Each channel only does work
+	// when its output changes, and those changes go through a BandLimitedBuffer instead of being sampled.
+	class APU{
+	public:
+		constexpr static uint32_t CLOCK_RATE = 4194304;
+		constexpr static uint32_t SAMPLE_RATE = 48000;
+		constexpr static uint32_t BATCH_CYCLES = 70224; // One frame
+		constexpr static uint32_t FRAME_SEQUENCER_CYCLES = CLOCK_RATE / 512;
+
+		constexpr static uint16_t REGISTERS_START = 0xFF10;
+		constexpr static uint16_t REGISTERS_END = 0xFF3F;
+
+		APU(CPU& cpu);
+
+		// Takes the cycles directly, rather than reading them from the CPU like the other components, so it can be inlined
+		inline void step(uint32_t cycles){
+			pending_cycles += cycles;
+			if (batch_cycles + pending_cycles >= BATCH_CYCLES) end_batch();
+		}
+		void reset();
+		void serialize(SaveState& state);
+
+		// sink must outlive the APU, or be replaced first
+		inline void set_sink(AudioSink& new_sink){
+			sink = &new_sink;
+		}
+
+		uint8_t read_register(uint16_t address);
+		void write_register(uint16_t address, uint8_t value);
+
+	protected:
+		enum ChannelIndex{
+			Square1 = 0,
+			Square2 = 1,
+			Wave = 2,
+			Noise = 3,
+			ChannelCount = 4
+		};
+		// Offsets from REGISTERS_START. Each channel has five registers, NRx0 to NRx4.
+		constexpr static int NR10 = 0x00;
+		constexpr static int NR30 = 0x0A;
+		constexpr static int NR50 = 0x14;
+		constexpr static int NR51 = 0x15;
+		constexpr static int NR52 = 0x16;
+		constexpr static int WAVE_RAM = 0x20;
+		constexpr static int channel_register(int channel, int x){
+			return channel * 5 + x;
+		}
+
+		struct Channel{
+			bool enabled;
+			int length_counter;
+			// Cycles until the waveform moves on
+			uint32_t timer;
+			int volume;
+			int envelope_timer;
+
+			int duty_position; // Square
+			int wave_position; // Wave
+			uint16_t lfsr; // Noise
+
+			// Only used by Square1
+			int sweep_timer;
+			bool sweep_enabled;
+			uint16_t sweep_shadow;
+
+			// What this channel is currently contributing to each side, so only the changes are added
+			int left_amplitude;
+			int right_amplitude;
+		};
+
+		void end_batch();
+		// Runs everything up to the current cycle
+		void catch_up();
+		void run_channel(int index, uint32_t from, uint32_t to);
+		void clock_frame_sequencer();
+		void update_output(int index, uint32_t time);
+
+		void trigger(int index);
+		uint16_t frequency(int index);
+		uint32_t period(int index);
+		int current_sample(int index);
+		bool dac_enabled(int index);
+		uint16_t calculate_sweep();
+
+		inline uint8_t& reg(int offset){
+			return registers[offset];
+		}
+
+		CPU& cpu;
+		AudioSink* sink;
+
+		// MMU::reset() writes to these before reset() is called, so they need sensible values from the start
+		std::array<uint8_t, REGISTERS_END - REGISTERS_START + 1> registers = {};
+		std::array<Channel, ChannelCount> channels = {};
+		bool powered = false;
+		int frame_sequencer_step = 0;
+
+		// Cycles since the start of this batch that have been run
+		uint32_t batch_cycles = 0;
+		// Cycles the CPU has run that the channels haven't caught up on yet
+		uint32_t pending_cycles = 0;
+		// When the frame sequencer next ticks, relative to the start of this batch
+		uint32_t next_frame_sequencer = FRAME_SEQUENCER_CYCLES;
+
+		BandLimitedBuffer left;
+		BandLimitedBuffer right;
+		std::vector<AudioFrame> frames;
+	};
+}
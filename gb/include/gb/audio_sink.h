@@ -0,0 +1,45 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+#include "gb/ring_buffer.h"
+
+namespace GB{
+	struct AudioFrame{
+		int16_t left;
+		int16_t right;
+	};
+
+	// Where the APU sends its samples, once per batch. Called on the emulation thread, so it must never block.
+	class AudioSink{
+	public:
+		virtual ~AudioSink() = default;
+		virtual void write_frames(const AudioFrame* frames, size_t count) = 0;
+	};
+
+	// Throws everything away, for headless runs
+	class NullAudioSink : public AudioSink{
+	public:
+		void write_frames(const AudioFrame* frames, size_t count) override {}
+	};
+
+	// Hands the samples to an audio thread. If the audio thread falls behind, new samples are dropped.
+	class RingBufferAudioSink : public AudioSink{
+	public:
+		constexpr static size_t CAPACITY = 8192; // About 170ms at 48kHz
+
+		void write_frames(const AudioFrame* frames, size_t count) override{
+			buffer.push(frames, count);
+		}
+		// Called from the audio thread. Returns how many frames were read.
+		inline size_t read_frames(AudioFrame* frames, size_t count){
+			return buffer.pop(frames, count);
+		}
+
+	protected:
+		SPSCRingBuffer<AudioFrame, CAPACITY> buffer;
+	};
+}
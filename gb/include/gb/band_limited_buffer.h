@@ -0,0 +1,55 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <vector>
+
+namespace GB{
+	// Turns amplitude changes at exact clock times into band-limited samples at the output rate.
+	// Each change adds a short windowed-sinc impulse to a delta buffer, which is summed when the samples are read.
+	// This means the cost scales with the number of changes, not the number of clock cycles.
+	class BandLimitedBuffer{
+	public:
+		constexpr static int PHASE_BITS = 5;
+		constexpr static int PHASE_COUNT = 1 << PHASE_BITS;
+		constexpr static int KERNEL_WIDTH = 16;
+
+		BandLimitedBuffer(uint32_t clock_rate, uint32_t sample_rate, size_t max_samples);
+
+		// clock_time is relative to the start of the current frame
+		inline void add_delta(uint32_t clock_time, float delta){
+			const uint64_t position = offset + clock_time * factor;
+			const size_t index = position >> FRACTION_BITS;
+			const int phase = (position >> (FRACTION_BITS - PHASE_BITS)) & (PHASE_COUNT - 1);
+			float* out = buffer.data() + index;
+			const std::array<float, KERNEL_WIDTH>& kernel = kernels[phase];
+			for (int i = 0; i < KERNEL_WIDTH; i++){
+				out[i] += delta * kernel[i];
+			}
+		}
+		// Ends the current frame, and makes all of its samples available
+		void end_frame(uint32_t clock_duration);
+
+		inline size_t samples_available(){
+			return offset >> FRACTION_BITS;
+		}
+		// Writes up to count samples to out, stride apart. Returns how many were written.
+		size_t read_samples(int16_t* out, size_t count, size_t stride, float gain);
+		void clear();
+
+	protected:
+		constexpr static int FRACTION_BITS = 32;
+
+		// Output samples per clock, as a 32.32 fixed point number
+		uint64_t factor;
+		// The position of the start of the current frame in buffer, also 32.32
+		uint64_t offset = 0;
+		std::vector<float> buffer;
+		float integrator = 0;
+
+		std::array<std::array<float, KERNEL_WIDTH>, PHASE_COUNT> kernels;
+	};
+}
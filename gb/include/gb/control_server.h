@@ -0,0 +1,65 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace GB{
+	class CPU;
+
+	// Lets another process drive a CPU over a Unix domain socket, with nothing shown on screen.
+	// The protocol is text, one command per line, and every command gets exactly one line back in the same order,
+	// starting with "ok" or "error". All of the commands that arrive together are run before any of the replies are sent,
+	// so a client can send a whole batch (press A, run 4 frames, read some RAM) and get all of the replies in one round trip.
+	// Numbers are in hex, except for frame counts and snapshot slots.
+	//   run <frames>              Runs until that many more frames have been drawn. Replies with the total frame count.
+	//   input <mask>              Sets the pressed buttons, in the bits used by Input::set_pressed()
+	//   read <address> <length>   Replies with the bytes as hex
+	//   write <address> <bytes>   bytes is a hex string, e.g. "write C000 0102FF"
+	//                             RAM is read and written directly. Anything else (ROM, cartridge RAM, IO) goes through the MMU,
+	//                             so it's refused while an OAM DMA is running rather than stopping the CPU with a bus conflict.
+	//   snapshot <slot>           Saves the whole machine into one of SNAPSHOT_SLOTS slots in memory
+	//   restore <slot>
+	//   hash                      Replies with a 64-bit FNV-1a hash of the framebuffer (one shade byte per pixel)
+	//   quit                      Stops the emulator
+	class ControlServer{
+	public:
+		constexpr static int SNAPSHOT_SLOTS = 16;
+		// How long the GPU takes to draw a frame, so "run" can't wait forever for a VBlank that isn't coming.
+		// The GPU counts 153 lines of VBlank after the 144 it draws (rather than 10), so this is 297 lines of 456 cycles, not 154.
+		constexpr static uint32_t FRAME_CYCLES = 297 * 456;
+
+		// Returns nullptr if the socket can't be created. Any old socket file at path is replaced.
+		static std::unique_ptr<ControlServer> create(const char* path);
+		~ControlServer();
+
+		ControlServer(const ControlServer&) = delete;
+		ControlServer& operator=(const ControlServer&) = delete;
+
+		// Serves clients one after another, until one of them sends "quit" or the CPU stops
+		void run(CPU& cpu);
+		// Must be called from the CPU's on_vblank
+		inline void on_frame(){
+			frame_count++;
+		}
+
+	protected:
+		ControlServer() = default;
+
+		// Returns false when the emulator should stop
+		bool serve_client(CPU& cpu, int client);
+		// Appends the reply to replies. Returns false when the emulator should stop.
+		bool execute(CPU& cpu, const std::string& line, std::string& replies);
+
+		bool run_frames(CPU& cpu, uint64_t frames);
+
+		std::string path;
+		int listen_socket = -1;
+		uint64_t frame_count = 0;
+		std::array<std::vector<uint8_t>, SNAPSHOT_SLOTS> snapshots;
+	};
+}
@@ -6,6 +6,8 @@
 #include <array>
 #include <vector>
 #include <map>
+#include <memory>
+#include <cstdio>
 
 #include "gb/cartridge.h"
 #include "gb/mmu.h"
@@ -14,7 +16,14 @@
 #include "gb/interrupts.h"
 #include "gb/rom_data.h"
 #include "gb/instructions/instruction_set.h"
+#include "gb/instructions/fused_instructions.h"
 #include "gb/timer.h"
+#include "gb/serial.h"
+#include "gb/apu.h"
+#include "gb/profiler.h"
+#include "gb/instrumentation.h"
+#include "gb/recompiled.h"
+#include "gb/save_state.h"
 
 namespace GB{
 	enum class CPUFlag{
@@ -27,12 +36,26 @@ namespace GB{
 	class CPU{
 	public:
 		friend class GPU;
+
+		// Policies for step(). Release contains no debugging logic at all,
+		// Debug keeps the loop detection, manual stepping and RST 0x38 probe.
+		// Profiled wraps either one and feeds the profiler.
+		struct ReleaseStepPolicy;
+		struct DebugStepPolicy;
+		template<typename BaseStepPolicy>
+		struct ProfiledStepPolicy;
 		
-		CPU(std::array<uint8_t, MMU::BIOS_SIZE> bios, std::vector<uint8_t> rom, void (*on_vblank)(CPU&));
+		CPU(std::array<uint8_t, MMU::BIOS_SIZE> bios, std::vector<uint8_t> rom, void (*on_vblank)(CPU&), bool debug_step = false, bool profile = false);
 		void reset();
-		void step();
+		inline void step(){
+			(this->*step_function)();
+		}
 		template<typename T>
 		T load_operand();
+		// Forget the operand loaded by the current instruction, so the next load_operand() reads from PC again
+		inline void clear_operand(){
+			current_operand_size = 0;
+		}
 
 		bool is_flag_set(CPUFlag flag);
 		void set_flag(CPUFlag flag, bool new_value);
@@ -45,6 +68,41 @@ namespace GB{
 		void exit_bios();
 
 		void check_instructions();
+
+		// Runs blocks from a plugin made by tools/recompiler.cpp wherever they exist, and the interpreter everywhere else.
+		// Only works with the release step policy, because the blocks skip the per-instruction hooks.
+		bool load_recompiled(const char* path);
+		// True with --debug or --profile, which need every instruction to go through step() for their hooks
+		bool steps_every_instruction();
+		// Used by recompiled blocks in place of the fetch and decode in step()
+		inline void preload_operand(uint16_t operand, size_t size){
+			current_operand = operand;
+			current_operand_size = size;
+		}
+		// True when the next instruction can be run without going through step(): no interrupt is due,
+		// and the CPU isn't halted, stopped, running the BIOS or in an OAM DMA
+		inline bool can_run_outside_step(){
+			return !stopped && !halted && !within_bios && mmu.dma_timer < 0 && interrupts.next_interrupt() == nullptr;
+		}
+		// Everything step() does after an instruction, for recompiled blocks and Lockstep.
+		// Returns false when the block has to give control back to step(),
+		// because an interrupt is due, the CPU has halted or stopped, or an OAM DMA is running.
+		inline bool finish_recompiled_instruction(uint8_t cycles){
+			clock_cycles_this_step = cycles;
+			step_components();
+			clear_operand();
+			return can_run_outside_step();
+		}
+
+		// A snapshot of the whole machine. Loading fails (and leaves the CPU alone) if the state came from a different ROM or version.
+		constexpr static uint32_t SAVE_STATE_VERSION = 2;
+		std::vector<uint8_t> save_state();
+		bool load_state(const std::vector<uint8_t>& data);
+
+		inline bool is_profiling(){
+			return profiler != nullptr;
+		}
+		void print_profile(FILE* file);
 	
 		struct Registers{
 			union {
@@ -85,6 +143,8 @@ namespace GB{
 		Interrupts interrupts;
 		Cartridge cartridge;
 		Timer timer;
+		Serial serial;
+		APU apu;
 	
 		unsigned int clock_cycles = 0;
 		unsigned int clock_cycles_this_step = 0;
@@ -98,19 +158,54 @@ namespace GB{
 		static bool debug_data;
 		static bool extended_debug_data;
 		static bool limit_fps;
+		// Only created when asked for, and only does anything in a build with GB_INSTRUMENTATION (see instrumentation.h)
+		std::unique_ptr<Instrumentation> instrumentation;
+		// Used by FusedInstructionSet::find()
+		Instructions::FusedInstructionCache fused_cache;
 	protected:
-		static GB::Instructions::InstructionSet instruction_set;
-
 		uint16_t loop_check[3];
 	
 		void (*on_vblank)(CPU&); // TODO: This should take const GPU
+
+		// Picked once in the constructor, so the policy isn't checked every step
+		void (CPU::*step_function)();
+		template<typename StepPolicy>
+		void step_with_policy();
+		void step_recompiled();
+		// Keeps running a fused loop that has jumped back to its start, so a whole copy or poll only goes through step() once.
+		// Capped so a poll that never ends still returns to the main loop now and then.
+		constexpr static int MAX_FUSED_LOOP_ITERATIONS = 1024;
+		void repeat_fused_loop(const Instructions::FusedInstruction& fused, uint16_t loop_pc);
+		// Moves the rest of the system on by clock_cycles_this_step
+		inline void step_components(){
+			clock_cycles += clock_cycles_this_step;
+
+			registers.f = registers.f & 0xF0;
+
+			{
+				Instrumentation::Scope timing(instrumentation.get(), Instrumentation::Section::MMUStep);
+				mmu.step();
+			}
+			gpu.step();
+			{
+				Instrumentation::Scope timing(instrumentation.get(), Instrumentation::Section::TimerStep);
+				timer.step();
+			}
+			serial.step();
+			apu.step(clock_cycles_this_step);
+		}
 	
 		void load_rom(std::vector<uint8_t> rom);
+		void serialize(SaveState& state);
+		uint16_t rom_checksum();
 
 		size_t current_operand_size = 0;
 		uint16_t current_operand = 0;
 		uint16_t pending_cpu_increment = 0;
 
 		bool within_bios = true;
+
+		std::unique_ptr<Profiler> profiler;
+		std::unique_ptr<RecompiledBlocks> recompiled;
 	};
 }
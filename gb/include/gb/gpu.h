@@ -8,6 +8,7 @@
 
 namespace GB{
 	class CPU;
+	class SaveState;
 	
 	class GPU{
 	public:
@@ -95,6 +96,7 @@ namespace GB{
 	
 		void step();
 		void reset();
+		void serialize(SaveState& state);
 
 		void set_lcdc_status(uint8_t from_byte);
 		uint8_t get_lcdc_status(void);
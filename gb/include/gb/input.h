@@ -4,6 +4,7 @@
 
 namespace GB{
 	class CPU;
+	class SaveState;
 
 	union InputData{
 		struct {
@@ -53,8 +54,12 @@ namespace GB{
 		void on_direction_up(Direction);
 		void on_button_down(Button);
 		void on_button_up(Button);
+		// Bits 0-3 are the pressed Directions, bits 4-7 are the pressed Buttons.
+		// Only the bits that changed since the last call are applied.
+		void set_pressed(uint8_t mask);
 
 		void reset();
+		void serialize(SaveState& state);
 	protected:
 		CPU& cpu;
 	
@@ -63,5 +68,6 @@ namespace GB{
 		bool buttons[4];
 	
 		InputData current_value;
+		uint8_t pressed_mask = 0;
 	};
 }
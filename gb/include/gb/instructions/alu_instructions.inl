@@ -5,50 +5,157 @@
 #include "instruction_sources.h"
 
 namespace GB::Instructions::ALU{
+	// The 8-bit ops on plain values. The instructions below run them on their sources, and GB::Lockstep runs them on
+	// many CPUs' registers at once, so what each op does to the flags is only written down here.
+	// apply() returns the result and puts the flags the op sets in flags. The rest of F is left as it was (kept_flags),
+	// including the unused low nibble, which POP AF can load.
+	// They're written without branches so a loop over them can be vectorised.
+	namespace Operations{
+		constexpr uint8_t ZERO = static_cast<uint8_t>(CPUFlag::Zero);
+		constexpr uint8_t NEGATIVE = static_cast<uint8_t>(CPUFlag::Negative);
+		constexpr uint8_t HALF_CARRY = static_cast<uint8_t>(CPUFlag::HalfCarry);
+		constexpr uint8_t CARRY = static_cast<uint8_t>(CPUFlag::Carry);
+		constexpr uint8_t UNUSED_FLAGS = 0x0F;
+
+		inline uint8_t flag_if(bool condition, uint8_t flag){
+			return condition ? flag : 0;
+		}
+		inline uint8_t apply_flags(uint8_t f, uint8_t kept_flags, uint8_t flags){
+			return (f & kept_flags) | flags;
+		}
+
+		template<bool WithCarry>
+		struct Add{
+			constexpr static bool stores_result = true;
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS;
+			static inline uint8_t apply(uint8_t a, uint8_t b, uint8_t f, uint8_t& flags){
+				const int carry = (WithCarry && (f & CARRY)) ? 1 : 0;
+				const int result = a + b + carry;
+				// The "& 0xf" zeroes out the top 4 bits.
+				// A Half Carry occurs if the result of the bottom 4 bits added together has the 5th bit set.
+				flags = flag_if((result & 0xff) == 0, ZERO) | flag_if((result >> 8) & 1, CARRY)
+					| flag_if((((a & 0xf) + (b & 0xf) + carry) >> 4) & 1, HALF_CARRY);
+				return result;
+			}
+		};
+		template<bool WithCarry>
+		struct Sub{
+			constexpr static bool stores_result = true;
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS;
+			static inline uint8_t apply(uint8_t a, uint8_t b, uint8_t f, uint8_t& flags){
+				const int carry = (WithCarry && (f & CARRY)) ? 1 : 0;
+				const int result = a - b - carry;
+				// A Half Carry occurs if the result of the bottom 4 bits subtracted is < 0,
+				// i.e. if the bottom 4 bits of b (and the carry) > the bottom 4 bits of a
+				flags = flag_if((result & 0xff) == 0, ZERO) | NEGATIVE | flag_if(result < 0, CARRY)
+					| flag_if(((b & 0xf) + carry) > (a & 0xf), HALF_CARRY);
+				return result;
+			}
+		};
+		struct And{
+			constexpr static bool stores_result = true;
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS;
+			static inline uint8_t apply(uint8_t a, uint8_t b, uint8_t, uint8_t& flags){
+				const uint8_t result = a & b;
+				flags = flag_if(result == 0, ZERO) | HALF_CARRY;
+				return result;
+			}
+		};
+		struct Or{
+			constexpr static bool stores_result = true;
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS;
+			static inline uint8_t apply(uint8_t a, uint8_t b, uint8_t, uint8_t& flags){
+				const uint8_t result = a | b;
+				flags = flag_if(result == 0, ZERO);
+				return result;
+			}
+		};
+		struct Xor{
+			constexpr static bool stores_result = true;
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS;
+			static inline uint8_t apply(uint8_t a, uint8_t b, uint8_t, uint8_t& flags){
+				const uint8_t result = a ^ b;
+				flags = flag_if(result == 0, ZERO);
+				return result;
+			}
+		};
+		struct Compare{
+			constexpr static bool stores_result = false;
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS;
+			static inline uint8_t apply(uint8_t a, uint8_t b, uint8_t, uint8_t& flags){
+				flags = flag_if(a == b, ZERO) | NEGATIVE | flag_if(b > a, CARRY) | flag_if((b & 0xf) > (a & 0xf), HALF_CARRY);
+				return a;
+			}
+		};
+
+		// The ops on a single value
+		struct Increment{
+			// Ignore Carry flag
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS | CARRY;
+			static inline uint8_t apply(uint8_t value, uint8_t& flags){
+				const uint8_t result = value + 1;
+				// If the last 4 bits are all set then the increment resulted in a half-carry
+				flags = flag_if(result == 0, ZERO) | flag_if((value & 0xf) == 0xf, HALF_CARRY);
+				return result;
+			}
+		};
+		struct Decrement{
+			// Ignore Carry flag
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS | CARRY;
+			static inline uint8_t apply(uint8_t value, uint8_t& flags){
+				const uint8_t result = value - 1;
+				// If the last 4 bits are all zero then the decrement resulted in a half-carry
+				flags = flag_if(result == 0, ZERO) | NEGATIVE | flag_if((value & 0xf) == 0x0, HALF_CARRY);
+				return result;
+			}
+		};
+		struct Not{
+			constexpr static uint8_t kept_flags = UNUSED_FLAGS | ZERO | CARRY;
+			static inline uint8_t apply(uint8_t value, uint8_t& flags){
+				flags = NEGATIVE | HALF_CARRY;
+				return ~value;
+			}
+		};
+	}
 
 	// Adds
 	template<typename T, typename AddToSource, typename AddFromSource, bool WithCarry>
 	class AddInstruction{};
 	template<typename AddToSource, typename AddValueSource, bool WithCarry>
-	class AddInstruction<uint8_t, AddToSource, AddValueSource, WithCarry> : public Instruction{
-		using Instruction::Instruction;
-
+	class AddInstruction<uint8_t, AddToSource, AddValueSource, WithCarry>{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(AddToSource, uint8_t, SourceUsage::ReadAndWrite);
 		//STATIC_ASSERT_IS_SOURCE_INTERFACE(AddValueSource, uint8_t, SourceUsage::ReadOnly);
 		static_assert(AddValueSource::load);
 		
 	public:
-		uint8_t execute(CPU& cpu) override{
-			bool should_carry = WithCarry && cpu.is_flag_set(CPUFlag::Carry);
+		constexpr static uint8_t length = 1 + AddToSource::operand_bytes + AddValueSource::operand_bytes;
+		constexpr static uint8_t cycles = 4 + AddValueSource::cycles + AddToSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
+			using Operation = Operations::Add<WithCarry>;
+			const uint8_t f = cpu.registers.f;
 			uint8_t add_from = AddValueSource::load(cpu);
 			uint8_t add_to = AddToSource::load(cpu);
-			int addition_result = add_from + add_to + (should_carry ? 1 : 0);
-			uint8_t wrapped_result = addition_result & 0xff;
+			uint8_t flags;
+			uint8_t wrapped_result = Operation::apply(add_to, add_from, f, flags);
 
-			cpu.set_flag(CPUFlag::Zero, wrapped_result == 0);
-			cpu.set_flag(CPUFlag::Negative, false);
-			cpu.set_flag(CPUFlag::Carry, (addition_result >> 8) & 1);
-			// The "& 0xf" zeroes out the top 4 bits.
-			// A Half Carry occurs if the result of the bottom 4 bits added together
-			// has the 5th bit set. "& 0x10" makes the number 0 if the 5th bit isn't set,
-			// or 0x10 if it is.
-			cpu.set_flag(CPUFlag::HalfCarry, (((add_from & 0xf) + (add_to & 0xf) + (should_carry ? 1 : 0)) >> 4) & 1);
-			
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operation::kept_flags, flags);
 			AddToSource::store(cpu, wrapped_result);
 
-			return 4 + AddValueSource::cycles + AddToSource::cycles;
+			return cycles;
 		}
 	};
 	template<typename AddToSource, typename AddValueSource>
-	class AddInstruction<uint16_t, AddToSource, AddValueSource, false> : public Instruction{
-		using Instruction::Instruction;
-
+	class AddInstruction<uint16_t, AddToSource, AddValueSource, false>{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(AddToSource, uint16_t, SourceUsage::ReadAndWrite);
 		//STATIC_ASSERT_IS_SOURCE_INTERFACE(AddValueSource, uint16_t, SourceUsage::ReadOnly);
 		static_assert(AddValueSource::load);
 		
 	public:
-		uint8_t execute(CPU& cpu) override{
+		constexpr static uint8_t length = 1 + AddToSource::operand_bytes + AddValueSource::operand_bytes;
+		constexpr static uint8_t cycles = 4 + AddValueSource::cycles + AddToSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
 			uint16_t add_from = AddValueSource::load(cpu);
 			uint16_t add_to = AddToSource::load(cpu);
 			int addition_result = add_from + add_to;
@@ -65,113 +172,115 @@ namespace GB::Instructions::ALU{
 
 			AddToSource::store(cpu, wrapped_result);
 
-			return 4 + AddValueSource::cycles + AddToSource::cycles;
+			return cycles;
 		}
 	};
 
     // Subtracts
 	template<typename SubFromSource, typename SubValueSource, bool WithCarry>
-	class SubInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class SubInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(SubFromSource, uint8_t, SourceUsage::ReadAndWrite);
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(SubValueSource, uint8_t, SourceUsage::ReadOnly);
 
-		uint8_t execute(CPU& cpu) override{
-			bool should_carry = WithCarry && cpu.is_flag_set(CPUFlag::Carry);
+	public:
+		constexpr static uint8_t length = 1 + SubFromSource::operand_bytes + SubValueSource::operand_bytes;
+		constexpr static uint8_t cycles = 4 + SubFromSource::cycles + SubValueSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
+			using Operation = Operations::Sub<WithCarry>;
+			const uint8_t f = cpu.registers.f;
 			uint8_t sub_from = SubFromSource::load(cpu);
 			uint8_t sub_value = SubValueSource::load(cpu);
-			int subtraction_result = sub_from - sub_value - (should_carry ? 1 : 0);
-			uint8_t wrapped_result = static_cast<uint8_t>(subtraction_result);
+			uint8_t flags;
+			uint8_t wrapped_result = Operation::apply(sub_from, sub_value, f, flags);
 
 			if (CPU::extended_debug_data){
-				fprintf(stdout, "sub_from = %d, sub_value = %d, result = %d (wrapped %d)\n", sub_from, sub_value, subtraction_result, wrapped_result);
+				fprintf(stdout, "sub_from = %d, sub_value = %d, result = %d (wrapped %d)\n", sub_from, sub_value,
+						sub_from - sub_value - ((WithCarry && (f & Operations::CARRY)) ? 1 : 0), wrapped_result);
 			}
 
-			cpu.set_flag(CPUFlag::Zero, wrapped_result == 0);
-			cpu.set_flag(CPUFlag::Negative, true);
-			cpu.set_flag(CPUFlag::Carry, subtraction_result < 0);
-			// The "& 0xf" zeroes out the top 4 bits.
-			// A Half Carry occurs if the result of the bottom 4 bits subtracted is < 0,
-			// i.e. if the bottom 4 bits of sub_value > the bottom 4 bits of sub_from
-			cpu.set_flag(CPUFlag::HalfCarry, ((sub_value & 0xf) + (should_carry ? 1 : 0)) > (sub_from & 0xf));
-			
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operation::kept_flags, flags);
 			SubFromSource::store(cpu, wrapped_result);
 		
-			return 4 + SubFromSource::cycles + SubValueSource::cycles;
+			return cycles;
 		}
 	};
 
 
     // Logical Ops
 	template<typename IntoSource, typename ValueSource>
-	class AndInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class AndInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(IntoSource, uint8_t, SourceUsage::ReadAndWrite);
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(ValueSource, uint8_t, SourceUsage::ReadOnly);
 		
-		uint8_t execute(CPU& cpu) override{
-			auto result = IntoSource::load(cpu) & ValueSource::load(cpu);
+	public:
+		constexpr static uint8_t length = 1 + IntoSource::operand_bytes + ValueSource::operand_bytes;
+		constexpr static uint8_t cycles = 4 + IntoSource::cycles + ValueSource::cycles;
 
-			cpu.set_flag(CPUFlag::Zero,      result == 0);
-			cpu.set_flag(CPUFlag::Negative,  false);
-			cpu.set_flag(CPUFlag::Carry,     false);
-			cpu.set_flag(CPUFlag::HalfCarry, true);
-		
+		static uint8_t execute(CPU& cpu){
+			uint8_t into = IntoSource::load(cpu);
+			uint8_t value = ValueSource::load(cpu);
+			uint8_t flags;
+			uint8_t result = Operations::And::apply(into, value, cpu.registers.f, flags);
+
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operations::And::kept_flags, flags);
 			IntoSource::store(cpu, result);
 		
-			return 4 + IntoSource::cycles + ValueSource::cycles;
+			return cycles;
 		}
 	};
 	template<typename IntoSource, typename ValueSource>
-	class OrInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class OrInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(IntoSource, uint8_t, SourceUsage::ReadAndWrite);
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(ValueSource, uint8_t, SourceUsage::ReadOnly);
 
-		uint8_t execute(CPU& cpu) override{
-			auto result = IntoSource::load(cpu) | ValueSource::load(cpu);
+	public:
+		constexpr static uint8_t length = 1 + IntoSource::operand_bytes + ValueSource::operand_bytes;
+		constexpr static uint8_t cycles = 4 + IntoSource::cycles + ValueSource::cycles;
 
-			cpu.set_flag(CPUFlag::Zero,      result == 0);
-			cpu.set_flag(CPUFlag::Negative,  false);
-			cpu.set_flag(CPUFlag::Carry,     false);
-			cpu.set_flag(CPUFlag::HalfCarry, false);
-		
+		static uint8_t execute(CPU& cpu){
+			uint8_t into = IntoSource::load(cpu);
+			uint8_t value = ValueSource::load(cpu);
+			uint8_t flags;
+			uint8_t result = Operations::Or::apply(into, value, cpu.registers.f, flags);
+
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operations::Or::kept_flags, flags);
 			IntoSource::store(cpu, result);
 		
-			return 4 + IntoSource::cycles + ValueSource::cycles;
+			return cycles;
 		}
 	};
 	template<typename IntoSource, typename ValueSource>
-	class XorInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class XorInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(IntoSource, uint8_t, SourceUsage::ReadAndWrite);
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(ValueSource, uint8_t, SourceUsage::ReadOnly);
 
-		uint8_t execute(CPU& cpu) override{
-			auto result = IntoSource::load(cpu) ^ ValueSource::load(cpu);
+	public:
+		constexpr static uint8_t length = 1 + IntoSource::operand_bytes + ValueSource::operand_bytes;
+		constexpr static uint8_t cycles = 4 + IntoSource::cycles + ValueSource::cycles;
 
-			cpu.set_flag(CPUFlag::Zero,      result == 0);
-			cpu.set_flag(CPUFlag::Negative,  false);
-			cpu.set_flag(CPUFlag::Carry,     false);
-			cpu.set_flag(CPUFlag::HalfCarry, false);
-		
+		static uint8_t execute(CPU& cpu){
+			uint8_t into = IntoSource::load(cpu);
+			uint8_t value = ValueSource::load(cpu);
+			uint8_t flags;
+			uint8_t result = Operations::Xor::apply(into, value, cpu.registers.f, flags);
+
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operations::Xor::kept_flags, flags);
 			IntoSource::store(cpu, result);
 		
-			return 4 + IntoSource::cycles + ValueSource::cycles;
+			return cycles;
 		}
 	};
 	template<typename ASource, typename BSource>
-	class CompareInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class CompareInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(ASource, uint8_t, SourceUsage::ReadAndWrite);
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(BSource, uint8_t, SourceUsage::ReadOnly);
 
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 1 + ASource::operand_bytes + BSource::operand_bytes;
+		constexpr static uint8_t cycles = 4 + ASource::cycles + BSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
 			uint8_t a = ASource::load(cpu);
 			uint8_t b = BSource::load(cpu);
 
@@ -179,123 +288,123 @@ namespace GB::Instructions::ALU{
 				fprintf(stdout, "Comparing 0x%02x (%d dec) to 0x%02x (%d dec)\n", a, a, b, b);
 			}
 
-			cpu.set_flag(CPUFlag::Zero,      a == b);
-			cpu.set_flag(CPUFlag::Negative,  true);
-			cpu.set_flag(CPUFlag::Carry,     b > a);
-			cpu.set_flag(CPUFlag::HalfCarry, (b & 0xf) > (a & 0xf));
+			uint8_t flags;
+			Operations::Compare::apply(a, b, cpu.registers.f, flags);
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operations::Compare::kept_flags, flags);
 		
-			return 4 + ASource::cycles + BSource::cycles;
+			return cycles;
 		}
 	};
 	template<typename FromSource, typename IntoSource>
-	class NotInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class NotInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(FromSource, uint8_t, SourceUsage::ReadAndWrite);
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(IntoSource, uint8_t, SourceUsage::ReadOnly);
 
-		uint8_t execute(CPU& cpu) override{
-			auto result = ~FromSource::load(cpu);
+	public:
+		constexpr static uint8_t length = 1 + FromSource::operand_bytes + IntoSource::operand_bytes;
+		constexpr static uint8_t cycles = IntoSource::cycles + FromSource::cycles;
 
-			cpu.set_flag(CPUFlag::Negative,  true);
-			cpu.set_flag(CPUFlag::HalfCarry, true);
-		
+		static uint8_t execute(CPU& cpu){
+			uint8_t flags;
+			uint8_t result = Operations::Not::apply(FromSource::load(cpu), flags);
+
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operations::Not::kept_flags, flags);
 			IntoSource::store(cpu, result);
 		
-			return IntoSource::cycles + FromSource::cycles;
+			return cycles;
 		}
 	};
 
 	template<typename ValueType, typename InSource>
 	class IncrementInstruction{};
 	template<typename InSource>
-	class IncrementInstruction<uint8_t, InSource> : public Instruction{
-		using Instruction::Instruction;
-
+	class IncrementInstruction<uint8_t, InSource>{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(InSource, uint8_t, SourceUsage::ReadAndWrite);
 
-		uint8_t execute(CPU& cpu) override{
-			uint8_t value = InSource::load(cpu);
-			uint8_t new_value = value + 1;
+	public:
+		constexpr static uint8_t length = 1 + InSource::operand_bytes;
+		constexpr static uint8_t cycles = InSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
+			uint8_t flags;
+			uint8_t new_value = Operations::Increment::apply(InSource::load(cpu), flags);
 			InSource::store(cpu, new_value);
 
-			cpu.set_flag(CPUFlag::Zero, new_value == 0);
-			cpu.set_flag(CPUFlag::Negative, false);
-			// Ignore Carry flag
-			// If the last 4 bits are all set then the increment resulted in a half-carry
-			cpu.set_flag(CPUFlag::HalfCarry, (value & 0xf) == 0xf);
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operations::Increment::kept_flags, flags);
 		
-			return InSource::cycles;
-		};
+			return cycles;
+		}
 	};
 	template<typename InSource>
-	class IncrementInstruction<uint16_t, InSource> : public Instruction{
-		using Instruction::Instruction;
-
+	class IncrementInstruction<uint16_t, InSource>{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(InSource, uint16_t, SourceUsage::ReadAndWrite);
 
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 1 + InSource::operand_bytes;
+		constexpr static uint8_t cycles = InSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
 			uint16_t value = InSource::load(cpu);
 			uint16_t new_value = value + 1;
 			InSource::store(cpu, new_value);
 		
-			return InSource::cycles;
-		};
+			return cycles;
+		}
 	};
 	template<typename ValueType, typename InSource>
 	class DecrementInstruction{};
 	template<typename InSource>
-	class DecrementInstruction<uint8_t, InSource> : public Instruction{
-		using Instruction::Instruction;
-
+	class DecrementInstruction<uint8_t, InSource>{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(InSource, uint8_t, SourceUsage::ReadAndWrite);
 
-		uint8_t execute(CPU& cpu) override{
-			uint8_t value = InSource::load(cpu);
-			uint8_t new_value = value - 1;
+	public:
+		constexpr static uint8_t length = 1 + InSource::operand_bytes;
+		constexpr static uint8_t cycles = InSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
+			uint8_t flags;
+			uint8_t new_value = Operations::Decrement::apply(InSource::load(cpu), flags);
 			InSource::store(cpu, new_value);
 
-			cpu.set_flag(CPUFlag::Zero, new_value == 0);
-			cpu.set_flag(CPUFlag::Negative, true);
-			// Ignore Carry flag
-			// If the last 4 bits are all zero then the decrement resulted in a half-carry?
-			cpu.set_flag(CPUFlag::HalfCarry, (value & 0xf) == 0x0);
+			cpu.registers.f = Operations::apply_flags(cpu.registers.f, Operations::Decrement::kept_flags, flags);
 		
-			return InSource::cycles;
-		};
+			return cycles;
+		}
 	};
 	template<typename InSource>
-	class DecrementInstruction<uint16_t, InSource> : public Instruction{
-		using Instruction::Instruction;
-
+	class DecrementInstruction<uint16_t, InSource>{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(InSource, uint16_t, SourceUsage::ReadAndWrite);
 
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 1 + InSource::operand_bytes;
+		constexpr static uint8_t cycles = InSource::cycles;
+
+		static uint8_t execute(CPU& cpu){
 			uint16_t value = InSource::load(cpu);
 			uint16_t new_value = value - 1;
 			InSource::store(cpu, new_value);
 		
-			return InSource::cycles;
-		};
+			return cycles;
+		}
 	};
 
 	template<typename InSource, bool RotateLeft, bool IncludeCarry, bool IsCB = false>
-	class RotateInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class RotateInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(InSource, uint8_t, SourceUsage::ReadAndWrite);
 
-		uint8_t execute(CPU& cpu) override{
+	public:
+		// CB instructions include the prefix byte
+		constexpr static uint8_t length = (IsCB ? 2 : 1) + InSource::operand_bytes;
+		// This is a special case, Rotates always take at least 4 cycles even though they only use one register
+		constexpr static uint8_t cycles = IsCB ? ((4 + InSource::cycles) * 2) : 4; // TODO: The CB cycles seem tenuous at best.
+
+		static uint8_t execute(CPU& cpu){
 			uint8_t value = InSource::load(cpu);
 			uint8_t rotated = rotate_value(cpu, value);
 			InSource::store(cpu, rotated);
 
-			// This is a special case, Rotates always take at least 4 cycles even though they only use one register
-			if (IsCB){
-				return (4 + InSource::cycles) * 2; // TODO: This seems tenuous at best.
-			}
-			return 4;
-		};
+			return cycles;
+		}
 
 		static inline uint8_t rotate_value(CPU& cpu, uint8_t value){
 			uint8_t result;
@@ -3,14 +3,17 @@
 #pragma once
 
 #include "alu_instructions.inl"
+#include "misc_instructions.inl"
 
 namespace GB::Instructions::CB{
-	class UnknownInstruction : public Instruction{
-		using Instruction::Instruction;
+	class UnknownInstruction{
+	public:
+		constexpr static uint8_t length = 2;
+		constexpr static uint8_t cycles = 0;
 
-		uint8_t execute(CPU& cpu) override{
+		static uint8_t execute(CPU& cpu){
 			fprintf(stderr, "--- NOTE ---\nCB instruction opcode was 0x%02x\n", cpu.load_operand<uint8_t>());
-			return Instruction::execute(cpu);
+			return Instructions::UnknownInstruction::execute(cpu);
 		}
 	};
 	
@@ -24,12 +27,14 @@ namespace GB::Instructions::CB{
 	using RRC = ALU::RotateInstruction<IntoSource, false, false, true>;
 	
 	template<typename Source, int Bit>
-	class TestBitInstruction : public Instruction{
-		using Instruction::Instruction;
-		
+	class TestBitInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(Source, uint8_t, SourceUsage::ReadOnly);
 	
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 2 + Source::operand_bytes;
+		constexpr static uint8_t cycles = 8 + Source::cycles*2;
+
+		static uint8_t execute(CPU& cpu){
 			uint8_t value = Source::load(cpu);
 			if (CPU::extended_debug_data){
 				fprintf(stdout, "Testing bit %d of value %02x (%d dec)\n", Bit, value, value);
@@ -38,51 +43,57 @@ namespace GB::Instructions::CB{
 			cpu.set_flag(CPUFlag::Negative, false);
 			cpu.set_flag(CPUFlag::HalfCarry, true);
 
-			return 8 + Source::cycles*2;
+			return cycles;
 		}
 	};
 	template<typename Source, int Bit>
 	using BIT = TestBitInstruction<Source, Bit>;
 	
 	template<typename Source, int Bit>
-	class SetBitInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class SetBitInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(Source, uint8_t, SourceUsage::ReadAndWrite);
 	
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 2 + Source::operand_bytes;
+		constexpr static uint8_t cycles = 8 + Source::cycles*2;
+
+		static uint8_t execute(CPU& cpu){
 			uint8_t value = Source::load(cpu);
 			value = value | (1 << Bit);
 			Source::store(cpu, value);
-			return 8 + Source::cycles*2;
+			return cycles;
 		}
 	};
 	template<typename Source, int Bit>
 	using SET = SetBitInstruction<Source, Bit>;
 
 	template<typename Source, int Bit>
-	class ResetBitInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class ResetBitInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(Source, uint8_t, SourceUsage::ReadAndWrite);
 	
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 2 + Source::operand_bytes;
+		constexpr static uint8_t cycles = 8 + Source::cycles*2;
+
+		static uint8_t execute(CPU& cpu){
 			uint8_t value = Source::load(cpu);
 			value = value & ~(1 << Bit);
 			Source::store(cpu, value);
-			return 8 + Source::cycles*2;
+			return cycles;
 		}
 	};
 	template<typename Source, int Bit>
 	using RES = ResetBitInstruction<Source, Bit>;
 
 	template<typename Source>
-	class SwapNybblesInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class SwapNybblesInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(Source, uint8_t, SourceUsage::ReadAndWrite);
 
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 2 + Source::operand_bytes;
+		constexpr static uint8_t cycles = 8 + Source::cycles*2;
+
+		static uint8_t execute(CPU& cpu){
 			uint8_t value = Source::load(cpu);
 			uint8_t result = ((value & 0b00001111) << 4) | ((value & 0b11110000) >> 4);
 			Source::store(cpu, result);
@@ -92,19 +103,21 @@ namespace GB::Instructions::CB{
 			cpu.set_flag(CPUFlag::HalfCarry, false);//value & 0x01);
 			cpu.set_flag(CPUFlag::Negative, false);//value & 0x01);
 			
-			return 8 + Source::cycles*2;
+			return cycles;
 		}
 	};
 	template<typename Source>
 	using SWAP = SwapNybblesInstruction<Source>;
 
 	template<typename Source, bool ShiftLeft, bool ConserveSign>
-	class ShiftInstruction : public Instruction{
-		using Instruction::Instruction;
-
+	class ShiftInstruction{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(Source, uint8_t, SourceUsage::ReadAndWrite);
 		
-		uint8_t execute(CPU& cpu) override{
+	public:
+		constexpr static uint8_t length = 2 + Source::operand_bytes;
+		constexpr static uint8_t cycles = 8 + Source::cycles*2;
+
+		static uint8_t execute(CPU& cpu){
 			uint8_t value = Source::load(cpu);
 			uint8_t result;
 			if (ShiftLeft){
@@ -123,7 +136,7 @@ namespace GB::Instructions::CB{
 			cpu.set_flag(CPUFlag::Negative, false);
 
 			Source::store(cpu, result);
-			return 8 + Source::cycles*2;
+			return cycles;
 		}
 	};
 	template<typename Source>
@@ -0,0 +1,69 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include "instruction.h"
+
+#include <array>
+#include <vector>
+
+namespace GB{
+	class CPU;
+
+	namespace Instructions{
+		// A common sequence of instructions (a copy loop, a register poll) that CPU::step() runs with one dispatch.
+		// The handler runs each instruction in the sequence through its normal opcode handler, so flags, registers and cycles
+		// come out exactly as if they had been stepped one at a time. Only the rest of the system sees a difference,
+		// it's moved on once for the whole sequence instead of after every instruction.
+		// A loop still runs (and moves the rest of the system on) once per iteration rather than as one bulk copy or fill,
+		// because the timers, GPU and interrupts have to see each iteration's cycles, and a copy can read or write IO registers.
+		struct FusedInstruction{
+			constexpr static int MAX_LENGTH = 8;
+			// A byte in the pattern that can be anything, such as the port in LDH A,(n)
+			constexpr static int16_t ANY_BYTE = -1;
+
+			const char* disassembly;
+			// Returns cycles taken by the whole sequence
+			uint8_t (*execute)(CPU& cpu);
+			// The bytes of the sequence, including operands
+			std::array<int16_t, MAX_LENGTH> pattern;
+			uint8_t length;
+			// The sequence ends by jumping back to its own start while a counter or polled value says to,
+			// so step() can keep running it without decoding it again
+			bool loops;
+		};
+
+		// What FusedInstructionSet::match() found at each ROM bank:PC, filled in as the CPU gets to them.
+		// The ROM can't change, so each address is only matched once, and an opcode that can start a sequence but usually doesn't
+		// (XOR A, LDH A,(n)) costs a lookup rather than a check of every sequence it could start.
+		class FusedInstructionCache{
+		public:
+			const FusedInstruction* find(CPU& cpu, uint16_t pc, uint8_t opcode);
+		protected:
+			constexpr static uint8_t NOT_MATCHED = 0;
+			constexpr static uint8_t NO_SEQUENCE = 1;
+			// The rest are the index of the sequence, plus this
+			constexpr static uint8_t FIRST_SEQUENCE = 2;
+			// One per byte of the ROM, allocated on the first lookup
+			std::vector<uint8_t> entries;
+		};
+
+		class FusedInstructionSet{
+		public:
+			// Returns the sequence starting at pc, or nullptr if there isn't one. opcode is the byte at pc, which step() has already read.
+			// Sequences are only looked for in ROM, so they can't be changed by the writes they make.
+			static inline const FusedInstruction* find(CPU& cpu, uint16_t pc, uint8_t opcode){
+				if (!starts_sequence[opcode]) return nullptr;
+				return find_cached(cpu, pc, opcode);
+			}
+			// Checks the bytes at pc against every sequence opcode can start, without the cache
+			static const FusedInstruction* match(CPU& cpu, uint16_t pc, uint8_t opcode);
+
+			static void print_all();
+
+			static const std::array<bool, 256> starts_sequence;
+		protected:
+			static const FusedInstruction* find_cached(CPU& cpu, uint16_t pc, uint8_t opcode);
+		};
+	}
+}
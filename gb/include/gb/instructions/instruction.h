@@ -10,15 +10,23 @@ namespace GB{
 	class CPU;
 
 	namespace Instructions{
-		class Instruction{
-		public:	
-			const char* const disassembly;
+		// An entry in the opcode tables. These are all built at compile time (see instruction_set.cpp),
+		// so there's no per-instruction object and no virtual call to dispatch.
+		struct Instruction{
+			const char* disassembly;
 			// Returns cycles taken
-			virtual uint8_t execute(CPU& cpu);
-
-			virtual ~Instruction(){}
-			Instruction(const char* const disassembly) : disassembly(disassembly){}
+			uint8_t (*execute)(CPU& cpu);
+			// Bytes taken up by the instruction, including the opcode and CB prefix
+			uint8_t length;
+			// Cycles taken. For conditional jumps/calls/returns this is when the condition isn't met.
+			uint8_t cycles;
 		};
+
+		// InstructionType must have a static execute(), and constexpr static length and cycles
+		template<typename InstructionType>
+		constexpr Instruction make_instruction(const char* const disassembly){
+			return Instruction{disassembly, &InstructionType::execute, InstructionType::length, InstructionType::cycles};
+		}
 	}
 
 }
@@ -4,28 +4,26 @@
 
 #include "instruction.h"
 
+#include <array>
+
 namespace GB{
 	class CPU;
 
 	namespace Instructions{
+		// The opcode tables are constant and built at compile time, so there's only ever one of them.
 		class InstructionSet{
 		public:
-			InstructionSet();
-			~InstructionSet();
-	
-			Instruction* get_instruction(CPU& cpu, uint8_t index);
-
-			void print_all();
-		protected:
-			Instruction* unknown_instruction;
-			Instruction* instructions[256] = { nullptr };
-			Instruction* unknown_cb_instruction;
-			Instruction* cb_instructions[256] = { nullptr };
-
-			template<template <typename InType> typename InstructionType, int Index>
-			void populate_cb_instruction_block(const char* const name);
-			template<template <typename InType, int Bit> typename InstructionType, int Bit, int Index>
-			void populate_cb_instruction_block(const char* const name);
+			using Table = std::array<Instruction, 256>;
+
+			static const Instruction* get_instruction(CPU& cpu, uint8_t index);
+			// Doesn't load the CB operand from the CPU, used for profiling/disassembly
+			static const Instruction* find_instruction(uint8_t index, uint8_t cb_index);
+
+			static void print_all();
+
+			// Undefined opcodes (and 0xCB itself) map to UnknownInstruction
+			static const Table instructions;
+			static const Table cb_instructions;
 		};
 	}
 }
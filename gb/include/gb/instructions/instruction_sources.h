@@ -20,6 +20,7 @@ namespace GB::Instructions::Sources{
 		
 		static_assert(std::is_same<ReturnType, uint8_t>::value || std::is_same<ReturnType, uint16_t>::value, "Source return type must be uint8/uint16");
 		static_assert(std::is_same<decltype(SourceToTest::cycles), const uint8_t>::value, "Source must contain a const static uint8 declaring how many cycles it takes to use");
+		static_assert(std::is_same<decltype(SourceToTest::operand_bytes), const uint8_t>::value, "Source must contain a const static uint8 declaring how many operand bytes it reads after the opcode");
 		static_assert((Usage == SourceUsage::WriteOnly) || std::is_same<decltype(SourceToTest::load), decltype(load_template)>::value, "Readable sources must have a 'static ReturnType load(CPU& cpu)' function");
 		static_assert((Usage == SourceUsage::ReadOnly) || std::is_same<decltype(SourceToTest::store), decltype(store_template)>::value, "Writeable sources must have a 'static void store(CPU& cpu, ReturnType value)' function");
 
@@ -30,6 +31,7 @@ namespace GB::Instructions::Sources{
 	template<typename ValueType, typename Source, int Offset>
 	struct OffsetOnLoad{
 		constexpr static uint8_t cycles = Source::cycles;
+		constexpr static uint8_t operand_bytes = Source::operand_bytes;
 
 		static inline ValueType load(CPU& cpu){
 			STATIC_ASSERT_IS_SOURCE_INTERFACE(Source, ValueType, SourceUsage::ReadAndWrite);
@@ -49,6 +51,7 @@ namespace GB::Instructions::Sources{
 	template<typename ValueType, typename Source, int Offset>
 	struct LoadWithOffset{
 		constexpr static uint8_t cycles = Source::cycles;
+		constexpr static uint8_t operand_bytes = Source::operand_bytes;
 
 		static inline ValueType load(CPU& cpu){
 			static_assert(Source::load);
@@ -62,6 +65,7 @@ namespace GB::Instructions::Sources{
 	template<typename ValueType, ValueType CPU::Registers::*RegisterPointer>
 	struct CPURegister{
 		constexpr static uint8_t cycles = 0;
+		constexpr static uint8_t operand_bytes = 0;
 	
 		static inline ValueType load(CPU& cpu){
 			return cpu.registers.*RegisterPointer;
@@ -95,6 +99,7 @@ namespace GB::Instructions::Sources{
 	template<typename ValueType>
 	struct Operand{
 		constexpr static uint8_t cycles = sizeof(ValueType)*4;
+		constexpr static uint8_t operand_bytes = sizeof(ValueType);
 	
 		static inline ValueType load(CPU& cpu){
 			return cpu.load_operand<ValueType>();
@@ -109,6 +114,7 @@ namespace GB::Instructions::Sources{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(PointerSource, uint16_t, SourceUsage::ReadOnly);
 		
 		constexpr static uint8_t cycles = 4;// + LoadPointerFromType::cycles; // TODO: Use this?
+		constexpr static uint8_t operand_bytes = PointerSource::operand_bytes;
 	
 		static inline uint8_t load(CPU& cpu){
 			uint16_t address = PointerSource::load(cpu);
@@ -131,6 +137,7 @@ namespace GB::Instructions::Sources{
 		STATIC_ASSERT_IS_SOURCE_INTERFACE(PointerSource, uint16_t, SourceUsage::ReadOnly);
 
 		constexpr static uint8_t cycles = 8;
+		constexpr static uint8_t operand_bytes = PointerSource::operand_bytes;
 	
 		static inline uint16_t load(CPU& cpu){
 			return cpu.mmu.read_word(PointerSource::load(cpu));
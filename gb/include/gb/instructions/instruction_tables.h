@@ -0,0 +1,710 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+// The opcode tables themselves, built at compile time.
+// InstructionSet only exposes them as plain arrays, which means every call through them is indirect.
+// Including this instead lets the compiler see which handler a constant opcode maps to,
+// so instruction_table[0x3E].execute(cpu) becomes a direct call that can be inlined.
+// It's heavy to compile, so only instruction_set.cpp and recompiled ROMs include it.
+
+#include "gb/cpu.h"
+#include "gb/instructions/instruction_set.h"
+#include "gb/instructions/all_instructions.h"
+#include "gb/instructions/instruction_sources.h"
+
+namespace GB::Instructions{
+	namespace TableBuilders{
+		using namespace GB::Instructions::Sources;
+
+		template<template <typename InType> typename InstructionType>
+		constexpr void populate_cb_instruction_block(InstructionSet::Table& cb_instructions, int index, const char* const name){
+			cb_instructions[index + 0] = make_instruction<InstructionType<RegisterB>>(name);
+			cb_instructions[index + 1] = make_instruction<InstructionType<RegisterC>>(name);
+			cb_instructions[index + 2] = make_instruction<InstructionType<RegisterD>>(name);
+			cb_instructions[index + 3] = make_instruction<InstructionType<RegisterE>>(name);
+			cb_instructions[index + 4] = make_instruction<InstructionType<RegisterH>>(name);
+			cb_instructions[index + 5] = make_instruction<InstructionType<RegisterL>>(name);
+			cb_instructions[index + 6] = make_instruction<InstructionType<Pointer<uint8_t, RegisterHL>>>(name);
+			cb_instructions[index + 7] = make_instruction<InstructionType<RegisterA>>(name);
+		}
+		template<template <typename InType, int Bit> typename InstructionType, int Bit>
+		constexpr void populate_cb_instruction_block(InstructionSet::Table& cb_instructions, int index, const char* const name){
+			cb_instructions[index + 0] = make_instruction<InstructionType<RegisterB, Bit>>(name);
+			cb_instructions[index + 1] = make_instruction<InstructionType<RegisterC, Bit>>(name);
+			cb_instructions[index + 2] = make_instruction<InstructionType<RegisterD, Bit>>(name);
+			cb_instructions[index + 3] = make_instruction<InstructionType<RegisterE, Bit>>(name);
+			cb_instructions[index + 4] = make_instruction<InstructionType<RegisterH, Bit>>(name);
+			cb_instructions[index + 5] = make_instruction<InstructionType<RegisterL, Bit>>(name);
+			cb_instructions[index + 6] = make_instruction<InstructionType<Pointer<uint8_t, RegisterHL>, Bit>>(name);
+			cb_instructions[index + 7] = make_instruction<InstructionType<RegisterA, Bit>>(name);
+		}
+
+		constexpr InstructionSet::Table build_instructions(){
+			InstructionSet::Table instructions{};
+			for (auto& instruction : instructions){
+				instruction = make_instruction<UnknownInstruction>("UNK");
+			}
+	
+			/* 
+			   0x00
+			*/
+			instructions[0x00] = make_instruction<NoopInstruction>("NOOP");
+			instructions[0x01] = make_instruction<LoadInstruction<RegisterBC,
+																  Operand<uint16_t>>>("LD BC,d16");
+			instructions[0x02] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterBC>,
+																  RegisterA>>("LD (BC),A");
+			instructions[0x03] = make_instruction<ALU::IncrementInstruction<uint16_t,
+																			RegisterBC>>("INC BC");
+			instructions[0x04] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			RegisterB>>("INC B");
+			instructions[0x05] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			RegisterB>>("DEC B");
+			instructions[0x06] = make_instruction<LoadInstruction<RegisterB,
+																  Operand<uint8_t>>>("LD B,d8");
+			instructions[0x07] = make_instruction<ALU::RotateInstruction<RegisterA,
+																		 true,
+																		 false>>("RLC A");
+			instructions[0x08] = make_instruction<LoadInstruction<PointerFromOperand<uint16_t>,
+																  RegisterSP>>("LD (a16),SP");
+			instructions[0x09] = make_instruction<ALU::AddInstruction<uint16_t,
+																	  RegisterHL,
+																	  RegisterBC,
+																	  false>>("ADD HL,BC");
+			instructions[0x0A] = make_instruction<LoadInstruction<RegisterA,
+																  Pointer<uint8_t, RegisterBC>>>("LD A,(BC)");
+			instructions[0x0B] = make_instruction<ALU::DecrementInstruction<uint16_t,
+																			RegisterBC>>("DEC BC");
+			instructions[0x0C] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			RegisterC>>("INC C");
+			instructions[0x0D] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			RegisterC>>("DEC C");
+			instructions[0x0E] = make_instruction<LoadInstruction<RegisterC,
+																  Operand<uint8_t>>>("LD C,d8");
+			instructions[0x0F] = make_instruction<ALU::RotateInstruction<RegisterA,
+																		 false,
+																		 false>>("RRC A");
+
+			/* 
+			   0x10
+			*/
+			instructions[0x10] = make_instruction<StopInstruction>("STOP");
+			instructions[0x11] = make_instruction<LoadInstruction<CPURegister<uint16_t, &CPU::Registers::de>,
+																  Operand<uint16_t>>>("LD DE,d16");
+			instructions[0x12] = make_instruction<LoadInstruction<Pointer<uint8_t, CPURegister<uint16_t, &CPU::Registers::de>>,
+																  RegisterA>>("LD (DE),A");
+			instructions[0x13] = make_instruction<ALU::IncrementInstruction<uint16_t,
+																			CPURegister<uint16_t, &CPU::Registers::de>>>("INC DE");
+			instructions[0x14] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			RegisterD>>("INC D");
+			instructions[0x15] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			RegisterD>>("DEC D");
+			instructions[0x16] = make_instruction<LoadInstruction<RegisterD,
+																  Operand<uint8_t>>>("LD D,d8");
+			instructions[0x17] = make_instruction<ALU::RotateInstruction<RegisterA,
+																		 true,
+																		 true>>("RL A");
+			instructions[0x18] = make_instruction<JumpInstruction<JumpCondition::Always,
+																  JumpMode::SignedOffset,
+																  Operand<uint8_t>>>("JR r8");
+			instructions[0x19] = make_instruction<ALU::AddInstruction<uint16_t,
+																	  RegisterHL,
+																	  CPURegister<uint16_t, &CPU::Registers::de>,
+																	  false>>("ADD HL,DE");
+			instructions[0x1A] = make_instruction<LoadInstruction<RegisterA,
+																  Pointer<uint8_t, CPURegister<uint16_t, &CPU::Registers::de>>>>("LD A,(DE)");
+			instructions[0x1B] = make_instruction<ALU::DecrementInstruction<uint16_t,
+																			CPURegister<uint16_t, &CPU::Registers::de>>>("DEC DE");
+			instructions[0x1C] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			RegisterE>>("INC E");
+			instructions[0x1D] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			RegisterE>>("DEC E");
+			instructions[0x1E] = make_instruction<LoadInstruction<RegisterE,
+																  Operand<uint8_t>>>("LD E,d8");
+			instructions[0x1F] = make_instruction<ALU::RotateInstruction<RegisterA,
+																		 false,
+																		 true>>("RR A");
+
+			/* 
+			   0x20
+			*/
+			instructions[0x20] = make_instruction<JumpInstruction<JumpCondition::NotZero,
+																  JumpMode::SignedOffset,
+																  Operand<uint8_t>>>("JR NZ,r8");
+			instructions[0x21] = make_instruction<LoadInstruction<RegisterHL,
+																  Operand<uint16_t>>>("LD HL,d16");
+			instructions[0x22] = make_instruction<LoadInstruction<Pointer<uint8_t, IncrementOnLoad<uint16_t, RegisterHL>>,
+																  RegisterA>>("LD (HL+),A");
+			instructions[0x23] = make_instruction<ALU::IncrementInstruction<uint16_t,
+																			RegisterHL>>("INC HL");
+			instructions[0x24] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			RegisterH>>("INC H");
+			instructions[0x25] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			RegisterH>>("DEC H");
+			instructions[0x26] = make_instruction<LoadInstruction<RegisterH,
+																  Operand<uint8_t>>>("LD H,d8");
+			instructions[0x27] = make_instruction<BCDCorrectInstruction<RegisterA>>("DAA");
+			instructions[0x28] = make_instruction<JumpInstruction<JumpCondition::Zero,
+																  JumpMode::SignedOffset,
+																  Operand<uint8_t>>>("JR Z,r8");
+			instructions[0x29] = make_instruction<ALU::AddInstruction<uint16_t,
+																	  RegisterHL,
+																	  RegisterHL,
+																	  false>>("ADD HL,HL");
+			instructions[0x2A] = make_instruction<LoadInstruction<RegisterA,
+																  Pointer<uint8_t, IncrementOnLoad<uint16_t, RegisterHL>>>>("LD A,(HL+)");
+			instructions[0x2B] = make_instruction<ALU::DecrementInstruction<uint16_t,
+																			RegisterHL>>("DEC HL");
+			instructions[0x2C] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			RegisterL>>("INC L");
+			instructions[0x2D] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			RegisterL>>("DEC L");
+			instructions[0x2E] = make_instruction<LoadInstruction<RegisterL,
+																  Operand<uint8_t>>>("LD L,d8");
+			instructions[0x2F] = make_instruction<ALU::NotInstruction<RegisterA,
+																	  RegisterA>>("CPL");
+
+			/* 
+			   0x30
+			*/
+			instructions[0x30] = make_instruction<JumpInstruction<JumpCondition::NotCarry,
+																  JumpMode::SignedOffset,
+																  Operand<uint8_t>>>("JR NC,r8");
+			instructions[0x31] = make_instruction<LoadInstruction<RegisterSP,
+																  Operand<uint16_t>>>("LD SP,d16");
+			instructions[0x32] = make_instruction<LoadInstruction<Pointer<uint8_t, DecrementOnLoad<uint16_t, RegisterHL>>,
+																  RegisterA>>("LD (HL-),A");
+			instructions[0x33] = make_instruction<ALU::IncrementInstruction<uint16_t,
+																			RegisterSP>>("INC SP");
+			instructions[0x34] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			Pointer<uint8_t, RegisterHL>>>("INC (HL)");
+			instructions[0x35] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			Pointer<uint8_t, RegisterHL>>>("DEC (HL)");
+			instructions[0x36] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  Operand<uint8_t>>>("LD (HL),d8");
+			instructions[0x37] = make_instruction<SetCarryFlagInstruction<true>>("SCF");
+			instructions[0x38] = make_instruction<JumpInstruction<JumpCondition::Carry,
+																  JumpMode::SignedOffset,
+																  Operand<uint8_t>>>("JR C,r8");
+			instructions[0x39] = make_instruction<ALU::AddInstruction<uint16_t,
+																	  RegisterHL,
+																	  RegisterSP,
+																	  false>>("ADD HL,SP");
+			instructions[0x3A] = make_instruction<LoadInstruction<RegisterA,
+																  Pointer<uint8_t, DecrementOnLoad<uint16_t, RegisterHL>>>>("LD A,(HL-)");
+			instructions[0x3B] = make_instruction<ALU::DecrementInstruction<uint16_t,
+																			RegisterSP>>("DEC SP");
+			instructions[0x3C] = make_instruction<ALU::IncrementInstruction<uint8_t,
+																			RegisterA>>("INC A");
+			instructions[0x3D] = make_instruction<ALU::DecrementInstruction<uint8_t,
+																			RegisterA>>("DEC A");
+			instructions[0x3E] = make_instruction<LoadInstruction<RegisterA,
+																  Operand<uint8_t>>>("LD A,d8");
+			instructions[0x3F] = make_instruction<ComplementCarryFlagInstruction>("CCF");
+	
+			/* 
+			   0x40
+			*/
+			// LD to B
+			instructions[0x40] = make_instruction<NoopInstruction>("LD B,B");
+			instructions[0x41] = make_instruction<LoadInstruction<RegisterB,
+																  RegisterC>>("LD B,C");
+			instructions[0x42] = make_instruction<LoadInstruction<RegisterB,
+																  RegisterD>>("LD B,D");
+			instructions[0x43] = make_instruction<LoadInstruction<RegisterB,
+																  RegisterE>>("LD B,E");
+			instructions[0x44] = make_instruction<LoadInstruction<RegisterB,
+																  RegisterH>>("LD B,H");
+			instructions[0x45] = make_instruction<LoadInstruction<RegisterB,
+																  RegisterL>>("LD B,L");
+			instructions[0x46] = make_instruction<LoadInstruction<RegisterB,
+																  Pointer<uint8_t, RegisterHL>>>("LD B,(HL)");
+			instructions[0x47] = make_instruction<LoadInstruction<RegisterB,
+																  RegisterA>>("LD B,A");
+			// LD to C
+			instructions[0x48] = make_instruction<LoadInstruction<RegisterC,
+																  RegisterB>>("LD C,B");
+			instructions[0x49] = make_instruction<NoopInstruction>("LD C,C");
+			instructions[0x4A] = make_instruction<LoadInstruction<RegisterC,
+																  RegisterD>>("LD C,D");
+			instructions[0x4B] = make_instruction<LoadInstruction<RegisterC,
+																  RegisterE>>("LD C,E");
+			instructions[0x4C] = make_instruction<LoadInstruction<RegisterC,
+																  RegisterH>>("LD C,H");
+			instructions[0x4D] = make_instruction<LoadInstruction<RegisterC,
+																  RegisterL>>("LD C,L");
+			instructions[0x4E] = make_instruction<LoadInstruction<RegisterC,
+																  Pointer<uint8_t, RegisterHL>>>("LD C,(HL)");
+			instructions[0x4F] = make_instruction<LoadInstruction<RegisterC,
+																  RegisterA>>("LD C,A");
+
+			/* 
+			   0x50
+			*/
+			// LD to D
+			instructions[0x50] = make_instruction<LoadInstruction<RegisterD,
+																  RegisterB>>("LD D,B");
+			instructions[0x51] = make_instruction<LoadInstruction<RegisterD,
+																  RegisterC>>("LD D,C");
+			instructions[0x52] = make_instruction<NoopInstruction>("LD D,D");
+			instructions[0x53] = make_instruction<LoadInstruction<RegisterD,
+																  RegisterE>>("LD D,E");
+			instructions[0x54] = make_instruction<LoadInstruction<RegisterD,
+																  RegisterH>>("LD D,H");
+			instructions[0x55] = make_instruction<LoadInstruction<RegisterD,
+																  RegisterL>>("LD D,L");
+			instructions[0x56] = make_instruction<LoadInstruction<RegisterD,
+																  Pointer<uint8_t, RegisterHL>>>("LD D,(HL)");
+			instructions[0x57] = make_instruction<LoadInstruction<RegisterD,
+																  RegisterA>>("LD D,A");
+
+			// LD to E
+			instructions[0x58] = make_instruction<LoadInstruction<RegisterE,
+																  RegisterB>>("LD E,B");
+			instructions[0x59] = make_instruction<LoadInstruction<RegisterE,
+																  RegisterC>>("LD E,C");
+			instructions[0x5A] = make_instruction<LoadInstruction<RegisterE,
+																  RegisterD>>("LD E,D");
+			instructions[0x5B] = make_instruction<NoopInstruction>("LD E,E");
+			instructions[0x5C] = make_instruction<LoadInstruction<RegisterE,
+																  RegisterH>>("LD E,H");
+			instructions[0x5D] = make_instruction<LoadInstruction<RegisterE,
+																  RegisterL>>("LD E,L");
+			instructions[0x5E] = make_instruction<LoadInstruction<RegisterE,
+																  Pointer<uint8_t, RegisterHL>>>("LD E,(HL)");
+			instructions[0x5F] = make_instruction<LoadInstruction<RegisterE,
+																  RegisterA>>("LD E,A");
+
+			/* 
+			   0x60
+			*/
+			// LD to H
+			instructions[0x60] = make_instruction<LoadInstruction<RegisterH,
+																  RegisterB>>("LD H,B");
+			instructions[0x61] = make_instruction<LoadInstruction<RegisterH,
+																  RegisterC>>("LD H,C");
+			instructions[0x62] = make_instruction<LoadInstruction<RegisterH,
+																  RegisterD>>("LD H,D");
+			instructions[0x63] = make_instruction<LoadInstruction<RegisterH,
+																  RegisterE>>("LD H,E");
+			instructions[0x64] = make_instruction<NoopInstruction>("LD H,H");
+			instructions[0x65] = make_instruction<LoadInstruction<RegisterH,
+																  RegisterL>>("LD H,L");
+			instructions[0x66] = make_instruction<LoadInstruction<RegisterH,
+																  Pointer<uint8_t, RegisterHL>>>("LD D,(HL)");
+			instructions[0x67] = make_instruction<LoadInstruction<RegisterH,
+																  RegisterA>>("LD H,A");
+
+			// LD to L
+			instructions[0x68] = make_instruction<LoadInstruction<RegisterL,
+																  RegisterB>>("LD L,B");
+			instructions[0x69] = make_instruction<LoadInstruction<RegisterL,
+																  RegisterC>>("LD L,C");
+			instructions[0x6A] = make_instruction<LoadInstruction<RegisterL,
+																  RegisterD>>("LD L,D");
+			instructions[0x6B] = make_instruction<LoadInstruction<RegisterL,
+																  RegisterE>>("LD L,E");
+			instructions[0x6C] = make_instruction<LoadInstruction<RegisterL,
+																  RegisterH>>("LD L,H");
+			instructions[0x6D] = make_instruction<NoopInstruction>("LD L,L");
+			instructions[0x6E] = make_instruction<LoadInstruction<RegisterL,
+																  Pointer<uint8_t, RegisterHL>>>("LD L,(HL)");
+			instructions[0x6F] = make_instruction<LoadInstruction<RegisterL,
+																  RegisterA>>("LD L,A");
+
+			/* 
+			   0x70
+			*/
+			// LD to (HL), 0x76 is HALT
+			instructions[0x70] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  RegisterB>>("LD (HL),B");
+			instructions[0x71] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  RegisterC>>("LD (HL),C");
+			instructions[0x72] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  RegisterD>>("LD (HL),D");
+			instructions[0x73] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  RegisterE>>("LD (HL),E");
+			instructions[0x74] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  RegisterH>>("LD (HL),H");
+			instructions[0x75] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  RegisterL>>("LD (HL),L");
+			instructions[0x76] = make_instruction<HaltInstruction>("HALT"); // TODO: Halting stops until an interrups happens (regardless of whether the interrupt master is true or not). implement this before using this instruction
+			instructions[0x77] = make_instruction<LoadInstruction<Pointer<uint8_t, RegisterHL>,
+																  RegisterA>>("LD (HL),A");
+			// LD to A
+			instructions[0x78] = make_instruction<LoadInstruction<RegisterA,
+																  RegisterB>>("LD A,B");
+			instructions[0x79] = make_instruction<LoadInstruction<RegisterA,
+																  RegisterC>>("LD A,C");
+			instructions[0x7A] = make_instruction<LoadInstruction<RegisterA,
+																  RegisterD>>("LD A,D");
+			instructions[0x7B] = make_instruction<LoadInstruction<RegisterA,
+																  RegisterE>>("LD A,E");
+			instructions[0x7C] = make_instruction<LoadInstruction<RegisterA,
+																  RegisterH>>("LD A,H");
+			instructions[0x7D] = make_instruction<LoadInstruction<RegisterA,
+																  RegisterL>>("LD A,L");
+			instructions[0x7E] = make_instruction<LoadInstruction<RegisterA,
+																  Pointer<uint8_t, RegisterHL>>>("LD A,(HL)");
+			instructions[0x7F] = make_instruction<NoopInstruction>("LD A,A");
+
+			/* 
+			   0x80
+			*/
+			// ADD to A (Add without Carry)
+			instructions[0x80] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterB,
+																	  false>>("ADD A,B");
+			instructions[0x81] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterC,
+																	  false>>("ADD A,C");
+			instructions[0x82] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterD,
+																	  false>>("ADD A,D");
+			instructions[0x83] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterE,
+																	  false>>("ADD A,E");
+			instructions[0x84] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterH,
+																	  false>>("ADD A,H");
+			instructions[0x85] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterL,
+																	  false>>("ADD A,L");
+			instructions[0x86] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  Pointer<uint8_t, RegisterHL>,
+																	  false>>("ADD A,(HL)");
+			instructions[0x87] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterA,
+																	  false>>("ADD A,A");
+			// ADC to A (Add with Carry)
+			instructions[0x88] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterB,
+																	  true>>("ADC A,B");
+			instructions[0x89] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterC,
+																	  true>>("ADC A,C");
+			instructions[0x8A] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterD,
+																	  true>>("ADC A,D");
+			instructions[0x8B] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterE,
+																	  true>>("ADC A,E");
+			instructions[0x8C] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterH,
+																	  true>>("ADC A,H");
+			instructions[0x8D] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterL,
+																	  true>>("ADC A,L");
+			instructions[0x8E] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  Pointer<uint8_t, RegisterHL>,
+																	  true>>("ADC A,(HL)");
+			instructions[0x8F] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  RegisterA,
+																	  true>>("ADC A,A");
+	
+			/* 
+			   0x90
+			*/
+			// SUB from A (Subtract without Carry)
+			instructions[0x90] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterB,
+																	  false>>("SUB A,B");
+			instructions[0x91] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterC,
+																	  false>>("SUB A,C");
+			instructions[0x92] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterD,
+																	  false>>("SUB A,D");
+			instructions[0x93] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterE,
+																	  false>>("SUB A,E");
+			instructions[0x94] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterH,
+																	  false>>("SUB A,H");
+			instructions[0x95] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterL,
+																	  false>>("SUB A,L");
+			instructions[0x96] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  Pointer<uint8_t, RegisterHL>,
+																	  false>>("SUB A,(HL)");
+			instructions[0x97] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterA,
+																	  false>>("SUB A,A");
+			// SBC from A (Subtract with Carry)
+			instructions[0x98] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterB,
+																	  true>>("SBC A,B");
+			instructions[0x99] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterC,
+																	  true>>("SBC A,C");
+			instructions[0x9A] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterD,
+																	  true>>("SBC A,D");
+			instructions[0x9B] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterE,
+																	  true>>("SBC A,E");
+			instructions[0x9C] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterH,
+																	  true>>("SBC A,H");
+			instructions[0x9D] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterL,
+																	  true>>("SBC A,L");
+			instructions[0x9E] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  Pointer<uint8_t, RegisterHL>,
+																	  true>>("SBC A,(HL)");
+			instructions[0x9F] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  RegisterA,
+																	  true>>("SBC A,A");
+
+			/* 
+			   0xA0
+			*/
+			// AND with A
+			instructions[0xA0] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  RegisterB>>("AND B");
+			instructions[0xA1] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  RegisterC>>("AND C");
+			instructions[0xA2] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  RegisterD>>("AND D");
+			instructions[0xA3] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  RegisterE>>("AND E");
+			instructions[0xA4] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  RegisterH>>("AND H");
+			instructions[0xA5] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  RegisterL>>("AND L");
+			instructions[0xA6] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  Pointer<uint8_t, RegisterHL>>>("AND (HL)");
+			instructions[0xA7] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  RegisterA>>("AND A"); // TODO: This could be no-op?
+			// XOR with A
+			instructions[0xA8] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  RegisterB>>("XOR B");
+			instructions[0xA9] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  RegisterC>>("XOR C");
+			instructions[0xAA] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  RegisterD>>("XOR D");
+			instructions[0xAB] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  RegisterE>>("XOR E");
+			instructions[0xAC] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  RegisterH>>("XOR H");
+			instructions[0xAD] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  RegisterL>>("XOR L");
+			instructions[0xAE] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  Pointer<uint8_t, RegisterHL>>>("XOR (HL)");
+			instructions[0xAF] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  RegisterA>>("XOR A");
+
+			/* 
+			   0xB0
+			*/
+			// OR with A
+			instructions[0xB0] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 RegisterB>>("OR B");
+			instructions[0xB1] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 RegisterC>>("OR C");
+			instructions[0xB2] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 RegisterD>>("OR D");
+			instructions[0xB3] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 RegisterE>>("OR E");
+			instructions[0xB4] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 RegisterH>>("OR H");
+			instructions[0xB5] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 RegisterL>>("OR L");
+			instructions[0xB6] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 Pointer<uint8_t, RegisterHL>>>("OR (HL)");
+			instructions[0xB7] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 RegisterA>>("OR A"); // TODO: This could be no-op?
+			// CP with A (Compare)
+			instructions[0xB8] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  RegisterB>>("CP B");
+			instructions[0xB9] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  RegisterC>>("CP C");
+			instructions[0xBA] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  RegisterD>>("CP D");
+			instructions[0xBB] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  RegisterE>>("CP E");
+			instructions[0xBC] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  RegisterH>>("CP H");
+			instructions[0xBD] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  RegisterL>>("CP L");
+			instructions[0xBE] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  Pointer<uint8_t, RegisterHL>>>("CP (HL)");
+			instructions[0xBF] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  RegisterA>>("CP A");
+
+			/*
+			  0xC0
+			*/
+			instructions[0xC0] = make_instruction<ReturnInstruction<JumpCondition::NotZero>>("RET NZ");
+			instructions[0xC1] = make_instruction<PopStackInstruction<RegisterBC>>("POP BC");
+			instructions[0xC2] = make_instruction<JumpInstruction<JumpCondition::NotZero,
+																  JumpMode::AbsoluteValue,
+																  Operand<uint16_t>>>("JP NZ,a16");
+			instructions[0xC3] = make_instruction<JumpInstruction<JumpCondition::Always,
+																  JumpMode::AbsoluteValue,
+																  Operand<uint16_t>>>("JP a16");
+			instructions[0xC4] = make_instruction<CallInstruction<Operand<uint16_t>, JumpCondition::NotZero>>("CALL NZ, a16");
+			instructions[0xC5] = make_instruction<PushStackInstruction<RegisterBC>>("PUSH BC");
+			instructions[0xC6] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  Operand<uint8_t>,
+																	  false>>("ADD A,d8");
+			instructions[0xC7] = make_instruction<CallRoutineInstruction<0x00>>("RST 0");
+			instructions[0xC8] = make_instruction<ReturnInstruction<JumpCondition::Zero>>("RET Z");
+			instructions[0xC9] = make_instruction<ReturnInstruction<JumpCondition::Always>>("RET");
+			instructions[0xCA] = make_instruction<JumpInstruction<JumpCondition::Zero,
+																  JumpMode::AbsoluteValue,
+																  Operand<uint16_t>>>("JP Z,a16");
+			// 0xCB is the prefix for cb_instructions, see InstructionSet::get_instruction
+			instructions[0xCC] = make_instruction<CallInstruction<Operand<uint16_t>, JumpCondition::Zero>>("CALL Z, a16");
+			instructions[0xCD] = make_instruction<CallInstruction<Operand<uint16_t>>>("CALL NN");
+			instructions[0xCE] = make_instruction<ALU::AddInstruction<uint8_t,
+																	  RegisterA,
+																	  Operand<uint8_t>,
+																	  true>>("ADC A,d8");
+			instructions[0xCF] = make_instruction<CallRoutineInstruction<0x08>>("RST 8");
+
+
+			/*
+			  0xD0
+			*/
+			instructions[0xD0] = make_instruction<ReturnInstruction<JumpCondition::NotCarry>>("RET NC");
+			instructions[0xD1] = make_instruction<PopStackInstruction<CPURegister<uint16_t, &CPU::Registers::de>>>("POP DE");
+			instructions[0xD2] = make_instruction<JumpInstruction<JumpCondition::NotCarry,
+																  JumpMode::AbsoluteValue,
+																  Operand<uint16_t>>>("JP NC,a16");
+			instructions[0xD4] = make_instruction<CallInstruction<Operand<uint16_t>, JumpCondition::NotCarry>>("CALL NC, a16");
+			instructions[0xD5] = make_instruction<PushStackInstruction<CPURegister<uint16_t, &CPU::Registers::de>>>("PUSH DE");
+			instructions[0xD6] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  Operand<uint8_t>,
+																	  false>>("SUB A,d8");
+			instructions[0xD7] = make_instruction<CallRoutineInstruction<0x10>>("RST 10");
+			instructions[0xD8] = make_instruction<ReturnInstruction<JumpCondition::Carry>>("RET C");
+			instructions[0xD9] = make_instruction<ReturnInterruptInstruction>("RETI");
+			instructions[0xDA] = make_instruction<JumpInstruction<JumpCondition::Carry,
+																  JumpMode::AbsoluteValue,
+																  Operand<uint16_t>>>("JP C,a16");
+			instructions[0xDC] = make_instruction<CallInstruction<Operand<uint16_t>, JumpCondition::Carry>>("CALL C, a16");
+			instructions[0xDE] = make_instruction<ALU::SubInstruction<RegisterA,
+																	  Operand<uint8_t>,
+																	  true>>("SBC A,d8");
+			instructions[0xDF] = make_instruction<CallRoutineInstruction<0x18>>("RST 18");
+
+
+			/*
+			  0xE0
+			*/
+			instructions[0xE0] = make_instruction<LoadInstruction<PointerFromOffsetFF00<Operand<uint8_t>>,
+																  RegisterA>>("LDH (n),A");
+			instructions[0xE1] = make_instruction<PopStackInstruction<RegisterHL>>("POP HL");
+			instructions[0xE2] = make_instruction<LoadInstruction<PointerFromOffsetFF00<RegisterC>,
+																  RegisterA>>("LDH (C),A");
+			instructions[0xE5] = make_instruction<PushStackInstruction<RegisterHL>>("PUSH HL");
+			instructions[0xE6] = make_instruction<ALU::AndInstruction<RegisterA,
+																	  Operand<uint8_t>>>("AND d8");
+			instructions[0xE7] = make_instruction<CallRoutineInstruction<0x20>>("RST 20");
+			instructions[0xE8] = make_instruction<AddSigned8BitImmediateToSPInstruction>("ADD SP,r8");
+			instructions[0xE9] = make_instruction<JumpInstruction<JumpCondition::Always,
+																  JumpMode::AbsoluteValue,
+																  RegisterHL>>("JP (HL)"); // TODO: This doesn't seem right at all, but it works for Tetris. Coincidence?
+			//WordPointer<RegisterHL>>{"JP (HL)"};
+			instructions[0xEA] = make_instruction<LoadInstruction<PointerFromOperand<uint8_t>,
+																  RegisterA>>("LD (nn),A");
+			instructions[0xEE] = make_instruction<ALU::XorInstruction<RegisterA,
+																	  Operand<uint8_t>>>("XOR n");
+			instructions[0xEF] = make_instruction<CallRoutineInstruction<0x28>>("RST 28");
+
+			/*
+			  0xF0
+			*/
+			instructions[0xF0] = make_instruction<LoadInstruction<RegisterA,
+																  PointerFromOffsetFF00<Operand<uint8_t>>>>("LDH A,(n)");
+			instructions[0xF1] = make_instruction<PopStackInstruction<CPURegister<uint16_t, &CPU::Registers::af>>>("POP AF");
+			instructions[0xF2] = make_instruction<LoadInstruction<RegisterA,
+																  PointerFromOffsetFF00<RegisterC>>>("LDH A,(C)");
+			instructions[0xF3] = make_instruction<SetInterruptsEnabledInstruction<false>>("DI");
+			instructions[0xF5] = make_instruction<PushStackInstruction<CPURegister<uint16_t, &CPU::Registers::af>>>("PUSH AF");
+			instructions[0xF6] = make_instruction<ALU::OrInstruction<RegisterA,
+																	 Operand<uint8_t>>>("OR d8");
+			instructions[0xF7] = make_instruction<CallRoutineInstruction<0x30>>("RST 30");
+			instructions[0xF8] = make_instruction<LDHLInstruction<RegisterHL,
+																  RegisterSP,
+																  Operand<uint8_t>>>("LD HL, SP + r8");
+			instructions[0xF9] = make_instruction<LoadInstruction<RegisterSP,
+																  RegisterHL>>("LD SP,HL");
+			instructions[0xFA] = make_instruction<LoadInstruction<RegisterA,
+																  PointerFromOperand<uint8_t>>>("LD A,(nn)");
+			instructions[0xFB] = make_instruction<SetInterruptsEnabledInstruction<true>>("EI");
+			instructions[0xFE] = make_instruction<ALU::CompareInstruction<RegisterA,
+																		  Operand<uint8_t>>>("CP n");
+			instructions[0xFF] = make_instruction<CallRoutineInstruction<0x38>>("RST 38");
+
+			return instructions;
+		}
+
+		constexpr InstructionSet::Table build_cb_instructions(){
+			InstructionSet::Table cb_instructions{};
+			for (auto& instruction : cb_instructions){
+				instruction = make_instruction<CB::UnknownInstruction>("UNK CB");
+			}
+
+			populate_cb_instruction_block<CB::RLC>(cb_instructions, 0x00, "RLC");
+			populate_cb_instruction_block<CB::RRC>(cb_instructions, 0x08, "RRC");
+			populate_cb_instruction_block<CB::RL>(cb_instructions, 0x10, "RL");
+			populate_cb_instruction_block<CB::RR>(cb_instructions, 0x18, "RR");
+
+			populate_cb_instruction_block<CB::SLA>(cb_instructions, 0x20, "SLA");
+			populate_cb_instruction_block<CB::SRA>(cb_instructions, 0x28, "SRA");
+			populate_cb_instruction_block<CB::SWAP>(cb_instructions, 0x30, "SWAP");
+			populate_cb_instruction_block<CB::SRL>(cb_instructions, 0x38, "SRL");
+
+			populate_cb_instruction_block<CB::BIT, 0>(cb_instructions, 0x40, "BIT");
+			populate_cb_instruction_block<CB::BIT, 1>(cb_instructions, 0x48, "BIT");
+			populate_cb_instruction_block<CB::BIT, 2>(cb_instructions, 0x50, "BIT");
+			populate_cb_instruction_block<CB::BIT, 3>(cb_instructions, 0x58, "BIT");
+			populate_cb_instruction_block<CB::BIT, 4>(cb_instructions, 0x60, "BIT");
+			populate_cb_instruction_block<CB::BIT, 5>(cb_instructions, 0x68, "BIT");
+			populate_cb_instruction_block<CB::BIT, 6>(cb_instructions, 0x70, "BIT");
+			populate_cb_instruction_block<CB::BIT, 7>(cb_instructions, 0x78, "BIT");
+
+			populate_cb_instruction_block<CB::RES, 0>(cb_instructions, 0x80, "RES");
+			populate_cb_instruction_block<CB::RES, 1>(cb_instructions, 0x88, "RES");
+			populate_cb_instruction_block<CB::RES, 2>(cb_instructions, 0x90, "RES");
+			populate_cb_instruction_block<CB::RES, 3>(cb_instructions, 0x98, "RES");
+			populate_cb_instruction_block<CB::RES, 4>(cb_instructions, 0xA0, "RES");
+			populate_cb_instruction_block<CB::RES, 5>(cb_instructions, 0xA8, "RES");
+			populate_cb_instruction_block<CB::RES, 6>(cb_instructions, 0xB0, "RES");
+			populate_cb_instruction_block<CB::RES, 7>(cb_instructions, 0xB8, "RES");
+
+			populate_cb_instruction_block<CB::SET, 0>(cb_instructions, 0xC0, "SET");
+			populate_cb_instruction_block<CB::SET, 1>(cb_instructions, 0xC8, "SET");
+			populate_cb_instruction_block<CB::SET, 2>(cb_instructions, 0xD0, "SET");
+			populate_cb_instruction_block<CB::SET, 3>(cb_instructions, 0xD8, "SET");
+			populate_cb_instruction_block<CB::SET, 4>(cb_instructions, 0xE0, "SET");
+			populate_cb_instruction_block<CB::SET, 5>(cb_instructions, 0xE8, "SET");
+			populate_cb_instruction_block<CB::SET, 6>(cb_instructions, 0xF0, "SET");
+			populate_cb_instruction_block<CB::SET, 7>(cb_instructions, 0xF8, "SET");
+
+			return cb_instructions;
+		}
+	}
+
+	inline constexpr InstructionSet::Table instruction_table = TableBuilders::build_instructions();
+	inline constexpr InstructionSet::Table cb_instruction_table = TableBuilders::build_cb_instructions();
+}
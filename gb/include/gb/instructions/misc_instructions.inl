@@ -10,37 +10,59 @@
 
 namespace GB::Instructions{
 
-	class NoopInstruction : public Instruction{	
-		using Instruction::Instruction;
-		uint8_t execute(CPU& cpu) override{
-			return 4;
+	class UnknownInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 0;
+
+		static uint8_t execute(CPU& cpu){
+			fprintf(stderr, "Tried to run an unknown instruction!\n");
+			cpu.stopped = true;
+			return cycles;
 		}
 	};
-	class HaltInstruction : public Instruction{
-		using Instruction::Instruction;
-		uint8_t execute(CPU& cpu) override{
+
+	class NoopInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 4;
+
+		static uint8_t execute(CPU& cpu){
+			return cycles;
+		}
+	};
+	class HaltInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 4;
+
+		static uint8_t execute(CPU& cpu){
 			cpu.halted = true;
 			cpu.interrupts.find_next_interrupt();
-			return 4;
+			return cycles;
 		}
 	};
-	class StopInstruction : public Instruction{
-		using Instruction::Instruction;
+	class StopInstruction{
+	public:
+		constexpr static uint8_t length = 2;
+		constexpr static uint8_t cycles = 4;
 
-		uint8_t execute(CPU& cpu) override{
+		static uint8_t execute(CPU& cpu){
 			cpu.registers.pc++; // TODO: Necessary?
-			return 4;
+			return cycles;
 		}
 	};
 
 	template<typename StoreToType, typename LoadFromType>
-	class LoadInstruction : public Instruction{
-		using Instruction::Instruction;
+	class LoadInstruction{
+	public:
+		constexpr static uint8_t length = 1 + StoreToType::operand_bytes + LoadFromType::operand_bytes;
+		constexpr static uint8_t cycles = 4 + LoadFromType::cycles + StoreToType::cycles;
 	
-		uint8_t execute(CPU& cpu) override{
+		static uint8_t execute(CPU& cpu){
 			auto val = LoadFromType::load(cpu);
 			StoreToType::store(cpu, val);
-			return 4 + LoadFromType::cycles + StoreToType::cycles;
+			return cycles;
 		}
 	};
 
@@ -56,11 +78,9 @@ namespace GB::Instructions{
 		AbsoluteValue
 	};
 	template<JumpCondition Condition>
-	class JumpInstructionBase : public Instruction{
-		using Instruction::Instruction;
-
+	class JumpInstructionBase{
 	protected:
-		bool should_jump(CPU& cpu){
+		static bool should_jump(CPU& cpu){
 			switch(Condition){
 			case JumpCondition::Always:
 				return true;
@@ -82,11 +102,13 @@ namespace GB::Instructions{
 	class JumpInstruction{};
 	template<JumpCondition Condition, typename JumpValueType>
 	class JumpInstruction<Condition, JumpMode::SignedOffset, JumpValueType> : public JumpInstructionBase<Condition>{
-		using JumpInstructionBase<Condition>::JumpInstructionBase;
+	public:
+		constexpr static uint8_t length = 1 + JumpValueType::operand_bytes;
+		constexpr static uint8_t cycles = 8;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			int8_t jump_by = static_cast<int8_t>(JumpValueType::load(cpu));
-			if (!JumpInstructionBase<Condition>::should_jump(cpu)) return 8;
+			if (!JumpInstructionBase<Condition>::should_jump(cpu)) return cycles;
 
 			if (CPU::extended_debug_data)
 				fprintf(stdout, "jump_by: 0x%02x (%d dec)\n", jump_by, jump_by);
@@ -97,11 +119,13 @@ namespace GB::Instructions{
 	};
 	template<JumpCondition Condition, typename JumpValueType>
 	class JumpInstruction<Condition, JumpMode::AbsoluteValue, JumpValueType> : public JumpInstructionBase<Condition>{
-		using JumpInstructionBase<Condition>::JumpInstructionBase;
+	public:
+		constexpr static uint8_t length = 1 + JumpValueType::operand_bytes;
+		constexpr static uint8_t cycles = JumpValueType::cycles + 4;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			uint16_t jump_to = JumpValueType::load(cpu);
-			if (!JumpInstructionBase<Condition>::should_jump(cpu)) return JumpValueType::cycles + 4;
+			if (!JumpInstructionBase<Condition>::should_jump(cpu)) return cycles;
 
 			cpu.jump_to(jump_to);
 		
@@ -111,28 +135,30 @@ namespace GB::Instructions{
 
 	template<JumpCondition Condition>
 	class ReturnInstruction : public JumpInstructionBase<Condition>{
-		using JumpInstructionBase<Condition>::JumpInstructionBase;
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 8;
 
-		uint8_t execute(CPU& cpu){
-			if (!JumpInstructionBase<Condition>::should_jump(cpu)) return 8;
+		static uint8_t execute(CPU& cpu){
+			if (!JumpInstructionBase<Condition>::should_jump(cpu)) return cycles;
 			cpu.jump_to(cpu.pop_from_stack());
 			return 20;
 		}
 	};
 	template<>
-	class ReturnInstruction<JumpCondition::Always> : public Instruction{
-		using Instruction::Instruction;
+	class ReturnInstruction<JumpCondition::Always>{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 16;
 
-	protected:
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			cpu.jump_to(cpu.pop_from_stack());
-			return 16;
+			return cycles;
 		}
 	};
 	class ReturnInterruptInstruction : public ReturnInstruction<JumpCondition::Always>{
-		using ReturnInstruction<JumpCondition::Always>::ReturnInstruction;
-
-		uint8_t execute(CPU& cpu){
+	public:
+		static uint8_t execute(CPU& cpu){
 			if (CPU::debug_data){
 				fprintf(stdout, "Returning from Interrupt!\n");
 			}
@@ -143,83 +169,97 @@ namespace GB::Instructions{
 
 
 	template<typename PopInto>
-	class PopStackInstruction : public Instruction{
-		using Instruction::Instruction;
+	class PopStackInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 12;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			uint16_t value = cpu.pop_from_stack();
 			PopInto::store(cpu, value);
-			return 12;
+			return cycles;
 		}
 	};
 	template<typename PushFrom>
-	class PushStackInstruction : public Instruction{
-		using Instruction::Instruction;
+	class PushStackInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 16;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			cpu.push_to_stack(PushFrom::load(cpu));
-			return 16;
+			return cycles;
 		}
 	};
 
 	template<uint16_t address>
-	class CallRoutineInstruction : public Instruction{
-		using Instruction::Instruction;
+	class CallRoutineInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 16;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			cpu.push_to_stack(cpu.registers.pc);
 			cpu.jump_to(address);
-			return 16;
+			return cycles;
 		}
 	};
 	template<typename LocationSource, JumpCondition Condition = JumpCondition::Always>
 	class CallInstruction : public JumpInstructionBase<Condition>{
-		using JumpInstructionBase<Condition>::JumpInstructionBase;
+	public:
+		constexpr static uint8_t length = 1 + LocationSource::operand_bytes;
+		constexpr static uint8_t cycles = 8 + LocationSource::cycles;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			uint16_t location = LocationSource::load(cpu);
 			if (JumpInstructionBase<Condition>::should_jump(cpu)){
 				cpu.push_to_stack(cpu.registers.pc);
 				cpu.jump_to(location);
 				return 16 + LocationSource::cycles;
 			}else{
-				return 8 + LocationSource::cycles;
+				return cycles;
 			}
 		}
 	};
 
 	template<bool EnableInterrupts>
-	class SetInterruptsEnabledInstruction : public Instruction{
-		using Instruction::Instruction;
+	class SetInterruptsEnabledInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 4;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			if (EnableInterrupts){
 				cpu.interrupts.enable();
 			}else{
 				cpu.interrupts.disable();
 			}
-			return 4;
+			return cycles;
 		}
 	};
 
-	class ComplementCarryFlagInstruction : public Instruction{
-		using Instruction::Instruction;
+	class ComplementCarryFlagInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 4;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			cpu.set_flag(CPUFlag::Negative,  false);
 			cpu.set_flag(CPUFlag::Carry,     !cpu.is_flag_set(CPUFlag::Carry));
 			cpu.set_flag(CPUFlag::HalfCarry, false);
 		
-			return 4;
+			return cycles;
 		}
 	};
 
 
 	template<typename InType>
-	class BCDCorrectInstruction : public Instruction{
-		using Instruction::Instruction;
+	class BCDCorrectInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 4;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			uint8_t value = InType::load(cpu);
 			
 			int low_digit = (value & 0x0F);
@@ -251,11 +291,11 @@ namespace GB::Instructions{
 			
 			InType::store(cpu, static_cast<uint8_t>(result & 0xFF));
 
-			return 4;
+			return cycles;
 		}
 	};
 
-	uint16_t AddSigned8BitToValue(CPU& cpu, int add_to, unsigned int add_amount){
+	inline uint16_t AddSigned8BitToValue(CPU& cpu, int add_to, unsigned int add_amount){
 		if (add_amount & 0x80) add_amount |= -256;
 		uint32_t result = add_to + add_amount;
 
@@ -268,10 +308,12 @@ namespace GB::Instructions{
 		return result;
 	}
 	template<typename StoreSource, typename AddToSource, typename AddAmountSource>
-	class LDHLInstruction : public Instruction{
-		using Instruction::Instruction;
+	class LDHLInstruction{
+	public:
+		constexpr static uint8_t length = 1 + AddToSource::operand_bytes + AddAmountSource::operand_bytes;
+		constexpr static uint8_t cycles = 12;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			int add_to = AddToSource::load(cpu);
 			unsigned int add_amount = AddAmountSource::load(cpu);
 
@@ -280,13 +322,15 @@ namespace GB::Instructions{
 			StoreSource::store(cpu, result);
 			//AddToSource::store(cpu, result);
 			
-			return 12;
+			return cycles;
 		}
 	};
-	class AddSigned8BitImmediateToSPInstruction : public Instruction{
-		using Instruction::Instruction;
+	class AddSigned8BitImmediateToSPInstruction{
+	public:
+		constexpr static uint8_t length = 2;
+		constexpr static uint8_t cycles = 16;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			int add_to = Sources::RegisterSP::load(cpu);
 			unsigned int add_amount = Sources::Operand<uint8_t>::load(cpu);
 
@@ -294,19 +338,21 @@ namespace GB::Instructions{
 			
 			Sources::RegisterSP::store(cpu, result);
 
-			return 16;
+			return cycles;
 		}
 	};
 
 	template<bool CarryValue>
-	class SetCarryFlagInstruction : public Instruction{
-		using Instruction::Instruction;
+	class SetCarryFlagInstruction{
+	public:
+		constexpr static uint8_t length = 1;
+		constexpr static uint8_t cycles = 4;
 
-		uint8_t execute(CPU& cpu){
+		static uint8_t execute(CPU& cpu){
 			cpu.set_flag(CPUFlag::Carry, CarryValue);
 			cpu.set_flag(CPUFlag::Negative, false);
 			cpu.set_flag(CPUFlag::HalfCarry, false);
-			return 4;
+			return cycles;
 		}
 	};
 }
@@ -0,0 +1,132 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <string>
+#include <vector>
+
+// external/timer.h, which has the rdtsc timestamps. Not gb/timer.h, the GameBoy's timer.
+#include <timer.h>
+
+// Set by make INSTRUMENT=1
+#ifndef GB_INSTRUMENTATION
+#define GB_INSTRUMENTATION 0
+#endif
+
+namespace GB{
+	// Measures where the host's time goes, rather than the GameBoy's cycles (that's the Profiler).
+	// Scopes are placed around instruction dispatch, MMU and timer stepping, GPU::render_scanline and presenting a frame.
+	// Their time is added up per frame and put into a histogram for each section, and the scopes in a window of frames
+	// can also be written out as Chrome trace events (load the file in chrome://tracing or Perfetto).
+	// Without GB_INSTRUMENTATION every Scope is an empty object, so a normal build has no timing code at all.
+	class Instrumentation{
+	public:
+		constexpr static bool compiled_in = GB_INSTRUMENTATION;
+
+		enum class Section{
+			Dispatch, // Running the instruction handler or fused sequence, or a whole recompiled block including the stepping inside it
+			MMUStep,
+			TimerStep,
+			RenderScanline,
+			Present, // CPU::on_vblank, the frontend's work for a frame
+			Count
+		};
+		constexpr static int SECTION_COUNT = static_cast<int>(Section::Count);
+		// Power of two buckets of microseconds per frame: bucket 0 is under 1us, bucket n is from 2^(n-1) up to 2^n
+		constexpr static int HISTOGRAM_BUCKETS = 24;
+		// The trace stops recording (and says so) past this many scopes, a frame has tens of thousands of instructions
+		constexpr static size_t MAX_TRACE_EVENTS = 1 << 22;
+
+		// Times from its construction to the end of the enclosing block. instrumentation can be null.
+		template<bool Enabled>
+		class TimedScope{
+		public:
+			inline TimedScope(Instrumentation* instrumentation, Section section) : instrumentation(instrumentation), section(section){
+				if (instrumentation) start = SL_TIMER_CPU_CLOCKS;
+			}
+			inline ~TimedScope(){
+				if (instrumentation) instrumentation->record(section, start, SL_TIMER_CPU_CLOCKS);
+			}
+		protected:
+			Instrumentation* instrumentation;
+			Section section;
+			uint64_t start = 0;
+		};
+		using Scope = TimedScope<compiled_in>;
+
+		Instrumentation();
+
+		// Writes the Chrome trace to path once frames first to first + count - 1 (counting from 0) have finished
+		void trace_frames(const std::string& path, uint64_t first, uint64_t count);
+		// Called when the GameBoy finishes a frame
+		void end_frame();
+		void print_report(FILE* file);
+
+		inline void record(Section section, uint64_t start, uint64_t end){
+			SectionFrame& current = current_frame[static_cast<int>(section)];
+			current.clocks += end - start;
+			current.calls++;
+			if (tracing){
+				if (trace_events.size() < MAX_TRACE_EVENTS){
+					trace_events.push_back({section, start, end});
+				}else{
+					dropped_trace_events++;
+				}
+			}
+		}
+
+	protected:
+		struct SectionFrame{
+			uint64_t clocks = 0;
+			uint64_t calls = 0;
+		};
+		struct Histogram{
+			std::array<uint64_t, HISTOGRAM_BUCKETS> buckets = {};
+			double total_us = 0;
+			double max_us = 0;
+			uint64_t calls = 0;
+
+			void add(double us, uint64_t calls);
+			// The upper edge of the bucket the percentile falls in
+			double percentile_us(double percentile, uint64_t frames) const;
+		};
+		struct TraceEvent{
+			Section section;
+			uint64_t start;
+			uint64_t end;
+		};
+
+		static const char* section_name(int section);
+		double to_us(uint64_t clocks) const;
+		void write_trace();
+
+		// Measured against the steady clock when created, external/timer.h only has a fixed guess
+		double clocks_per_us;
+
+		std::array<SectionFrame, SECTION_COUNT> current_frame;
+		std::array<Histogram, SECTION_COUNT> histograms;
+		Histogram frame_histogram;
+		uint64_t frame_start;
+		uint64_t frames = 0;
+
+		std::string trace_path;
+		uint64_t trace_first_frame = 0;
+		uint64_t trace_frame_count = 0;
+		bool tracing = false;
+		uint64_t trace_start = 0;
+		std::vector<TraceEvent> trace_events;
+		// Whole frames, which are drawn around the scopes in the trace
+		std::vector<TraceEvent> trace_frame_events;
+		uint64_t dropped_trace_events = 0;
+	};
+
+	// Compiled out
+	template<>
+	class Instrumentation::TimedScope<false>{
+	public:
+		inline TimedScope(Instrumentation* instrumentation, Section section){}
+	};
+}
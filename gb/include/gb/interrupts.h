@@ -7,6 +7,7 @@
 
 namespace GB{
 	class CPU;
+	class SaveState;
 	
 	enum class Interrupt{
 		VBlank = 1 << 0,
@@ -43,6 +44,7 @@ namespace GB{
 		}
 
 		void reset();
+		void serialize(SaveState& state);
 
 		void find_next_interrupt();
 		inline const InterruptData* next_interrupt(){
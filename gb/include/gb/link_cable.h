@@ -0,0 +1,66 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+
+namespace GB{
+	// Connects the serial ports of two CPUs, which can be running on different threads.
+	// Each side only touches the cable when a transfer starts or finishes, so neither side is slowed down per instruction.
+	// The master sends its byte when the transfer starts, and picks up the reply when the transfer finishes.
+	class LinkCable{
+	public:
+		constexpr static int SIDE_COUNT = 2;
+
+		LinkCable() = default;
+		LinkCable(const LinkCable&) = delete;
+		LinkCable& operator=(const LinkCable&) = delete;
+
+		void connect(int side);
+		void disconnect(int side);
+		inline bool is_connected(int side){
+			return ends[side].connected.load(std::memory_order_acquire);
+		}
+
+		// Sends a byte to the other side. Each mailbox only holds one byte, and a new byte replaces an unread one.
+		inline void send_request(int from_side, uint8_t byte){
+			ends[other_side(from_side)].request.store(FULL | byte, std::memory_order_release);
+		}
+		inline void send_reply(int from_side, uint8_t byte){
+			ends[other_side(from_side)].reply.store(FULL | byte, std::memory_order_release);
+		}
+		// Returns false if there's nothing waiting for this side
+		inline bool take_request(int side, uint8_t& byte){
+			return take(ends[side].request, byte);
+		}
+		inline bool take_reply(int side, uint8_t& byte){
+			return take(ends[side].reply, byte);
+		}
+
+		constexpr static int other_side(int side){
+			return 1 - side;
+		}
+	protected:
+		// A mailbox holds FULL | byte when there's a byte waiting, or 0 when it's empty
+		constexpr static uint16_t FULL = 0x100;
+
+		struct End{
+			// Bytes travelling to this end of the cable
+			std::atomic<uint16_t> request{0};
+			std::atomic<uint16_t> reply{0};
+			std::atomic<bool> connected{false};
+		};
+		std::array<End, SIDE_COUNT> ends;
+
+		inline static bool take(std::atomic<uint16_t>& mailbox, uint8_t& byte){
+			// Checking first keeps the common case (nothing there) to a single load
+			if (mailbox.load(std::memory_order_relaxed) == 0) return false;
+			uint16_t value = mailbox.exchange(0, std::memory_order_acquire);
+			if (value == 0) return false;
+			byte = static_cast<uint8_t>(value & 0xFF);
+			return true;
+		}
+	};
+}
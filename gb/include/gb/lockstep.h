@@ -0,0 +1,64 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <array>
+#include <vector>
+
+namespace GB{
+	class CPU;
+
+	// Experimental. Runs up to MAX_INSTANCES CPUs (usually with the same ROM) side by side.
+	// Each round, every CPU runs through CPU::step() until it reaches an instruction that only touches registers
+	// (LD r,r, the 8-bit ALU ops on registers, INC/DEC r, CPL, NOP). Then the CPUs waiting at the same PC are decoded once,
+	// and the instruction runs for all of them together on a structure-of-arrays copy of their registers,
+	// one array per register with a lane per CPU, as a loop over the lanes that the compiler can turn into SIMD.
+	// Interrupts, HALT, OAM DMA, the BIOS, fused sequences and CPUs running with --debug or --profile always go through step().
+	// The rest of each CPU (memory, GPU, timers) is still stepped per instance, so only decode and dispatch are shared.
+	class Lockstep{
+	public:
+		constexpr static int MAX_INSTANCES = 16;
+		// Runs every lane kernel against the normal handler as well, and stops the CPU if they disagree
+		bool verify_kernels = false;
+
+		// The CPUs must outlive the Lockstep
+		Lockstep(std::vector<CPU*> cpus);
+
+		// Runs every CPU for at least cycles more cycles (or until it stops)
+		void run(unsigned int cycles);
+
+		// Instructions run by the lane kernels, and steps through CPU::step() (a fused sequence counts as one)
+		uint64_t vector_instructions = 0;
+		uint64_t scalar_instructions = 0;
+
+	protected:
+		using LaneMask = std::array<uint8_t, MAX_INSTANCES>; // 0xFF for the lanes an operation applies to, 0 for the rest
+
+		// Registers in the order the opcodes encode them: B, C, D, E, H, L, (HL), A.
+		// (HL) is never used by a lane kernel, so F goes in its slot.
+		constexpr static int REGISTER_F = 6;
+		constexpr static int REGISTER_A = 7;
+
+		// Copy a CPU's registers into its lane, and back
+		void gather(int lane);
+		void scatter(int lane);
+
+		void run_round(const LaneMask& active, const std::array<unsigned int, MAX_INSTANCES>& start_cycles, unsigned int cycles);
+		// Returns false if the opcode has no lane kernel
+		static bool has_kernel(uint8_t opcode);
+		void run_kernel(uint8_t opcode, const LaneMask& mask);
+		void check_kernel(uint8_t opcode, const LaneMask& mask);
+
+		template<typename Operation>
+		void run_alu(int source, const LaneMask& mask);
+		template<typename Operation>
+		void run_unary(int target, const LaneMask& mask);
+
+		std::vector<CPU*> cpus;
+		LaneMask steps_every_instruction = {};
+		alignas(32) std::array<std::array<uint8_t, MAX_INSTANCES>, 8> registers;
+		alignas(32) std::array<uint16_t, MAX_INSTANCES> sp;
+		alignas(32) std::array<uint16_t, MAX_INSTANCES> pc;
+	};
+}
@@ -6,6 +6,8 @@
 #include <assert.h>
 
 namespace GB{
+	class SaveState;
+
 	class MBC{
 	public:
 		MBC(std::vector<uint8_t> rom_data, uint8_t rom_bank_count, uint8_t ram_bank_count);
@@ -18,8 +20,14 @@ namespace GB{
 			return 0xFF;
 		};
 		virtual void write_ram_byte(uint16_t relative_address, uint8_t byte){}; 
+		// The ROM bank mapped to 0x4000-0x7FFF
+		virtual uint8_t current_rom_bank(){
+			return 1;
+		}
 
 		virtual void reset(){}
+		// Saves or loads the RAM banks. Overrides add the bank registers.
+		virtual void serialize(SaveState& state);
 
 		std::vector<std::array<uint8_t, 0x4000>> rom_banks;
 		std::vector<std::array<uint8_t, 0x2000>> ram_banks;
@@ -35,7 +43,11 @@ namespace GB{
 		}
 		uint8_t read_ram_byte(uint16_t relative_address) override;
 		void write_ram_byte(uint16_t relative_address, uint8_t byte) override; 
+		uint8_t current_rom_bank() override{
+			return selected_rom_bank;
+		}
 		void reset() override;
+		void serialize(SaveState& state) override;
 
 	private:
 		bool enabled_ram;
@@ -70,7 +82,11 @@ namespace GB{
 		}
 		uint8_t read_ram_byte(uint16_t relative_address) override;
 		void write_ram_byte(uint16_t relative_address, uint8_t byte) override; 
+		uint8_t current_rom_bank() override{
+			return selected_rom_bank;
+		}
 		void reset() override;
+		void serialize(SaveState& state) override;
 
 	private:
 		bool ram_or_rtc_enabled;
@@ -10,11 +10,15 @@
 
 namespace GB{
 	class CPU;
+	class SaveState;
 
 	class MMU{
 	public:
 		constexpr static uint16_t BIOS_SIZE = 0x100;
 
+		constexpr static uint16_t SERIAL_DATA_ADDRESS = 0xFF01;
+		constexpr static uint16_t SERIAL_CONTROL_ADDRESS = 0xFF02;
+
 		constexpr static uint16_t TIMER_DIVIDER_ADDRESS = 0xFF04;
 		constexpr static uint16_t TIMER_COUNTER_ADDRESS = 0xFF05;
 		constexpr static uint16_t TIMER_MODULO_ADDRESS = 0xFF06;
@@ -59,6 +63,7 @@ namespace GB{
 
 		void step();
 		void reset();
+		void serialize(SaveState& state);
 	
 		void write_byte(uint16_t address, uint8_t byte);
 		void write_word(uint16_t address, uint16_t word);
@@ -66,6 +71,13 @@ namespace GB{
 		uint8_t read_byte(uint16_t address);
 		uint16_t read_word(uint16_t address);
 
+		// VRAM, work RAM (and its mirror), sprite info and HRAM are plain bytes, which can be read without side effects.
+		// The ROM, cartridge RAM and the IO registers (including the enabled interrupts at 0xFFFF) aren't.
+		static bool is_plain_ram(uint16_t address);
+		// The byte backing a plain RAM address, read or written directly rather than through read_byte/write_byte, so it's safe to use
+		// from outside of the CPU's instructions (e.g. to export memory) even during an OAM DMA. Returns nullptr for any other address.
+		uint8_t* map_plain_ram(uint16_t address);
+
 		constexpr static int OAM_DMA_LENGTH = 160; // 671 cycles
 		int dma_timer = -1;
 	protected:
@@ -0,0 +1,60 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace GB{
+	// Counts instructions and cycles for each (ROM bank, PC) and for each opcode.
+	// Only created if the CPU was constructed with profiling enabled,
+	// otherwise the CPU uses a step policy that never touches it.
+	class Profiler{
+	public:
+		struct Counter{
+			uint64_t instructions = 0;
+			uint64_t cycles = 0;
+			// The last opcode seen at this location, used for disassembly
+			uint8_t opcode = 0;
+			uint8_t cb_opcode = 0;
+		};
+
+		// Opcodes 0x00-0xFF are normal instructions, 0x100-0x1FF are CB instructions
+		constexpr static int OPCODE_COUNT = 512;
+
+		Profiler();
+
+		void begin_instruction(uint8_t rom_bank, uint16_t pc, uint8_t opcode, uint8_t cb_opcode);
+		inline void end_instruction(uint8_t cycles){
+			if (current_location == nullptr) return;
+
+			current_location->instructions++;
+			current_location->cycles += cycles;
+			current_opcode->instructions++;
+			current_opcode->cycles += cycles;
+			total_instructions++;
+			total_cycles += cycles;
+
+			current_location = nullptr;
+		}
+
+		void reset();
+		void print_report(FILE* file, size_t max_locations = 40, size_t max_opcodes = 20);
+
+	protected:
+		// The PC of the bank-switched area (0x4000 to 0x7FFF) means nothing without the bank,
+		// so those are stored per bank and everything else is indexed directly by PC.
+		std::array<Counter, 0x10000> unbanked;
+		std::vector<std::unique_ptr<std::array<Counter, 0x4000>>> banked;
+		std::array<Counter, OPCODE_COUNT> opcodes;
+
+		Counter* current_location = nullptr;
+		Counter* current_opcode = nullptr;
+
+		uint64_t total_instructions = 0;
+		uint64_t total_cycles = 0;
+	};
+}
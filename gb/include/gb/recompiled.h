@@ -0,0 +1,62 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace GB{
+	class CPU;
+
+	// A basic block of ROM code, recompiled ahead of time by tools/recompiler.cpp.
+	// It runs from its start address until it reaches a jump, call or return,
+	// or until CPU::finish_recompiled_instruction() says step() needs control back.
+	using RecompiledBlock = void (*)(CPU& cpu);
+
+	struct RecompiledBlockEntry{
+		uint8_t rom_bank; // Always 0 below 0x4000
+		uint16_t pc;
+		RecompiledBlock block;
+	};
+
+	// What a plugin built from the recompiler's output exports, under RECOMPILED_ROM_SYMBOL
+	struct RecompiledRom{
+		uint32_t version;
+		// Both copied from the ROM header, to check the plugin was made from the ROM being run
+		char rom_name[17];
+		uint16_t global_checksum;
+		const RecompiledBlockEntry* blocks;
+		size_t block_count;
+	};
+	constexpr uint32_t RECOMPILED_ROM_VERSION = 1;
+	constexpr const char* RECOMPILED_ROM_SYMBOL = "gb_recompiled_rom";
+
+	// The blocks from one plugin, indexed by ROM bank and PC so looking one up is a couple of array reads
+	class RecompiledBlocks{
+	public:
+		// Returns nullptr, after printing why, if the plugin can't be loaded or was made from a different ROM
+		static std::unique_ptr<RecompiledBlocks> load(const char* path, const std::vector<std::array<uint8_t, 0x4000>>& rom_banks);
+		~RecompiledBlocks();
+
+		inline RecompiledBlock find(uint8_t rom_bank, uint16_t pc){
+			if (pc < 0x4000) return bank_zero[pc];
+			if (pc >= 0x8000 || rom_bank >= banked.size() || !banked[rom_bank]) return nullptr;
+			return (*banked[rom_bank])[pc - 0x4000];
+		}
+		inline size_t block_count(){
+			return count;
+		}
+
+	protected:
+		RecompiledBlocks() = default;
+
+		void* handle = nullptr;
+		size_t count = 0;
+		std::array<RecompiledBlock, 0x4000> bank_zero = {};
+		// Only allocated for banks that have blocks
+		std::vector<std::unique_ptr<std::array<RecompiledBlock, 0x4000>>> banked;
+	};
+}
@@ -0,0 +1,90 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gb/audio_sink.h"
+#include "gb/gpu.h"
+#include "gb/ring_buffer.h"
+
+namespace GB{
+	// Records what the GameBoy shows and plays, as Y4M video (greyscale, at the GameBoy's ~59.73 frames per second)
+	// and 16-bit stereo WAV. The emulation thread only copies each frame and its audio into a slot from a fixed pool
+	// and queues it, and a background thread converts and writes them out.
+	// Either file can be left out. Audio arrives by making the Recorder the APU's sink, which can pass it on to another sink.
+	class Recorder : public AudioSink{
+	public:
+		enum class Policy{
+			// When every slot is waiting to be written, the new frame and its audio are dropped together, so the two stay in sync.
+			// The emulation thread never waits.
+			DropFrames,
+			// Wait for the writer instead, so nothing is lost and a run without a frame limit goes as fast as the disk
+			Block
+		};
+
+		// About a second of frames
+		constexpr static size_t QUEUE_FRAMES = 64;
+
+		// Returns nullptr if a file can't be opened. Either path can be null to only record the other.
+		static std::unique_ptr<Recorder> create(const char* video_path, const char* audio_path, Policy policy);
+		// Writes everything still queued, finishes the files and reports how many frames were dropped
+		~Recorder();
+
+		Recorder(const Recorder&) = delete;
+		Recorder& operator=(const Recorder&) = delete;
+
+		// Call once per frame, from on_vblank
+		void capture_frame(const GPU& gpu);
+		// From the APU, on the emulation thread
+		void write_frames(const AudioFrame* frames, size_t count) override;
+		// Also sends the audio to next, which must outlive the Recorder or be cleared first
+		inline void forward_audio_to(AudioSink* next){
+			next_sink = next;
+		}
+
+	protected:
+		struct Slot{
+			std::array<GPU::Pixel, GPU::SCREEN_WIDTH * GPU::SCREEN_HEIGHT> framebuffer;
+			// The audio played since the previous frame
+			std::vector<AudioFrame> audio;
+		};
+
+		Recorder(Policy policy);
+
+		void run_writer();
+		void write_slot(Slot& slot);
+		void write_audio(const std::vector<AudioFrame>& audio);
+		void write_wav_header(uint32_t data_size);
+
+		Policy policy;
+		FILE* video = nullptr;
+		FILE* audio = nullptr;
+		uint64_t audio_bytes = 0;
+
+		std::vector<std::unique_ptr<Slot>> slots;
+		// Slots go round from free to queued (filled by the emulation thread) and back again (once written)
+		SPSCRingBuffer<Slot*, QUEUE_FRAMES> free_slots;
+		SPSCRingBuffer<Slot*, QUEUE_FRAMES> queued_slots;
+		std::vector<AudioFrame> pending_audio;
+		AudioSink* next_sink = nullptr;
+
+		std::thread writer;
+		std::atomic<bool> finishing{false};
+		// The writer sleeps on these when the queue is empty. The emulation thread only notifies, it never takes the lock.
+		std::mutex writer_mutex;
+		std::condition_variable writer_wakeup;
+
+		uint64_t frames_captured = 0;
+		uint64_t frames_dropped = 0;
+		std::atomic<uint64_t> frames_written{0};
+	};
+}
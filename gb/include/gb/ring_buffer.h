@@ -0,0 +1,55 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <atomic>
+
+namespace GB{
+	// A lock-free ring buffer for exactly one producer thread and one consumer thread.
+	// Neither side ever waits: push() drops what doesn't fit, and pop() returns what's there.
+	template<typename T, size_t Capacity>
+	class SPSCRingBuffer{
+		static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "SPSCRingBuffer capacity must be a power of two");
+	public:
+		// Producer only. Returns how many values were written.
+		size_t push(const T* values, size_t count){
+			const size_t write = write_index.load(std::memory_order_relaxed);
+			const size_t read = read_index.load(std::memory_order_acquire);
+			const size_t space = Capacity - (write - read);
+			if (count > space) count = space;
+			for (size_t i = 0; i < count; i++){
+				data[(write + i) & (Capacity - 1)] = values[i];
+			}
+			write_index.store(write + count, std::memory_order_release);
+			return count;
+		}
+		// Consumer only. Returns how many values were read.
+		size_t pop(T* values, size_t count){
+			const size_t read = read_index.load(std::memory_order_relaxed);
+			const size_t write = write_index.load(std::memory_order_acquire);
+			const size_t available = write - read;
+			if (count > available) count = available;
+			for (size_t i = 0; i < count; i++){
+				values[i] = data[(read + i) & (Capacity - 1)];
+			}
+			read_index.store(read + count, std::memory_order_release);
+			return count;
+		}
+		// Only exact when called from one of the two threads while the other is idle
+		inline size_t size() const{
+			return write_index.load(std::memory_order_acquire) - read_index.load(std::memory_order_acquire);
+		}
+		constexpr static size_t capacity(){
+			return Capacity;
+		}
+
+	protected:
+		std::array<T, Capacity> data;
+		// Both indices only ever increase, and are wrapped when indexing into data.
+		// They're kept on separate cache lines so the two threads don't fight over one.
+		alignas(64) std::atomic<size_t> write_index{0};
+		alignas(64) std::atomic<size_t> read_index{0};
+	};
+}
@@ -8,6 +8,7 @@
 namespace GB::RomData{
 	constexpr static uint16_t ROM_OFFSET_NAME = 0x134;
 	constexpr static uint16_t ROM_OFFSET_TYPE = 0x147;
+	constexpr static uint16_t ROM_OFFSET_GLOBAL_CHECKSUM = 0x14E; // Big endian
 	
 	constexpr static uint16_t ROM_OFFSET_ROM_SIZE = 0x148;
 	const static std::unordered_map<uint8_t, uint16_t> ROM_SIZE_TO_BANK_COUNT{
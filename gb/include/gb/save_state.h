@@ -0,0 +1,57 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace GB{
+	// Each component has one serialize() that both saves and loads, by passing its members to value() in the same order.
+	// That way saving and loading can't drift apart when a member is added.
+	class SaveState{
+	public:
+		// Starts an empty state to save into
+		SaveState() : loading(false) {}
+		// Loads from a copy of data
+		SaveState(const std::vector<uint8_t>& data) : loading(true), buffer(data) {}
+
+		template<typename T>
+		inline void value(T& member){
+			static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be copied in and out of a state");
+			bytes(&member, sizeof(T));
+		}
+		inline void bytes(void* member, size_t size){
+			if (loading){
+				if (position + size > buffer.size()){
+					failed = true;
+					return;
+				}
+				memcpy(member, buffer.data() + position, size);
+			}else{
+				buffer.resize(position + size);
+				memcpy(buffer.data() + position, member, size);
+			}
+			position += size;
+		}
+
+		inline bool is_loading() const{
+			return loading;
+		}
+		// True if a load ran out of data
+		inline bool has_failed() const{
+			return failed;
+		}
+		inline const std::vector<uint8_t>& data() const{
+			return buffer;
+		}
+
+	protected:
+		bool loading;
+		bool failed = false;
+		size_t position = 0;
+		std::vector<uint8_t> buffer;
+	};
+}
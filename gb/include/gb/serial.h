@@ -0,0 +1,56 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+
+namespace GB{
+	class CPU;
+	class SaveState;
+	class LinkCable;
+
+	// The serial port at 0xFF01 (data) and 0xFF02 (control).
+	// With no cable connected, transfers using the internal clock shift in 0xFF, and transfers using the external clock never finish.
+	class Serial{
+	public:
+		constexpr static int TRANSFER_CYCLES = 4096; // 8 bits at 8192Hz
+		constexpr static int CABLE_POLL_CYCLES = 456; // How often an idle port answers the other side, one scanline
+
+		Serial(CPU& cpu) : cpu(cpu) {}
+
+		void step();
+		void reset();
+		void serialize(SaveState& state);
+
+		void connect(LinkCable& new_cable, int new_side);
+		void disconnect();
+
+		inline uint8_t read_data(){
+			return data;
+		}
+		inline void write_data(uint8_t new_value){
+			data = new_value;
+		}
+		inline uint8_t read_control(){
+			return 0x7E | (transfer_requested << 7) | (internal_clock << 0);
+		}
+		void write_control(uint8_t new_value);
+
+	protected:
+		void finish_transfer(uint8_t received);
+		void answer_request();
+		uint8_t wait_for_reply();
+
+		uint8_t data;
+		bool transfer_requested;
+		bool internal_clock;
+
+		int transfer_cycles_left;
+		int poll_cycles_left;
+
+		LinkCable* cable = nullptr;
+		int side = 0;
+
+		CPU& cpu;
+	};
+}
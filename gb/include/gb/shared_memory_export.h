@@ -0,0 +1,125 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <string>
+
+#include "gb/gpu.h"
+
+namespace GB{
+	class CPU;
+
+	// Everything in the shared memory segment is laid out as these structs, so other processes can map it directly.
+	// The segment is a Header followed by SLOT_COUNT slots of slot_size bytes each.
+	// Each slot is a Slot, then the framebuffer (one shade byte per pixel, 0 is white and 3 is black),
+	// then the RAM regions in the order they're listed in the header.
+	namespace SharedExportLayout{
+		constexpr static uint32_t MAGIC = 0x47424653; // "GBFS"
+		constexpr static uint32_t VERSION = 1;
+		constexpr static int SLOT_COUNT = 3;
+		constexpr static int MAX_RAM_REGIONS = 16;
+		constexpr static size_t FRAMEBUFFER_SIZE = GPU::SCREEN_WIDTH * GPU::SCREEN_HEIGHT;
+
+		static_assert(std::atomic<uint64_t>::is_always_lock_free, "The sequence counters have to work across processes");
+
+		struct RamRegion{
+			uint16_t start;
+			uint16_t length;
+			// Offset of the region from the start of a slot
+			uint32_t slot_offset;
+		};
+
+		struct alignas(64) Header{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t slot_count;
+			uint32_t slot_size;
+			uint32_t width;
+			uint32_t height;
+			uint32_t ram_region_count;
+			RamRegion ram_regions[MAX_RAM_REGIONS];
+			// The slot holding the newest complete frame, or -1 before the first frame
+			std::atomic<int32_t> latest_slot;
+		};
+
+		struct alignas(64) Slot{
+			// Odd while the slot is being written. Readers check it's even and unchanged after copying out.
+			std::atomic<uint64_t> sequence;
+			uint64_t frame_number;
+		};
+	}
+
+	// Publishes each frame and some RAM windows into a POSIX shared memory segment, for tools in other processes.
+	// There are three slots and the emulator writes to one the readers aren't pointed at, so it never waits for a reader,
+	// and a reader only has to retry if it takes more than a frame to copy one out.
+	class SharedMemoryExport{
+	public:
+		struct RamWindow{
+			uint16_t start;
+			uint16_t length;
+		};
+
+		// name is passed to shm_open(), so it should start with a '/'. Returns nullptr if the segment can't be created.
+		static std::unique_ptr<SharedMemoryExport> create(const char* name, const std::vector<RamWindow>& windows);
+		~SharedMemoryExport();
+
+		SharedMemoryExport(const SharedMemoryExport&) = delete;
+		SharedMemoryExport& operator=(const SharedMemoryExport&) = delete;
+
+		// Call once per frame, from on_vblank
+		void publish(CPU& cpu);
+
+		// Parses "start:length" in hex, such as "C000:2000". The window has to be plain RAM (see MMU::is_plain_ram),
+		// so publishing it is only a copy.
+		static bool parse_window(const char* text, RamWindow& window);
+	protected:
+		SharedMemoryExport() = default;
+
+		static bool is_plain_ram(const RamWindow& window);
+
+		inline SharedExportLayout::Slot* slot(int index){
+			return reinterpret_cast<SharedExportLayout::Slot*>(data + sizeof(SharedExportLayout::Header) + index * header->slot_size);
+		}
+
+		std::string name;
+		uint8_t* data = nullptr;
+		size_t size = 0;
+		SharedExportLayout::Header* header = nullptr;
+		uint64_t frame_number = 0;
+	};
+
+	// The other end, for a process that wants to read frames out of the segment
+	class SharedMemoryReader{
+	public:
+		// Returns nullptr if the segment doesn't exist or wasn't made by a compatible emulator
+		static std::unique_ptr<SharedMemoryReader> open(const char* name);
+		~SharedMemoryReader();
+
+		SharedMemoryReader(const SharedMemoryReader&) = delete;
+		SharedMemoryReader& operator=(const SharedMemoryReader&) = delete;
+
+		// Copies the newest frame into framebuffer (FRAMEBUFFER_SIZE bytes) and ram (ram_size() bytes).
+		// Returns the frame number, or 0 if there hasn't been a frame yet.
+		uint64_t read_latest(uint8_t* framebuffer, uint8_t* ram);
+
+		inline const SharedExportLayout::Header& layout() const{
+			return *header;
+		}
+		size_t ram_size() const;
+	protected:
+		SharedMemoryReader() = default;
+
+		inline const SharedExportLayout::Slot* slot(int index) const{
+			return reinterpret_cast<const SharedExportLayout::Slot*>(data + sizeof(SharedExportLayout::Header) + index * header->slot_size);
+		}
+
+		uint8_t* data = nullptr;
+		size_t size = 0;
+		const SharedExportLayout::Header* header = nullptr;
+	};
+}
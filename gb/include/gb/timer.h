@@ -6,6 +6,7 @@
 namespace GB{
 
 	class CPU;
+	class SaveState;
 	
 	class Timer{
 	public:
@@ -13,6 +14,7 @@ namespace GB{
 		
 		void step();
 		void reset();
+		void serialize(SaveState& state);
 		
 		void reset_divider();
 		void write_counter(uint8_t new_value);
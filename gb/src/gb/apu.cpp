@@ -0,0 +1,377 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/apu.h"
+#include "gb/cpu.h"
+#include "gb/save_state.h"
+
+#include <algorithm>
+
+namespace GB{
+	namespace{
+		NullAudioSink null_sink;
+
+		constexpr uint8_t duty_patterns[4] = {
+			0b00000001, // 12.5%
+			0b10000001, // 25%
+			0b10000111, // 50%
+			0b01111110, // 75%
+		};
+		// Bits that always read back as 1, from 0xFF10 to 0xFF2F. Wave RAM reads back as written.
+		constexpr uint8_t read_masks[0x20] = {
+			0x80, 0x3F, 0x00, 0xFF, 0xBF,
+			0xFF, 0x3F, 0x00, 0xFF, 0xBF,
+			0x7F, 0xFF, 0x9F, 0xFF, 0xBF,
+			0xFF, 0xFF, 0x00, 0x00, 0xBF,
+			0x00, 0x00, 0x70,
+			0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF
+		};
+		// Volume 15 on every channel, both sides, and the loudest master volume
+		constexpr float GAIN = 32767.0f / (15 * 4 * 8) * 0.9f;
+	}
+
+	APU::APU(CPU& cpu) : cpu(cpu), sink(&null_sink), left(CLOCK_RATE, SAMPLE_RATE, SAMPLE_RATE / 20), right(CLOCK_RATE, SAMPLE_RATE, SAMPLE_RATE / 20){
+		frames.resize(SAMPLE_RATE / 20);
+	}
+
+	void APU::reset(){
+		// The state the BIOS leaves the APU in, with all of the channels finished
+		registers.fill(0);
+		reg(NR10) = 0x80;
+		reg(channel_register(Square1, 1)) = 0xBF;
+		reg(channel_register(Square1, 2)) = 0xF3;
+		reg(channel_register(Square1, 4)) = 0xBF;
+		reg(channel_register(Square2, 1)) = 0x3F;
+		reg(channel_register(Square2, 4)) = 0xBF;
+		reg(NR30) = 0x7F;
+		reg(channel_register(Wave, 1)) = 0xFF;
+		reg(channel_register(Wave, 2)) = 0x9F;
+		reg(channel_register(Wave, 4)) = 0xBF;
+		reg(channel_register(Noise, 1)) = 0xFF;
+		reg(channel_register(Noise, 4)) = 0xBF;
+		reg(NR50) = 0x77;
+		reg(NR51) = 0xF3;
+		powered = true;
+
+		for (Channel& channel : channels){
+			channel = Channel{};
+			channel.lfsr = 0x7FFF;
+		}
+		frame_sequencer_step = 0;
+		batch_cycles = 0;
+		pending_cycles = 0;
+		next_frame_sequencer = FRAME_SEQUENCER_CYCLES;
+		left.clear();
+		right.clear();
+	}
+
+	void APU::serialize(SaveState& state){
+		state.value(registers);
+		state.value(channels);
+		state.value(powered);
+		state.value(frame_sequencer_step);
+		state.value(batch_cycles);
+		state.value(pending_cycles);
+		state.value(next_frame_sequencer);
+		if (state.is_loading()){
+			// Samples already made for the old state are dropped, and the channels start their output again from silence
+			left.clear();
+			right.clear();
+			for (Channel& channel : channels){
+				channel.left_amplitude = 0;
+				channel.right_amplitude = 0;
+			}
+		}
+	}
+
+	void APU::end_batch(){
+		catch_up();
+
+		left.end_frame(batch_cycles);
+		right.end_frame(batch_cycles);
+		next_frame_sequencer -= batch_cycles;
+		batch_cycles = 0;
+
+		const size_t count = std::min(left.samples_available(), frames.size());
+		left.read_samples(&frames[0].left, count, 2, GAIN);
+		right.read_samples(&frames[0].right, count, 2, GAIN);
+		sink->write_frames(frames.data(), count);
+	}
+
+	void APU::catch_up(){
+		const uint32_t end = batch_cycles + pending_cycles;
+		pending_cycles = 0;
+		while (batch_cycles < end){
+			const uint32_t segment_end = std::min(end, next_frame_sequencer);
+			if (powered){
+				for (int index = 0; index < ChannelCount; index++){
+					run_channel(index, batch_cycles, segment_end);
+				}
+			}
+			batch_cycles = segment_end;
+			if (batch_cycles == next_frame_sequencer){
+				if (powered) clock_frame_sequencer();
+				next_frame_sequencer += FRAME_SEQUENCER_CYCLES;
+			}
+		}
+	}
+
+	void APU::run_channel(int index, uint32_t from, uint32_t to){
+		Channel& channel = channels[index];
+		if (!channel.enabled) return;
+
+		// Only stop at the points where the waveform moves
+		const uint32_t channel_period = period(index);
+		uint32_t time = from + channel.timer;
+		while (time < to){
+			switch(index){
+			case Square1:
+			case Square2:
+				channel.duty_position = (channel.duty_position + 1) & 7;
+				break;
+			case Wave:
+				channel.wave_position = (channel.wave_position + 1) & 31;
+				break;
+			case Noise:{
+				const uint16_t feedback = (channel.lfsr ^ (channel.lfsr >> 1)) & 1;
+				channel.lfsr = (channel.lfsr >> 1) | (feedback << 14);
+				if (reg(channel_register(Noise, 3)) & 0x08){
+					channel.lfsr = (channel.lfsr & ~0x40) | (feedback << 6);
+				}
+				break;
+			}
+			}
+			update_output(index, time);
+			time += channel_period;
+		}
+		channel.timer = time - to;
+	}
+
+	void APU::clock_frame_sequencer(){
+		const uint32_t time = batch_cycles;
+
+		// Length counters on every other step
+		if ((frame_sequencer_step & 1) == 0){
+			for (int index = 0; index < ChannelCount; index++){
+				Channel& channel = channels[index];
+				const bool length_enabled = reg(channel_register(index, 4)) & 0x40;
+				if (length_enabled && channel.length_counter > 0){
+					channel.length_counter--;
+					if (channel.length_counter == 0){
+						channel.enabled = false;
+						update_output(index, time);
+					}
+				}
+			}
+		}
+
+		// Sweep on steps 2 and 6
+		if (frame_sequencer_step == 2 || frame_sequencer_step == 6){
+			Channel& channel = channels[Square1];
+			const int sweep_period = (reg(NR10) >> 4) & 0x7;
+			if (--channel.sweep_timer <= 0){
+				channel.sweep_timer = sweep_period ? sweep_period : 8;
+				if (channel.sweep_enabled && sweep_period){
+					const uint16_t new_frequency = calculate_sweep();
+					const int shift = reg(NR10) & 0x7;
+					if (new_frequency <= 2047 && shift){
+						channel.sweep_shadow = new_frequency;
+						reg(channel_register(Square1, 3)) = new_frequency & 0xFF;
+						reg(channel_register(Square1, 4)) = (reg(channel_register(Square1, 4)) & ~0x7) | (new_frequency >> 8);
+						// Checked again straight away, and this one can only turn the channel off
+						calculate_sweep();
+					}
+					update_output(Square1, time);
+				}
+			}
+		}
+
+		// Envelopes on step 7
+		if (frame_sequencer_step == 7){
+			for (int index : {Square1, Square2, Noise}){
+				Channel& channel = channels[index];
+				const uint8_t envelope = reg(channel_register(index, 2));
+				const int envelope_period = envelope & 0x7;
+				if (envelope_period == 0) continue;
+				if (--channel.envelope_timer <= 0){
+					channel.envelope_timer = envelope_period;
+					if ((envelope & 0x08) && channel.volume < 15){
+						channel.volume++;
+					}else if (!(envelope & 0x08) && channel.volume > 0){
+						channel.volume--;
+					}
+					update_output(index, time);
+				}
+			}
+		}
+
+		frame_sequencer_step = (frame_sequencer_step + 1) & 7;
+	}
+
+	void APU::update_output(int index, uint32_t time){
+		Channel& channel = channels[index];
+		const int sample = current_sample(index);
+		const uint8_t panning = reg(NR51);
+		const int left_amplitude = (panning & (0x10 << index)) ? sample * (((reg(NR50) >> 4) & 0x7) + 1) : 0;
+		const int right_amplitude = (panning & (0x01 << index)) ? sample * ((reg(NR50) & 0x7) + 1) : 0;
+		if (left_amplitude != channel.left_amplitude){
+			left.add_delta(time, left_amplitude - channel.left_amplitude);
+			channel.left_amplitude = left_amplitude;
+		}
+		if (right_amplitude != channel.right_amplitude){
+			right.add_delta(time, right_amplitude - channel.right_amplitude);
+			channel.right_amplitude = right_amplitude;
+		}
+	}
+
+	int APU::current_sample(int index){
+		const Channel& channel = channels[index];
+		if (!channel.enabled || !dac_enabled(index)) return 0;
+
+		switch(index){
+		case Square1:
+		case Square2:{
+			const int duty = reg(channel_register(index, 1)) >> 6;
+			return ((duty_patterns[duty] >> channel.duty_position) & 1) ? channel.volume : 0;
+		}
+		case Wave:{
+			const uint8_t wave_byte = reg(WAVE_RAM + channel.wave_position / 2);
+			const uint8_t wave_sample = (channel.wave_position & 1) ? (wave_byte & 0xF) : (wave_byte >> 4);
+			const int volume_code = (reg(channel_register(Wave, 2)) >> 5) & 0x3;
+			return volume_code ? (wave_sample >> (volume_code - 1)) : 0;
+		}
+		case Noise:
+			return (channel.lfsr & 1) ? 0 : channel.volume;
+		}
+		return 0;
+	}
+
+	bool APU::dac_enabled(int index){
+		if (index == Wave) return reg(NR30) & 0x80;
+		return reg(channel_register(index, 2)) & 0xF8;
+	}
+
+	uint16_t APU::frequency(int index){
+		return ((reg(channel_register(index, 4)) & 0x7) << 8) | reg(channel_register(index, 3));
+	}
+
+	uint32_t APU::period(int index){
+		switch(index){
+		case Square1:
+		case Square2:
+			return (2048 - frequency(index)) * 4;
+		case Wave:
+			return (2048 - frequency(index)) * 2;
+		case Noise:{
+			const uint8_t polynomial = reg(channel_register(Noise, 3));
+			const uint32_t divisor_code = polynomial & 0x7;
+			const uint32_t divisor = divisor_code ? (divisor_code * 16) : 8;
+			return divisor << (polynomial >> 4);
+		}
+		}
+		return 1;
+	}
+
+	uint16_t APU::calculate_sweep(){
+		Channel& channel = channels[Square1];
+		const uint16_t delta = channel.sweep_shadow >> (reg(NR10) & 0x7);
+		const uint16_t new_frequency = (reg(NR10) & 0x08) ? (channel.sweep_shadow - delta) : (channel.sweep_shadow + delta);
+		if (new_frequency > 2047){
+			channel.enabled = false;
+		}
+		return new_frequency;
+	}
+
+	void APU::trigger(int index){
+		Channel& channel = channels[index];
+		channel.enabled = dac_enabled(index);
+		if (channel.length_counter == 0){
+			channel.length_counter = (index == Wave) ? 256 : 64;
+		}
+		channel.timer = period(index);
+		channel.volume = reg(channel_register(index, 2)) >> 4;
+		channel.envelope_timer = reg(channel_register(index, 2)) & 0x7;
+		channel.wave_position = 0;
+		channel.lfsr = 0x7FFF;
+
+		if (index == Square1){
+			const int sweep_period = (reg(NR10) >> 4) & 0x7;
+			const int shift = reg(NR10) & 0x7;
+			channel.sweep_shadow = frequency(Square1);
+			channel.sweep_timer = sweep_period ? sweep_period : 8;
+			channel.sweep_enabled = sweep_period || shift;
+			if (shift) calculate_sweep();
+		}
+	}
+
+	uint8_t APU::read_register(uint16_t address){
+		const int offset = address - REGISTERS_START;
+		if (offset >= WAVE_RAM) return reg(offset);
+
+		if (offset == NR52){
+			// Length counters might have turned channels off since the last batch
+			catch_up();
+			uint8_t status = powered ? 0x80 : 0x00;
+			for (int index = 0; index < ChannelCount; index++){
+				if (channels[index].enabled) status |= (1 << index);
+			}
+			return status | read_masks[NR52];
+		}
+		return reg(offset) | read_masks[offset];
+	}
+
+	void APU::write_register(uint16_t address, uint8_t value){
+		const int offset = address - REGISTERS_START;
+		// Everything before this write has to be heard with the old values
+		catch_up();
+
+		if (offset >= WAVE_RAM){
+			reg(offset) = value;
+			if (channels[Wave].enabled) update_output(Wave, batch_cycles);
+			return;
+		}
+		if (offset == NR52){
+			const bool new_powered = value & 0x80;
+			if (powered && !new_powered){
+				// Turning the APU off clears every register apart from wave RAM
+				std::fill(registers.begin(), registers.begin() + WAVE_RAM, 0);
+				for (int index = 0; index < ChannelCount; index++){
+					channels[index].enabled = false;
+					update_output(index, batch_cycles);
+				}
+			}else if (!powered && new_powered){
+				frame_sequencer_step = 0;
+			}
+			powered = new_powered;
+			return;
+		}
+		if (!powered) return;
+
+		reg(offset) = value;
+
+		if (offset >= NR50){
+			// The volume or panning changed, so every channel's contribution changes
+			for (int index = 0; index < ChannelCount; index++){
+				update_output(index, batch_cycles);
+			}
+			return;
+		}
+
+		const int index = offset / 5;
+		switch(offset % 5){
+		case 1:
+			channels[index].length_counter = (index == Wave) ? (256 - value) : (64 - (value & 0x3F));
+			break;
+		case 2:
+			// NR32 is the wave volume, and doesn't turn the DAC off
+			if (!dac_enabled(index)) channels[index].enabled = false;
+			break;
+		case 4:
+			if (value & 0x80) trigger(index);
+			break;
+		case 0:
+			if (index == Wave && !dac_enabled(Wave)) channels[Wave].enabled = false;
+			break;
+		}
+		update_output(index, batch_cycles);
+	}
+}
@@ -0,0 +1,62 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/band_limited_buffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <assert.h>
+
+namespace GB{
+	BandLimitedBuffer::BandLimitedBuffer(uint32_t clock_rate, uint32_t sample_rate, size_t max_samples){
+		factor = (static_cast<uint64_t>(sample_rate) << FRACTION_BITS) / clock_rate;
+		buffer.resize(max_samples + KERNEL_WIDTH, 0);
+
+		// A Blackman-windowed sinc for each sub-sample phase, cut off a little below Nyquist.
+		// Each phase is normalized so a step always ends up at exactly its full height.
+		const double pi = std::acos(-1.0);
+		constexpr double cutoff = 0.45;
+		for (int phase = 0; phase < PHASE_COUNT; phase++){
+			double sum = 0;
+			for (int i = 0; i < KERNEL_WIDTH; i++){
+				const double x = (i - KERNEL_WIDTH / 2) - static_cast<double>(phase) / PHASE_COUNT;
+				const double sinc = (x == 0) ? 1.0 : std::sin(2 * pi * cutoff * x) / (2 * pi * cutoff * x);
+				const double window_position = (x + KERNEL_WIDTH / 2) / KERNEL_WIDTH;
+				const double window = 0.42 - 0.5 * std::cos(2 * pi * window_position) + 0.08 * std::cos(4 * pi * window_position);
+				kernels[phase][i] = sinc * window;
+				sum += kernels[phase][i];
+			}
+			for (int i = 0; i < KERNEL_WIDTH; i++){
+				kernels[phase][i] /= sum;
+			}
+		}
+	}
+
+	void BandLimitedBuffer::end_frame(uint32_t clock_duration){
+		offset += clock_duration * factor;
+		assert(samples_available() + KERNEL_WIDTH <= buffer.size());
+	}
+
+	size_t BandLimitedBuffer::read_samples(int16_t* out, size_t count, size_t stride, float gain){
+		count = std::min(count, samples_available());
+		for (size_t i = 0; i < count; i++){
+			integrator += buffer[i];
+			// Leak a little every sample, which removes any DC offset
+			integrator -= integrator * (1.0f / 512);
+			const float sample = std::max(-32768.0f, std::min(32767.0f, integrator * gain));
+			out[i * stride] = static_cast<int16_t>(sample);
+		}
+
+		// Move the samples that haven't been finished yet to the front
+		const size_t remaining = samples_available() - count + KERNEL_WIDTH;
+		std::copy(buffer.begin() + count, buffer.begin() + count + remaining, buffer.begin());
+		std::fill(buffer.begin() + remaining, buffer.begin() + count + remaining, 0.0f);
+		offset -= static_cast<uint64_t>(count) << FRACTION_BITS;
+		return count;
+	}
+
+	void BandLimitedBuffer::clear(){
+		offset = 0;
+		integrator = 0;
+		std::fill(buffer.begin(), buffer.end(), 0.0f);
+	}
+}
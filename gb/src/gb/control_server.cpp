@@ -0,0 +1,222 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/control_server.h"
+#include "gb/cpu.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace GB{
+	std::unique_ptr<ControlServer> ControlServer::create(const char* path){
+		sockaddr_un address = {};
+		address.sun_family = AF_UNIX;
+		if (strlen(path) >= sizeof(address.sun_path)){
+			fprintf(stderr, "Control socket path '%s' is too long\n", path);
+			return nullptr;
+		}
+		strcpy(address.sun_path, path);
+
+		int listen_socket = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (listen_socket < 0){
+			fprintf(stderr, "Couldn't create control socket: %s\n", strerror(errno));
+			return nullptr;
+		}
+		unlink(path);
+		if (bind(listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || listen(listen_socket, 1) != 0){
+			fprintf(stderr, "Couldn't listen on '%s': %s\n", path, strerror(errno));
+			close(listen_socket);
+			return nullptr;
+		}
+
+		std::unique_ptr<ControlServer> server(new ControlServer());
+		server->path = path;
+		server->listen_socket = listen_socket;
+		fprintf(stdout, "Waiting for commands on '%s'\n", path);
+		return server;
+	}
+
+	ControlServer::~ControlServer(){
+		if (listen_socket >= 0){
+			close(listen_socket);
+			unlink(path.c_str());
+		}
+	}
+
+	void ControlServer::run(CPU& cpu){
+		while (!cpu.stopped){
+			int client = accept(listen_socket, nullptr, nullptr);
+			if (client < 0){
+				if (errno == EINTR) continue;
+				fprintf(stderr, "Couldn't accept a control client: %s\n", strerror(errno));
+				return;
+			}
+			const bool keep_going = serve_client(cpu, client);
+			close(client);
+			if (!keep_going) return;
+		}
+	}
+
+	bool ControlServer::serve_client(CPU& cpu, int client){
+		std::string pending;
+		char buffer[4096];
+		while (true){
+			ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+			if (received < 0 && errno == EINTR) continue;
+			if (received <= 0) return true; // The client went away, wait for the next one
+
+			pending.append(buffer, received);
+
+			// Run every complete line that's arrived, and send all of their replies together
+			std::string replies;
+			bool keep_going = true;
+			size_t line_end;
+			while (keep_going && (line_end = pending.find('\n')) != std::string::npos){
+				std::string line = pending.substr(0, line_end);
+				pending.erase(0, line_end + 1);
+				if (!line.empty() && line.back() == '\r') line.pop_back();
+				if (line.empty()) continue;
+				keep_going = execute(cpu, line, replies);
+			}
+
+			size_t sent = 0;
+			while (sent < replies.size()){
+				ssize_t written = send(client, replies.data() + sent, replies.size() - sent, MSG_NOSIGNAL);
+				if (written < 0 && errno == EINTR) continue;
+				if (written <= 0) return keep_going;
+				sent += written;
+			}
+			if (!keep_going) return false;
+		}
+	}
+
+	bool ControlServer::run_frames(CPU& cpu, uint64_t frames){
+		const uint64_t target = frame_count + frames;
+		const unsigned int start_cycles = cpu.clock_cycles;
+		const uint64_t cycle_limit = (frames + 1) * FRAME_CYCLES;
+		while (frame_count < target && !cpu.stopped && static_cast<unsigned int>(cpu.clock_cycles - start_cycles) < cycle_limit){
+			cpu.step();
+		}
+		return !cpu.stopped;
+	}
+
+	namespace{
+		const char HEX_DIGITS[] = "0123456789abcdef";
+
+		bool parse_hex_bytes(const std::string& text, std::vector<uint8_t>& bytes){
+			if (text.size() % 2 != 0) return false;
+			for (size_t i = 0; i < text.size(); i += 2){
+				char* end = nullptr;
+				const std::string pair = text.substr(i, 2);
+				const unsigned long byte = strtoul(pair.c_str(), &end, 16);
+				if (*end != '\0') return false;
+				bytes.push_back(byte);
+			}
+			return true;
+		}
+
+		const char DMA_BUSY_ERROR[] = "error only RAM can be used while an OAM DMA is running";
+
+		// Plain RAM is read and written directly, so it's always safe. Everything else goes through the MMU like an instruction would,
+		// which during an OAM DMA is a bus conflict that stops the CPU.
+		bool can_access(CPU& cpu, unsigned int address, size_t length){
+			if (cpu.mmu.dma_timer < 0) return true;
+			for (size_t i = 0; i < length; i++){
+				if (!MMU::is_plain_ram(address + i)) return false;
+			}
+			return true;
+		}
+	}
+
+	bool ControlServer::execute(CPU& cpu, const std::string& line, std::string& replies){
+		std::istringstream arguments(line);
+		std::string command;
+		arguments >> command;
+
+		std::string reply = "ok";
+		bool keep_going = true;
+		if (command == "run"){
+			uint64_t frames = 0;
+			if (!(arguments >> frames)){
+				reply = "error run needs a frame count";
+			}else if (!run_frames(cpu, frames)){
+				reply = "error the CPU has stopped";
+			}else{
+				reply += " " + std::to_string(frame_count);
+			}
+		}else if (command == "input"){
+			unsigned int mask = 0;
+			if (!(arguments >> std::hex >> mask) || mask > 0xFF){
+				reply = "error input needs a mask from 0 to ff";
+			}else{
+				cpu.input.set_pressed(mask);
+			}
+		}else if (command == "read"){
+			unsigned int address = 0, length = 0;
+			if (!(arguments >> std::hex >> address >> length) || address > 0xFFFF || length > 0x10000 - address){
+				reply = "error read needs an address and a length inside the address space";
+			}else if (!can_access(cpu, address, length)){
+				reply = DMA_BUSY_ERROR;
+			}else{
+				reply += " ";
+				for (unsigned int i = 0; i < length; i++){
+					const uint8_t* plain_byte = cpu.mmu.map_plain_ram(address + i);
+					const uint8_t byte = plain_byte ? *plain_byte : cpu.mmu.read_byte(address + i);
+					reply += HEX_DIGITS[byte >> 4];
+					reply += HEX_DIGITS[byte & 0xF];
+				}
+			}
+		}else if (command == "write"){
+			unsigned int address = 0;
+			std::string hex;
+			std::vector<uint8_t> bytes;
+			if (!(arguments >> std::hex >> address >> hex) || !parse_hex_bytes(hex, bytes) || address > 0xFFFF || bytes.size() > 0x10000 - address){
+				reply = "error write needs an address and an even number of hex digits";
+			}else if (!can_access(cpu, address, bytes.size())){
+				reply = DMA_BUSY_ERROR;
+			}else{
+				for (size_t i = 0; i < bytes.size(); i++){
+					uint8_t* plain_byte = cpu.mmu.map_plain_ram(address + i);
+					if (plain_byte){
+						*plain_byte = bytes[i];
+					}else{
+						cpu.mmu.write_byte(address + i, bytes[i]);
+					}
+				}
+			}
+		}else if (command == "snapshot" || command == "restore"){
+			int slot = -1;
+			if (!(arguments >> slot) || slot < 0 || slot >= SNAPSHOT_SLOTS){
+				reply = "error the slot should be from 0 to " + std::to_string(SNAPSHOT_SLOTS - 1);
+			}else if (command == "snapshot"){
+				snapshots[slot] = cpu.save_state();
+			}else if (snapshots[slot].empty()){
+				reply = "error nothing has been saved in that slot";
+			}else if (!cpu.load_state(snapshots[slot])){
+				reply = "error the snapshot couldn't be loaded";
+			}
+		}else if (command == "hash"){
+			uint64_t hash = 0xcbf29ce484222325;
+			for (GPU::Pixel pixel : cpu.gpu.framebuffer){
+				hash = (hash ^ static_cast<uint8_t>(pixel)) * 0x100000001b3;
+			}
+			char text[17];
+			snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash));
+			reply += " ";
+			reply += text;
+		}else if (command == "quit"){
+			keep_going = false;
+		}else{
+			reply = "error unknown command '" + command + "'";
+		}
+
+		replies += reply;
+		replies += '\n';
+		return keep_going;
+	}
+}
@@ -8,15 +8,28 @@
 #include <assert.h>
 
 namespace GB{
-	Instructions::InstructionSet CPU::instruction_set;
-
 	bool CPU::debug_data = CPU::allow_debug;
 	bool CPU::extended_debug_data = CPU::allow_extended_debug && CPU::debug_data;
 	bool CPU::limit_fps = true;
 
-	CPU::CPU(std::array<uint8_t, MMU::BIOS_SIZE> bios, std::vector<uint8_t> rom, void (*on_vblank)(CPU&)) : mmu(*this), gpu(*this), input(*this), interrupts(*this), cartridge(std::move(rom)), timer(*this), on_vblank(on_vblank){
+	CPU::CPU(std::array<uint8_t, MMU::BIOS_SIZE> bios, std::vector<uint8_t> rom, void (*on_vblank)(CPU&), bool debug_step, bool profile) : mmu(*this), gpu(*this), input(*this), interrupts(*this), cartridge(std::move(rom)), timer(*this), serial(*this), apu(*this), on_vblank(on_vblank){
 		mmu.load_bios(std::move(bios));
 
+		if (profile){
+			profiler = std::make_unique<Profiler>();
+			if (debug_step){
+				step_function = &CPU::step_with_policy<ProfiledStepPolicy<DebugStepPolicy>>;
+			}else{
+				step_function = &CPU::step_with_policy<ProfiledStepPolicy<ReleaseStepPolicy>>;
+			}
+		}else{
+			if (debug_step){
+				step_function = &CPU::step_with_policy<DebugStepPolicy>;
+			}else{
+				step_function = &CPU::step_with_policy<ReleaseStepPolicy>;
+			}
+		}
+
 		reset();
 	}
 
@@ -50,10 +63,84 @@ namespace GB{
 		input.reset();
 		interrupts.reset();
 		cartridge.reset();
+		timer.reset();
+		serial.reset();
+		// After the MMU, which writes the sound registers as if the BIOS had set them
+		apu.reset();
+
+		if (profiler){
+			profiler->reset();
+		}
+	}
+
+	uint16_t CPU::rom_checksum(){
+		const auto& header = cartridge.mbc->rom_banks[0];
+		return (header[RomData::ROM_OFFSET_GLOBAL_CHECKSUM] << 8) | header[RomData::ROM_OFFSET_GLOBAL_CHECKSUM + 1];
+	}
+
+	void CPU::serialize(SaveState& state){
+		uint32_t version = SAVE_STATE_VERSION;
+		uint16_t checksum = rom_checksum();
+		state.value(version);
+		// load_state() has already checked these
+		state.value(checksum);
+
+		state.value(registers);
+		state.value(clock_cycles);
+		state.value(clock_cycles_this_step);
+		state.value(stopped);
+		state.value(halted);
+		state.value(within_bios);
+		state.value(pending_cpu_increment);
+
+		mmu.serialize(state);
+		gpu.serialize(state);
+		input.serialize(state);
+		// After halted, which decides whether an interrupt is next
+		interrupts.serialize(state);
+		cartridge.mbc->serialize(state);
+		timer.serialize(state);
+		serial.serialize(state);
+		apu.serialize(state);
+	}
+
+	std::vector<uint8_t> CPU::save_state(){
+		SaveState state;
+		serialize(state);
+		return state.data();
+	}
+	bool CPU::load_state(const std::vector<uint8_t>& data){
+		uint32_t version = 0;
+		uint16_t checksum = 0;
+		SaveState header(data);
+		header.value(version);
+		header.value(checksum);
+		if (header.has_failed() || version != SAVE_STATE_VERSION || checksum != rom_checksum()){
+			fprintf(stderr, "Can't load a state saved by a different version or from a different ROM\n");
+			return false;
+		}
+		if (data.size() != save_state().size()){
+			fprintf(stderr, "Can't load a state of the wrong size\n");
+			return false;
+		}
+
+		SaveState state(data);
+		serialize(state);
+		clear_operand();
+		return !state.has_failed();
 	}
 
 	void CPU::check_instructions(){
-		instruction_set.print_all();
+		Instructions::InstructionSet::print_all();
+		Instructions::FusedInstructionSet::print_all();
+	}
+
+	void CPU::print_profile(FILE* file){
+		if (!profiler){
+			fprintf(file, "The CPU was not created with profiling enabled.\n");
+			return;
+		}
+		profiler->print_report(file);
 	}
 
 	template<>
@@ -135,7 +222,87 @@ namespace GB{
 		return value;
 	}
 
-	void CPU::step(){
+	struct CPU::ReleaseStepPolicy{
+		constexpr static bool fuse_instructions = true;
+		static inline void on_interrupt(CPU& cpu, const InterruptData* interrupt_data){}
+		static inline void before_instruction(CPU& cpu){}
+		static inline void on_decoded(CPU& cpu, uint16_t instruction_pc, uint8_t instruction_index, const Instructions::Instruction* instruction){}
+		static inline void after_execute(CPU& cpu, uint8_t cycles){}
+		static inline void after_step(CPU& cpu, uint8_t instruction_index){}
+	};
+
+	struct CPU::DebugStepPolicy : CPU::ReleaseStepPolicy{
+		// Stepping and loop detection need to see every instruction
+		constexpr static bool fuse_instructions = false;
+		static inline void on_interrupt(CPU& cpu, const InterruptData* interrupt_data){
+			if (allow_debug){
+				fprintf(stderr, "Triggered Interrupt 0x%02x!\n", interrupt_data->flag_value);
+			}
+		}
+		static inline void before_instruction(CPU& cpu){
+			const uint16_t pc = cpu.registers.pc;
+			if (pc == cpu.loop_check[0] || pc == cpu.loop_check[1] || pc == cpu.loop_check[2]){
+				debug_data = allow_debug_during_loops;
+				extended_debug_data = allow_debug_during_loops && allow_extended_debug;
+				if (allow_debug && !debug_data){
+					fprintf(stdout, "\rloop");
+				}
+			}else{
+				debug_data = allow_debug && !cpu.waiting_for_ret;
+				extended_debug_data = allow_extended_debug && debug_data;
+			}
+	
+			cpu.loop_check[2] = cpu.loop_check[1];
+			cpu.loop_check[1] = cpu.loop_check[0];
+			cpu.loop_check[0] = pc;
+		}
+		static inline void on_decoded(CPU& cpu, uint16_t instruction_pc, uint8_t instruction_index, const Instructions::Instruction* instruction){
+			if (debug_data && !cpu.within_bios){
+				fprintf(stdout, "0x%04x: [0x%02x] %s\n", instruction_pc, instruction_index, instruction->disassembly);
+			}
+		}
+		static inline void after_step(CPU& cpu, uint8_t instruction_index){
+			/*if (cpu.registers.pc > MMU::GPU_VRAM_START && !cpu.manual_step_requested){
+			  fprintf(stdout, "Execution left the ROM!\n");
+			  cpu.manual_step_requested = true;
+			  }*/
+
+			/*if (cpu.registers.pc == 0x291){
+			  cpu.manual_step_requested = true;
+			  }*/
+			if (cpu.waiting_for_ret && (instruction_index == 0xC0 || instruction_index == 0xC8 || instruction_index == 0xC9 || instruction_index == 0xD0 || instruction_index == 0xD8 || instruction_index == 0xD9)){
+				cpu.manual_step_requested = true;
+				cpu.waiting_for_ret = false;
+			}
+		
+			if (cpu.registers.pc == 0x38 && cpu.mmu.read_byte(cpu.registers.pc) == 0xff){
+				fprintf(stdout, "Encountered infinite RST 0x38 loop!\n");
+				cpu.stopped = true;
+			}
+		}
+	};
+
+	template<typename BaseStepPolicy>
+	struct CPU::ProfiledStepPolicy : BaseStepPolicy{
+		// The profile is per instruction
+		constexpr static bool fuse_instructions = false;
+		static inline void on_decoded(CPU& cpu, uint16_t instruction_pc, uint8_t instruction_index, const Instructions::Instruction* instruction){
+			BaseStepPolicy::on_decoded(cpu, instruction_pc, instruction_index, instruction);
+
+			const bool banked = instruction_pc >= MMU::ROM_BANK_ONE_START && instruction_pc < MMU::GPU_VRAM_START;
+			const uint8_t rom_bank = banked ? cpu.cartridge.mbc->current_rom_bank() : 0;
+			// get_instruction() has already loaded the CB opcode as the operand
+			const uint8_t cb_opcode = (instruction_index == 0xCB) ? static_cast<uint8_t>(cpu.current_operand) : 0;
+			cpu.profiler->begin_instruction(rom_bank, instruction_pc, instruction_index, cb_opcode);
+		}
+		static inline void after_execute(CPU& cpu, uint8_t cycles){
+			BaseStepPolicy::after_execute(cpu, cycles);
+			cpu.profiler->end_instruction(cycles);
+		}
+	};
+
+	template<typename StepPolicy>
+	void CPU::step_with_policy(){
 		if (stopped) return;
 
 		clock_cycles_this_step = 0;
@@ -144,9 +311,7 @@ namespace GB{
 			auto interrupt_data = interrupts.next_interrupt();
 			if (interrupt_data){
 				interrupts.disable();
-				if (allow_debug){
-					fprintf(stderr, "Triggered Interrupt 0x%02x!\n", interrupt_data->flag_value);
-				}
+				StepPolicy::on_interrupt(*this, interrupt_data);
 				push_to_stack(registers.pc);
 				jump_to(interrupt_data->handler_pc);
 				interrupts.flagged = interrupts.flagged & ~(interrupt_data->flag_value);
@@ -158,95 +323,100 @@ namespace GB{
 
 		uint16_t old_pc = registers.pc;
 		uint8_t instruction_index = mmu.read_byte(registers.pc);
-		Instructions::Instruction* instruction;
+		const Instructions::Instruction* instruction = nullptr;
+		const Instructions::FusedInstruction* fused = nullptr;
 		if (!halted){
-			if (registers.pc == loop_check[0] || registers.pc == loop_check[1] || registers.pc == loop_check[2]){
-				debug_data = allow_debug_during_loops;
-				extended_debug_data = allow_debug_during_loops && allow_extended_debug;
-				if (allow_debug && !debug_data){
-					fprintf(stdout, "\rloop");
+			StepPolicy::before_instruction(*this);
+
+			if constexpr (StepPolicy::fuse_instructions){
+				if (!within_bios){
+					fused = Instructions::FusedInstructionSet::find(*this, old_pc, instruction_index);
 				}
-			}else{
-				debug_data = allow_debug && !waiting_for_ret;
-				extended_debug_data = allow_extended_debug && debug_data;
 			}
-	
-			loop_check[2] = loop_check[1];
-			loop_check[1] = loop_check[0];
-			loop_check[0] = registers.pc;
 
-			registers.pc++;
+			if (fused){
+				Instrumentation::Scope timing(instrumentation.get(), Instrumentation::Section::Dispatch);
+				// Does its own PC increments and operand loads
+				clock_cycles_this_step += fused->execute(*this);
+			}else{
+				registers.pc++;
 	
-			instruction = instruction_set.get_instruction(*this, instruction_index);
-			if (debug_data && !within_bios){
-				fprintf(stdout, "0x%04x: [0x%02x] %s\n", old_pc, instruction_index, instruction->disassembly);
-			}
+				instruction = Instructions::InstructionSet::get_instruction(*this, instruction_index);
+				StepPolicy::on_decoded(*this, old_pc, instruction_index, instruction);
 
-			clock_cycles_this_step += instruction->execute(*this);
+				uint8_t instruction_cycles;
+				{
+					Instrumentation::Scope timing(instrumentation.get(), Instrumentation::Section::Dispatch);
+					instruction_cycles = instruction->execute(*this);
+				}
+				StepPolicy::after_execute(*this, instruction_cycles);
+				clock_cycles_this_step += instruction_cycles;
+			}
 		}else{
 			clock_cycles_this_step = 1;
 		}
 
-		clock_cycles += clock_cycles_this_step;
-
-		registers.f = registers.f & 0xF0;
+		step_components();
 
-		mmu.step();
-		gpu.step();
-		timer.step();
+		if (fused && fused->loops){
+			repeat_fused_loop(*fused, old_pc);
+		}
 	
+		// Not a debug check, the BIOS can't be unmapped until it finishes
 		if (within_bios && registers.pc >= MMU::BIOS_SIZE){
 			fprintf(stdout, "Ran the BIOS successfully!\n");
 			exit_bios();
 		}
 
-		/*if (registers.pc > MMU::GPU_VRAM_START && !manual_step_requested){
-		  fprintf(stdout, "Execution left the ROM!\n");
-		  manual_step_requested = true;
-		  }*/
-
-		/*if (registers.pc == 0x291){
-		  manual_step_requested = true;
-		  }
-		  if (registers.pc == 0x282a){
-		  manual_step_requested = true;
-		  }
-		  if (registers.pc == 0x2817){
-		  manual_step_requested = true;
-		  }*/
-
-		/*if (registers.pc == 0xc360){
-			manual_step_requested = true;
-			}*/
-		/*if (registers.pc == 0xC67F){
-			manual_step_requested = true;
-			waiting_for_ret = false;
-		}
-		if (registers.pc == 0xC682){
-			manual_step_requested = true;
-			waiting_for_ret = false;
-		}*/
-		if (registers.pc == 0x20b1){
-			//manual_step_requested = true;
-			//waiting_for_ret = false;
-		}
-		if (waiting_for_ret && (instruction_index == 0xC0 || instruction_index == 0xC8 || instruction_index == 0xC9 || instruction_index == 0xD0 || instruction_index == 0xD8 || instruction_index == 0xD9)){
-			manual_step_requested = true;
-			waiting_for_ret = false;
-		}
-		
-		if (registers.pc == 0x38 && mmu.read_byte(registers.pc) == 0xff){
-			fprintf(stdout, "Encountered infinite RST 0x38 loop!\n");
-			stopped = true;
-		}
-		/*if (instruction_index == 0xD1 && registers.pc > 0xc090){
-			manual_step_requested = true;
-			}*/
+		StepPolicy::after_step(*this, instruction_index);
 	
 		if (stopped){
-			fprintf(stdout, "Execution was stopped with PC at 0x%04x (instruction at 0x%04x), instruction 0x%02x \"%s\".\n", registers.pc, old_pc, instruction_index, instruction->disassembly);
+			fprintf(stdout, "Execution was stopped with PC at 0x%04x (instruction at 0x%04x), instruction 0x%02x \"%s\".\n", registers.pc, old_pc, instruction_index, instruction ? instruction->disassembly : (fused ? fused->disassembly : "HALT"));
 		}
 	
-		current_operand_size = 0;
+		clear_operand();
+	}
+
+	void CPU::repeat_fused_loop(const Instructions::FusedInstruction& fused, uint16_t loop_pc){
+		// The same checks step() would make before running the loop again, minus the decode
+		for (int i = 0; i < MAX_FUSED_LOOP_ITERATIONS && registers.pc == loop_pc; i++){
+			if (stopped || halted || mmu.dma_timer >= 0 || interrupts.next_interrupt() != nullptr) return;
+
+			clear_operand();
+			{
+				Instrumentation::Scope timing(instrumentation.get(), Instrumentation::Section::Dispatch);
+				clock_cycles_this_step = fused.execute(*this);
+			}
+			step_components();
+		}
+	}
+
+	void CPU::step_recompiled(){
+		// Interrupts, HALT, OAM DMA and the BIOS are all left to the interpreter
+		if (can_run_outside_step()){
+			const uint8_t rom_bank = (registers.pc >= MMU::ROM_BANK_ONE_START) ? cartridge.mbc->current_rom_bank() : 0;
+			const RecompiledBlock block = recompiled->find(rom_bank, registers.pc);
+			if (block){
+				Instrumentation::Scope timing(instrumentation.get(), Instrumentation::Section::Dispatch);
+				block(*this);
+				return;
+			}
+		}
+		step_with_policy<ReleaseStepPolicy>();
+	}
+
+	bool CPU::steps_every_instruction(){
+		return step_function != &CPU::step_with_policy<ReleaseStepPolicy> && step_function != &CPU::step_recompiled;
+	}
+
+	bool CPU::load_recompiled(const char* path){
+		if (steps_every_instruction()){
+			fprintf(stderr, "Recompiled code can't be used with --debug or --profile, they need every instruction to go through step()\n");
+			return false;
+		}
+		recompiled = RecompiledBlocks::load(path, cartridge.mbc->rom_banks);
+		if (!recompiled) return false;
+		step_function = &CPU::step_recompiled;
+		return true;
 	}
 }
@@ -2,6 +2,7 @@
 
 #include "gb/gpu.h"
 #include "gb/cpu.h"
+#include "gb/save_state.h"
 
 #include <cstring>
 #include <chrono>
@@ -25,9 +26,21 @@ namespace GB{
 		mode_clock = 0;
 		line_counter = 0;
 
+		// set_lcdc_status() only writes the interrupt enables
+		current_lcdc_status = LCDCStatus{};
 		set_lcdc_status(0);
 	}
 
+	void GPU::serialize(SaveState& state){
+		state.value(vram);
+		state.value(spriteinfo);
+		state.value(framebuffer);
+		state.value(mode);
+		state.value(mode_clock);
+		state.value(line_counter);
+		state.value(current_lcdc_status);
+	}
+
 	void GPU::step(){
 		if (cpu.mmu.dma_timer >= 0) return;
 		
@@ -98,6 +111,7 @@ namespace GB{
 	}
 
 	void GPU::render_scanline(){
+		Instrumentation::Scope timing(cpu.instrumentation.get(), Instrumentation::Section::RenderScanline);
 		uint8_t gpu_control_byte = cpu.mmu.read_byte(MMU::GPU_CONTROL_ADDRESS);
 		Control gpu_control = *((Control*)&gpu_control_byte);
 
@@ -287,7 +301,13 @@ namespace GB{
 	}
 	void GPU::render_to_framebuffer(){
 		cpu.interrupts.trigger(Interrupt::VBlank);
-		cpu.on_vblank(cpu);
+		{
+			Instrumentation::Scope timing(cpu.instrumentation.get(), Instrumentation::Section::Present);
+			cpu.on_vblank(cpu);
+		}
+		if (Instrumentation::compiled_in && cpu.instrumentation){
+			cpu.instrumentation->end_frame();
+		}
 		if (current_lcdc_status.enable_vblank_interrupt) cpu.interrupts.trigger(Interrupt::LcdStat);
 		if (CPU::limit_fps) std::this_thread::sleep_for(std::chrono::milliseconds(17));
 	}
@@ -2,6 +2,7 @@
 
 #include "gb/input.h"
 #include "gb/cpu.h"
+#include "gb/save_state.h"
 
 namespace GB{
 	Input::Input(CPU& cpu) : cpu(cpu){}
@@ -15,7 +16,19 @@ namespace GB{
 		buttons[static_cast<int>(Button::A)] = false;
 		buttons[static_cast<int>(Button::B)] = false;
 
+		// Nothing pressed, and the unused bits read as 1 like on hardware
+		uint8_t released = 0xFF;
+		current_value = *reinterpret_cast<InputData*>(&released);
 		set_value(1);
+		pressed_mask = 0;
+	}
+
+	void Input::serialize(SaveState& state){
+		state.value(direction_horiz);
+		state.value(direction_vert);
+		state.value(buttons);
+		state.value(current_value);
+		state.value(pressed_mask);
 	}
 
 	uint8_t Input::get_value(){
@@ -88,4 +101,19 @@ namespace GB{
 	void Input::on_button_up(Button button){
 		buttons[static_cast<int>(button)] = false;
 	}
+
+	void Input::set_pressed(uint8_t mask){
+		const uint8_t changed = mask ^ pressed_mask;
+		for (int i = 0; i < 4; i++){
+			if (!(changed & (1 << i))) continue;
+			if (mask & (1 << i)) on_direction_down(static_cast<Direction>(i));
+			else on_direction_up(static_cast<Direction>(i));
+		}
+		for (int i = 0; i < 4; i++){
+			if (!(changed & (1 << (4 + i)))) continue;
+			if (mask & (1 << (4 + i))) on_button_down(static_cast<Button>(i));
+			else on_button_up(static_cast<Button>(i));
+		}
+		pressed_mask = mask;
+	}
 }
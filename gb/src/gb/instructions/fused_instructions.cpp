@@ -0,0 +1,163 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/cpu.h"
+#include "gb/instructions/fused_instructions.h"
+#include "gb/instructions/instruction_tables.h"
+
+namespace GB::Instructions{
+	namespace FusedBuilders{
+		// Runs one instruction of a sequence the same way step() would have, except for moving the rest of the system on
+		template<uint8_t Opcode>
+		inline uint8_t execute_in_sequence(CPU& cpu){
+			constexpr auto execute = instruction_table[Opcode].execute;
+			cpu.registers.pc++;
+			const uint8_t cycles = execute(cpu);
+			cpu.clear_operand();
+			return cycles;
+		}
+
+		template<uint8_t... Opcodes>
+		class Sequence{
+		public:
+			constexpr static uint8_t length = (instruction_table[Opcodes].length + ...);
+			constexpr static std::array<uint8_t, sizeof...(Opcodes)> opcodes = {Opcodes...};
+
+			static uint8_t execute(CPU& cpu){
+				uint8_t cycles = 0;
+				// A comma fold, so the instructions run in order
+				((cycles += execute_in_sequence<Opcodes>(cpu)), ...);
+				return cycles;
+			}
+		};
+
+		// Checks the pattern is made of the opcodes the sequence runs, with their operands in between
+		template<typename SequenceType>
+		constexpr bool pattern_matches_opcodes(const std::array<int16_t, FusedInstruction::MAX_LENGTH>& pattern){
+			int position = 0;
+			for (uint8_t opcode : SequenceType::opcodes){
+				if (pattern[position] != opcode) return false;
+				position += instruction_table[opcode].length;
+			}
+			return position == SequenceType::length;
+		}
+
+		// For a loop the last byte, the offset of the JR back to the start, is filled in here
+		template<typename SequenceType>
+		constexpr FusedInstruction make_fused_instruction(const char* const disassembly, std::array<int16_t, FusedInstruction::MAX_LENGTH> pattern, bool loops){
+			static_assert(SequenceType::length <= FusedInstruction::MAX_LENGTH, "Sequence is too long to fuse");
+			if (loops){
+				pattern[SequenceType::length - 1] = static_cast<uint8_t>(-SequenceType::length);
+			}
+			return FusedInstruction{disassembly, &SequenceType::execute, pattern, SequenceType::length, loops};
+		}
+
+		constexpr int16_t ANY = FusedInstruction::ANY_BYTE;
+		constexpr bool LOOPS = true;
+
+		// Longer sequences come first, so a loop is preferred over the part of it that doesn't loop
+		using CopyLoopB = Sequence<0x2A, 0x12, 0x13, 0x05, 0x20>;
+		using CopyLoopC = Sequence<0x2A, 0x12, 0x13, 0x0D, 0x20>;
+		using CopyLoopBC = Sequence<0x2A, 0x12, 0x13, 0x0B, 0x78, 0xB1, 0x20>;
+		using FillLoopIncrementB = Sequence<0x22, 0x05, 0x20>;
+		using FillLoopIncrementC = Sequence<0x22, 0x0D, 0x20>;
+		using FillLoopDecrementB = Sequence<0x32, 0x05, 0x20>;
+		using FillLoopDecrementC = Sequence<0x32, 0x0D, 0x20>;
+		using PollCompareNotZero = Sequence<0xF0, 0xFE, 0x20>;
+		using PollCompareZero = Sequence<0xF0, 0xFE, 0x28>;
+		using PollAndNotZero = Sequence<0xF0, 0xE6, 0x20>;
+		using PollAndZero = Sequence<0xF0, 0xE6, 0x28>;
+		using ReadCompare = Sequence<0xF0, 0xFE>;
+		using Copy = Sequence<0x2A, 0x12, 0x13>;
+		using Clear = Sequence<0xAF, 0x22>;
+
+		constexpr std::array<FusedInstruction, 14> fused_instructions = {
+			make_fused_instruction<CopyLoopBC>("LD A,(HL+); LD (DE),A; INC DE; DEC BC; LD A,B; OR C; JR NZ", {0x2A, 0x12, 0x13, 0x0B, 0x78, 0xB1, 0x20, ANY}, LOOPS),
+			make_fused_instruction<CopyLoopB>("LD A,(HL+); LD (DE),A; INC DE; DEC B; JR NZ", {0x2A, 0x12, 0x13, 0x05, 0x20, ANY}, LOOPS),
+			make_fused_instruction<CopyLoopC>("LD A,(HL+); LD (DE),A; INC DE; DEC C; JR NZ", {0x2A, 0x12, 0x13, 0x0D, 0x20, ANY}, LOOPS),
+			make_fused_instruction<Copy>("LD A,(HL+); LD (DE),A; INC DE", {0x2A, 0x12, 0x13}, !LOOPS),
+			make_fused_instruction<FillLoopIncrementB>("LD (HL+),A; DEC B; JR NZ", {0x22, 0x05, 0x20, ANY}, LOOPS),
+			make_fused_instruction<FillLoopIncrementC>("LD (HL+),A; DEC C; JR NZ", {0x22, 0x0D, 0x20, ANY}, LOOPS),
+			make_fused_instruction<FillLoopDecrementB>("LD (HL-),A; DEC B; JR NZ", {0x32, 0x05, 0x20, ANY}, LOOPS),
+			make_fused_instruction<FillLoopDecrementC>("LD (HL-),A; DEC C; JR NZ", {0x32, 0x0D, 0x20, ANY}, LOOPS),
+			make_fused_instruction<PollCompareNotZero>("LDH A,(n); CP n; JR NZ", {0xF0, ANY, 0xFE, ANY, 0x20, ANY}, LOOPS),
+			make_fused_instruction<PollCompareZero>("LDH A,(n); CP n; JR Z", {0xF0, ANY, 0xFE, ANY, 0x28, ANY}, LOOPS),
+			make_fused_instruction<PollAndNotZero>("LDH A,(n); AND n; JR NZ", {0xF0, ANY, 0xE6, ANY, 0x20, ANY}, LOOPS),
+			make_fused_instruction<PollAndZero>("LDH A,(n); AND n; JR Z", {0xF0, ANY, 0xE6, ANY, 0x28, ANY}, LOOPS),
+			make_fused_instruction<ReadCompare>("LDH A,(n); CP n", {0xF0, ANY, 0xFE, ANY}, !LOOPS),
+			make_fused_instruction<Clear>("XOR A; LD (HL+),A", {0xAF, 0x22}, !LOOPS),
+		};
+		static_assert(pattern_matches_opcodes<CopyLoopBC>(fused_instructions[0].pattern));
+		static_assert(pattern_matches_opcodes<CopyLoopB>(fused_instructions[1].pattern));
+		static_assert(pattern_matches_opcodes<CopyLoopC>(fused_instructions[2].pattern));
+		static_assert(pattern_matches_opcodes<Copy>(fused_instructions[3].pattern));
+		static_assert(pattern_matches_opcodes<FillLoopIncrementB>(fused_instructions[4].pattern));
+		static_assert(pattern_matches_opcodes<FillLoopIncrementC>(fused_instructions[5].pattern));
+		static_assert(pattern_matches_opcodes<FillLoopDecrementB>(fused_instructions[6].pattern));
+		static_assert(pattern_matches_opcodes<FillLoopDecrementC>(fused_instructions[7].pattern));
+		static_assert(pattern_matches_opcodes<PollCompareNotZero>(fused_instructions[8].pattern));
+		static_assert(pattern_matches_opcodes<PollCompareZero>(fused_instructions[9].pattern));
+		static_assert(pattern_matches_opcodes<PollAndNotZero>(fused_instructions[10].pattern));
+		static_assert(pattern_matches_opcodes<PollAndZero>(fused_instructions[11].pattern));
+		static_assert(pattern_matches_opcodes<ReadCompare>(fused_instructions[12].pattern));
+		static_assert(pattern_matches_opcodes<Clear>(fused_instructions[13].pattern));
+
+		constexpr std::array<bool, 256> build_starts_sequence(){
+			std::array<bool, 256> starts_sequence = {};
+			for (const FusedInstruction& fused : fused_instructions){
+				starts_sequence[fused.pattern[0]] = true;
+			}
+			return starts_sequence;
+		}
+	}
+
+	const std::array<bool, 256> FusedInstructionSet::starts_sequence = FusedBuilders::build_starts_sequence();
+
+	const FusedInstruction* FusedInstructionSet::match(CPU& cpu, uint16_t pc, uint8_t opcode){
+		for (const FusedInstruction& fused : FusedBuilders::fused_instructions){
+			if (fused.pattern[0] != opcode) continue;
+			if (pc + fused.length > MMU::GPU_VRAM_START) continue;
+
+			bool matches = true;
+			for (int i = 1; i < fused.length && matches; i++){
+				matches = fused.pattern[i] == FusedInstruction::ANY_BYTE || fused.pattern[i] == cpu.mmu.read_byte(pc + i);
+			}
+			if (matches) return &fused;
+		}
+		return nullptr;
+	}
+
+	const FusedInstruction* FusedInstructionSet::find_cached(CPU& cpu, uint16_t pc, uint8_t opcode){
+		return cpu.fused_cache.find(cpu, pc, opcode);
+	}
+
+	const FusedInstruction* FusedInstructionCache::find(CPU& cpu, uint16_t pc, uint8_t opcode){
+		// Nothing past the ROM matches anyway, and a sequence running from bank 0 into the switchable bank depends on both banks
+		const bool crosses_banks = pc < MMU::ROM_BANK_ONE_START && pc + FusedInstruction::MAX_LENGTH > MMU::ROM_BANK_ONE_START;
+		if (pc >= MMU::GPU_VRAM_START || crosses_banks){
+			return FusedInstructionSet::match(cpu, pc, opcode);
+		}
+
+		if (entries.empty()){
+			entries.assign(cpu.cartridge.mbc->rom_banks.size() * RomData::ROM_BANK_SIZE, NOT_MATCHED);
+		}
+		const size_t index = (pc < MMU::ROM_BANK_ONE_START) ? pc
+			: cpu.cartridge.mbc->current_rom_bank() * static_cast<size_t>(RomData::ROM_BANK_SIZE) + (pc - MMU::ROM_BANK_ONE_START);
+		if (index >= entries.size()){
+			return FusedInstructionSet::match(cpu, pc, opcode);
+		}
+
+		uint8_t& entry = entries[index];
+		if (entry == NOT_MATCHED){
+			const FusedInstruction* fused = FusedInstructionSet::match(cpu, pc, opcode);
+			entry = fused ? FIRST_SEQUENCE + (fused - FusedBuilders::fused_instructions.data()) : NO_SEQUENCE;
+			return fused;
+		}
+		return (entry == NO_SEQUENCE) ? nullptr : &FusedBuilders::fused_instructions[entry - FIRST_SEQUENCE];
+	}
+
+	void FusedInstructionSet::print_all(){
+		for (const FusedInstruction& fused : FusedBuilders::fused_instructions){
+			fprintf(stdout, "%s (%d bytes%s)\n", fused.disassembly, fused.length, fused.loops ? ", loops" : "");
+		}
+	}
+}
@@ -0,0 +1,159 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/instrumentation.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <thread>
+
+namespace GB{
+	Instrumentation::Instrumentation(){
+		const auto steady_start = std::chrono::steady_clock::now();
+		const uint64_t clocks_start = SL_TIMER_CPU_CLOCKS;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const uint64_t clocks_end = SL_TIMER_CPU_CLOCKS;
+		const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - steady_start).count();
+		clocks_per_us = (clocks_end - clocks_start) / us;
+		if (!(clocks_per_us > 0)) clocks_per_us = SL_TIMER_x86_CLKS_PER_US;
+
+		frame_start = SL_TIMER_CPU_CLOCKS;
+	}
+
+	void Instrumentation::trace_frames(const std::string& path, uint64_t first, uint64_t count){
+		trace_path = path;
+		trace_first_frame = first;
+		trace_frame_count = count;
+		tracing = (frames == first && count > 0);
+		if (tracing) trace_start = frame_start;
+	}
+
+	double Instrumentation::to_us(uint64_t clocks) const{
+		return clocks / clocks_per_us;
+	}
+
+	void Instrumentation::Histogram::add(double us, uint64_t new_calls){
+		int bucket = 0;
+		while (bucket < HISTOGRAM_BUCKETS - 1 && us >= (1u << bucket)){
+			bucket++;
+		}
+		buckets[bucket]++;
+		total_us += us;
+		if (us > max_us) max_us = us;
+		calls += new_calls;
+	}
+
+	double Instrumentation::Histogram::percentile_us(double percentile, uint64_t frames) const{
+		const uint64_t target = std::ceil(frames * percentile / 100.0);
+		uint64_t seen = 0;
+		for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++){
+			seen += buckets[bucket];
+			if (seen >= target && seen > 0) return 1u << bucket;
+		}
+		return 0;
+	}
+
+	void Instrumentation::end_frame(){
+		const uint64_t now = SL_TIMER_CPU_CLOCKS;
+		for (int section = 0; section < SECTION_COUNT; section++){
+			histograms[section].add(to_us(current_frame[section].clocks), current_frame[section].calls);
+			current_frame[section] = SectionFrame{};
+		}
+		frame_histogram.add(to_us(now - frame_start), 1);
+
+		if (tracing){
+			trace_frame_events.push_back({Section::Count, frame_start, now});
+		}
+		frame_start = now;
+		frames++;
+
+		if (trace_frame_count > 0){
+			if (frames == trace_first_frame){
+				tracing = true;
+				trace_start = now;
+			}else if (tracing && frames == trace_first_frame + trace_frame_count){
+				tracing = false;
+				write_trace();
+			}
+		}
+	}
+
+	const char* Instrumentation::section_name(int section){
+		switch(static_cast<Section>(section)){
+		case Section::Dispatch: return "Dispatch";
+		case Section::MMUStep: return "MMU::step";
+		case Section::TimerStep: return "Timer::step";
+		case Section::RenderScanline: return "GPU::render_scanline";
+		case Section::Present: return "Present";
+		default: return "Frame";
+		}
+	}
+
+	void Instrumentation::write_trace(){
+		FILE* file = fopen(trace_path.c_str(), "w");
+		if (file == nullptr){
+			fprintf(stderr, "Couldn't write the trace to %s\n", trace_path.c_str());
+			return;
+		}
+
+		// Complete ("X") events, with times in microseconds from the start of the first frame
+		fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+		bool first_event = true;
+		auto write_events = [&](const std::vector<TraceEvent>& events){
+			for (const TraceEvent& event : events){
+				fprintf(file, "%s{\"name\":\"%s\",\"cat\":\"gb\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+						first_event ? "" : ",\n", section_name(static_cast<int>(event.section)),
+						to_us(event.start - trace_start), to_us(event.end - event.start));
+				first_event = false;
+			}
+		};
+		write_events(trace_frame_events);
+		write_events(trace_events);
+		fprintf(file, "\n]}\n");
+		fclose(file);
+
+		fprintf(stdout, "Wrote %zu events for frames %" PRIu64 " to %" PRIu64 " to %s\n",
+				trace_frame_events.size() + trace_events.size(), trace_first_frame, trace_first_frame + trace_frame_count - 1, trace_path.c_str());
+		if (dropped_trace_events > 0){
+			fprintf(stdout, "%" PRIu64 " more events didn't fit, trace fewer frames to see them all\n", dropped_trace_events);
+		}
+		trace_events.clear();
+		trace_events.shrink_to_fit();
+		trace_frame_events.clear();
+	}
+
+	void Instrumentation::print_report(FILE* file){
+		if (frames == 0){
+			fprintf(file, "No frames were timed\n");
+			return;
+		}
+
+		fprintf(file, "Host time per frame over %" PRIu64 " frames, in microseconds (percentiles are the top of a power of two bucket)\n", frames);
+		fprintf(file, "Section                  Calls/frame       Mean        p50        p90        p99        Max\n");
+		auto print_row = [&](const char* name, const Histogram& histogram){
+			fprintf(file, "%-22s  %12.1f  %9.1f  %9.0f  %9.0f  %9.0f  %9.1f\n",
+					name, histogram.calls / static_cast<double>(frames), histogram.total_us / frames,
+					histogram.percentile_us(50, frames), histogram.percentile_us(90, frames), histogram.percentile_us(99, frames),
+					histogram.max_us);
+		};
+		print_row("Frame", frame_histogram);
+		for (int section = 0; section < SECTION_COUNT; section++){
+			print_row(section_name(section), histograms[section]);
+		}
+
+		fprintf(file, "Frames in each bucket:\n");
+		auto print_buckets = [&](const char* name, const Histogram& histogram){
+			fprintf(file, "%-22s ", name);
+			for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++){
+				if (histogram.buckets[bucket] > 0){
+					fprintf(file, " <%uus:%" PRIu64, 1u << bucket, histogram.buckets[bucket]);
+				}
+			}
+			fprintf(file, "\n");
+		};
+		print_buckets("Frame", frame_histogram);
+		for (int section = 0; section < SECTION_COUNT; section++){
+			print_buckets(section_name(section), histograms[section]);
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #include "gb/interrupts.h"
 #include <assert.h>
 #include "gb/cpu.h"
+#include "gb/save_state.h"
 
 namespace GB{
 	void Interrupts::trigger(Interrupt interrupt){
@@ -27,6 +28,15 @@ namespace GB{
 		cached_next_interrupt = nullptr;
 	}
 
+	void Interrupts::serialize(SaveState& state){
+		state.value(master_enabled);
+		state.value(enabled);
+		state.value(flagged);
+		if (state.is_loading()){
+			find_next_interrupt();
+		}
+	}
+
 	void Interrupts::find_next_interrupt(){
 		if (!master_enabled && !cpu.halted){
 			cached_next_interrupt = nullptr;
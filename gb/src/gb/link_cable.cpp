@@ -0,0 +1,15 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/link_cable.h"
+
+namespace GB{
+	void LinkCable::connect(int side){
+		// Anything left over from a previous connection is stale
+		ends[side].request.store(0, std::memory_order_relaxed);
+		ends[side].reply.store(0, std::memory_order_relaxed);
+		ends[side].connected.store(true, std::memory_order_release);
+	}
+	void LinkCable::disconnect(int side){
+		ends[side].connected.store(false, std::memory_order_release);
+	}
+}
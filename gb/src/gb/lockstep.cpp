@@ -0,0 +1,228 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/lockstep.h"
+#include "gb/cpu.h"
+#include "gb/instructions/fused_instructions.h"
+#include "gb/instructions/alu_instructions.inl"
+
+#include <assert.h>
+
+namespace GB{
+	namespace{
+		inline uint8_t blend(uint8_t mask, uint8_t if_set, uint8_t if_clear){
+			return (mask & if_set) | (~mask & if_clear);
+		}
+	}
+
+	Lockstep::Lockstep(std::vector<CPU*> cpus) : cpus(std::move(cpus)){
+		assert(this->cpus.size() <= MAX_INSTANCES);
+		for (auto& lane_registers : registers){
+			lane_registers.fill(0);
+		}
+		sp.fill(0);
+		pc.fill(0);
+		for (size_t lane = 0; lane < this->cpus.size(); lane++){
+			steps_every_instruction[lane] = this->cpus[lane]->steps_every_instruction() ? 0xFF : 0;
+		}
+	}
+
+	void Lockstep::gather(int lane){
+		const CPU::Registers& from = cpus[lane]->registers;
+		registers[0][lane] = from.b;
+		registers[1][lane] = from.c;
+		registers[2][lane] = from.d;
+		registers[3][lane] = from.e;
+		registers[4][lane] = from.h;
+		registers[5][lane] = from.l;
+		registers[REGISTER_F][lane] = from.f;
+		registers[REGISTER_A][lane] = from.a;
+		sp[lane] = from.sp;
+		pc[lane] = from.pc;
+	}
+	void Lockstep::scatter(int lane){
+		CPU::Registers& to = cpus[lane]->registers;
+		to.b = registers[0][lane];
+		to.c = registers[1][lane];
+		to.d = registers[2][lane];
+		to.e = registers[3][lane];
+		to.h = registers[4][lane];
+		to.l = registers[5][lane];
+		to.f = registers[REGISTER_F][lane];
+		to.a = registers[REGISTER_A][lane];
+		to.sp = sp[lane];
+		to.pc = pc[lane];
+	}
+
+	void Lockstep::run(unsigned int cycles){
+		const int count = cpus.size();
+		std::array<unsigned int, MAX_INSTANCES> start_cycles;
+		for (int lane = 0; lane < count; lane++){
+			start_cycles[lane] = cpus[lane]->clock_cycles;
+		}
+
+		while (true){
+			LaneMask active = {};
+			bool any_active = false;
+			for (int lane = 0; lane < count; lane++){
+				if (!cpus[lane]->stopped && cpus[lane]->clock_cycles - start_cycles[lane] < cycles){
+					active[lane] = 0xFF;
+					any_active = true;
+				}
+			}
+			if (!any_active) break;
+			run_round(active, start_cycles, cycles);
+		}
+	}
+
+	void Lockstep::run_round(const LaneMask& active, const std::array<unsigned int, MAX_INSTANCES>& start_cycles, unsigned int cycles){
+		const int count = cpus.size();
+		std::array<uint8_t, MAX_INSTANCES> opcodes;
+		LaneMask waiting = {};
+		for (int lane = 0; lane < count; lane++){
+			if (!active[lane]) continue;
+			// Each CPU runs on its own up to its next instruction with a kernel.
+			// Switching CPU after every instruction was slower than not grouping at all, because each one's memory had to come back into the cache.
+			CPU& cpu = *cpus[lane];
+			do{
+				if (!steps_every_instruction[lane] && cpu.can_run_outside_step()){
+					opcodes[lane] = cpu.mmu.read_byte(cpu.registers.pc);
+					// A fused sequence is still quicker than running its first instruction here and the rest one at a time
+					if (has_kernel(opcodes[lane]) && !Instructions::FusedInstructionSet::find(cpu, cpu.registers.pc, opcodes[lane])){
+						gather(lane);
+						waiting[lane] = 0xFF;
+						break;
+					}
+				}
+				cpu.step();
+				scalar_instructions++;
+			} while (!cpu.stopped && cpu.clock_cycles - start_cycles[lane] < cycles);
+		}
+
+		// Decode once for every lane that's at the same PC with the same opcode
+		for (int first = 0; first < count; first++){
+			if (!waiting[first]) continue;
+
+			const uint8_t opcode = opcodes[first];
+			LaneMask group = {};
+			for (int lane = first; lane < count; lane++){
+				if (waiting[lane] && pc[lane] == pc[first] && opcodes[lane] == opcode){
+					group[lane] = 0xFF;
+					waiting[lane] = 0;
+				}
+			}
+
+			if (verify_kernels){
+				check_kernel(opcode, group);
+			}else{
+				run_kernel(opcode, group);
+			}
+			const uint8_t instruction_cycles = Instructions::InstructionSet::instructions[opcode].cycles;
+			for (int lane = first; lane < count; lane++){
+				if (!group[lane]) continue;
+				pc[lane]++;
+				scatter(lane);
+				cpus[lane]->finish_recompiled_instruction(instruction_cycles);
+				vector_instructions++;
+			}
+		}
+	}
+
+	bool Lockstep::has_kernel(uint8_t opcode){
+		const int target = (opcode >> 3) & 7;
+		const int source = opcode & 7;
+		if (opcode == 0x00 || opcode == 0x2F) return true; // NOP, CPL
+		if (opcode >= 0x80 && opcode < 0xC0) return source != 6; // ALU A,r
+		if (opcode >= 0x40 && opcode < 0x80) return target != 6 && source != 6; // LD r,r, which also leaves out HALT
+		if (opcode < 0x40 && (source == 4 || source == 5)) return target != 6; // INC r, DEC r
+		return false;
+	}
+
+	// The operations are the ones the instructions use (ALU::Operations), so the lanes get exactly the same flags as step()
+	template<typename Operation>
+	void Lockstep::run_alu(int source, const LaneMask& mask){
+		uint8_t* a = registers[REGISTER_A].data();
+		uint8_t* f = registers[REGISTER_F].data();
+		const uint8_t* b = registers[source].data();
+		for (int lane = 0; lane < MAX_INSTANCES; lane++){
+			uint8_t flags;
+			const uint8_t result = Operation::apply(a[lane], b[lane], f[lane], flags);
+			if (Operation::stores_result){
+				a[lane] = blend(mask[lane], result, a[lane]);
+			}
+			f[lane] = blend(mask[lane], Instructions::ALU::Operations::apply_flags(f[lane], Operation::kept_flags, flags), f[lane]);
+		}
+	}
+
+	template<typename Operation>
+	void Lockstep::run_unary(int target, const LaneMask& mask){
+		uint8_t* value = registers[target].data();
+		uint8_t* f = registers[REGISTER_F].data();
+		for (int lane = 0; lane < MAX_INSTANCES; lane++){
+			uint8_t flags;
+			const uint8_t result = Operation::apply(value[lane], flags);
+			value[lane] = blend(mask[lane], result, value[lane]);
+			f[lane] = blend(mask[lane], Instructions::ALU::Operations::apply_flags(f[lane], Operation::kept_flags, flags), f[lane]);
+		}
+	}
+
+	void Lockstep::run_kernel(uint8_t opcode, const LaneMask& mask){
+		using namespace Instructions::ALU::Operations;
+		const int target = (opcode >> 3) & 7;
+		const int source = opcode & 7;
+		if (opcode == 0x00){
+			return;
+		}else if (opcode == 0x2F){
+			run_unary<Not>(REGISTER_A, mask);
+		}else if (opcode < 0x40){
+			if (source == 4){
+				run_unary<Increment>(target, mask);
+			}else{
+				run_unary<Decrement>(target, mask);
+			}
+		}else if (opcode < 0x80){
+			uint8_t* to = registers[target].data();
+			const uint8_t* from = registers[source].data();
+			for (int lane = 0; lane < MAX_INSTANCES; lane++){
+				to[lane] = blend(mask[lane], from[lane], to[lane]);
+			}
+		}else{
+			switch(target){
+			case 0: run_alu<Add<false>>(source, mask); break;
+			case 1: run_alu<Add<true>>(source, mask); break;
+			case 2: run_alu<Sub<false>>(source, mask); break;
+			case 3: run_alu<Sub<true>>(source, mask); break;
+			case 4: run_alu<And>(source, mask); break;
+			case 5: run_alu<Xor>(source, mask); break;
+			case 6: run_alu<Or>(source, mask); break;
+			case 7: run_alu<Compare>(source, mask); break;
+			}
+		}
+	}
+
+	void Lockstep::check_kernel(uint8_t opcode, const LaneMask& mask){
+		const Instructions::Instruction& instruction = Instructions::InstructionSet::instructions[opcode];
+		for (int lane = 0; lane < static_cast<int>(cpus.size()); lane++){
+			if (!mask[lane]) continue;
+			scatter(lane);
+			cpus[lane]->registers.pc++;
+			instruction.execute(*cpus[lane]);
+			cpus[lane]->clear_operand();
+		}
+
+		run_kernel(opcode, mask);
+
+		for (int lane = 0; lane < static_cast<int>(cpus.size()); lane++){
+			if (!mask[lane]) continue;
+			const CPU::Registers& expected = cpus[lane]->registers;
+			const bool matches = registers[0][lane] == expected.b && registers[1][lane] == expected.c
+				&& registers[2][lane] == expected.d && registers[3][lane] == expected.e
+				&& registers[4][lane] == expected.h && registers[5][lane] == expected.l
+				&& registers[REGISTER_A][lane] == expected.a && registers[REGISTER_F][lane] == expected.f;
+			if (!matches){
+				fprintf(stderr, "Lane kernel for 0x%02x (%s) doesn't match the handler: AF 0x%02x%02x, expected 0x%04x\n",
+						opcode, instruction.disassembly, registers[REGISTER_A][lane], registers[REGISTER_F][lane], expected.af);
+				cpus[lane]->stopped = true;
+			}
+		}
+	}
+}
@@ -1,4 +1,5 @@
 #include "gb/mbc.h"
+#include "gb/save_state.h"
 
 GB::MBC::MBC(std::vector<uint8_t> rom, uint8_t rom_bank_count, uint8_t ram_bank_count){
 	rom_banks.resize(rom_bank_count);
@@ -10,3 +11,9 @@ GB::MBC::MBC(std::vector<uint8_t> rom, uint8_t rom_bank_count, uint8_t ram_bank_
 
 	reset();
 }
+
+void GB::MBC::serialize(SaveState& state){
+	for (auto& bank : ram_banks){
+		state.value(bank);
+	}
+}
@@ -1,5 +1,6 @@
 #include "gb/mbc.h"
 #include "gb/cpu.h"
+#include "gb/save_state.h"
 
 #include <cstdio>
 
@@ -47,5 +48,14 @@ namespace GB{
 		mode_select_ram = false;
 		selected_rom_bank.bottom_five = 1;
 		selected_ram_bank = 0; // Also sets top two for rom bank
+		selected_rom_bank.dummy = 0; // Never read, but it's saved in states so it can't be left uninitialised
+	}
+
+	void MBC1::serialize(SaveState& state){
+		MBC::serialize(state);
+		state.value(enabled_ram);
+		// Covers the selected RAM bank as well, they share a byte
+		state.value(selected_rom_bank);
+		state.value(mode_select_ram);
 	}
 }
@@ -1,5 +1,6 @@
 #include "gb/mbc.h"
 #include "gb/cpu.h"
+#include "gb/save_state.h"
 #include <assert.h>
 
 namespace GB{
@@ -38,6 +39,22 @@ namespace GB{
 		selected_rom_bank = 1;
 	}
 
+	void MBC3::serialize(SaveState& state){
+		MBC::serialize(state);
+		state.value(ram_or_rtc_enabled);
+		state.value(rtc_mapped);
+		state.value(ram_bank_and_rtc_number);
+		state.value(latched);
+
+		// Bitfields can't be passed by reference
+		uint8_t rom_bank = selected_rom_bank;
+		uint8_t latch_status = latch_change_status;
+		state.value(rom_bank);
+		state.value(latch_status);
+		selected_rom_bank = rom_bank;
+		latch_change_status = latch_status;
+	}
+
 	uint8_t MBC3::read_ram_byte(uint16_t relative_address){
 		assert(ram_or_rtc_enabled);
 		if (rtc_mapped){
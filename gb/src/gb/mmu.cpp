@@ -3,6 +3,7 @@
 #include "gb/mmu.h"
 #include "gb/input.h"
 #include "gb/cpu.h"
+#include "gb/save_state.h"
 
 #include <assert.h>
 #include <memory>
@@ -91,6 +92,13 @@ namespace GB{
 		use_bios = true;
 	}
 
+	void MMU::serialize(SaveState& state){
+		state.value(use_bios);
+		state.value(int_ram);
+		state.value(io_ram);
+		state.value(dma_timer);
+	}
+
 	void MMU::write_byte(uint16_t address, uint8_t byte){
 		if (dma_timer >= 0 && address < ZP_RAM_START){
 			cpu.stopped = true;
@@ -131,6 +139,12 @@ namespace GB{
 			cpu.timer.write_modulo(byte);
 		}else if (address == TIMER_CONTROL_ADDRESS){
 			cpu.timer.write_control(byte);
+		}else if (address >= APU::REGISTERS_START && address <= APU::REGISTERS_END){
+			cpu.apu.write_register(address, byte);
+		}else if (address == SERIAL_DATA_ADDRESS){
+			cpu.serial.write_data(byte);
+		}else if (address == SERIAL_CONTROL_ADDRESS){
+			cpu.serial.write_control(byte);
 		}else{
 			*(map_address(address)) = byte;
 		}
@@ -167,6 +181,12 @@ namespace GB{
 			return cpu.timer.read_modulo();
 		}else if (address == TIMER_CONTROL_ADDRESS){
 			return cpu.timer.read_control();
+		}else if (address >= APU::REGISTERS_START && address <= APU::REGISTERS_END){
+			return cpu.apu.read_register(address);
+		}else if (address == SERIAL_DATA_ADDRESS){
+			return cpu.serial.read_data();
+		}else if (address == SERIAL_CONTROL_ADDRESS){
+			return cpu.serial.read_control();
 		}
 		return *(map_address(address));
 	}
@@ -176,6 +196,16 @@ namespace GB{
 		return static_cast<uint16_t>(first_byte) | (static_cast<uint16_t>(second_byte) << 8);
 	}
 
+	bool MMU::is_plain_ram(uint16_t address){
+		if (address < GPU_VRAM_START) return false;
+		if (address >= EXT_RAM_START && address < INT_RAM_START) return false;
+		if (address >= IO_RAM_START && address < ZP_RAM_START) return false;
+		return address != INTERRUPTS_ENABLED_ADDRESS;
+	}
+	uint8_t* MMU::map_plain_ram(uint16_t address){
+		return is_plain_ram(address) ? map_address(address) : nullptr;
+	}
+
     // Return a pointer to a byte in memory
 	uint8_t* MMU::map_address(uint16_t address){
 		if (use_bios && address < BIOS_SIZE){
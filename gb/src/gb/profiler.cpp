@@ -0,0 +1,104 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/profiler.h"
+#include "gb/mmu.h"
+#include "gb/instructions/instruction_set.h"
+
+#include <algorithm>
+#include <cinttypes>
+
+namespace GB{
+	Profiler::Profiler(){
+		reset();
+	}
+
+	void Profiler::reset(){
+		unbanked.fill(Counter{});
+		banked.clear();
+		opcodes.fill(Counter{});
+		current_location = nullptr;
+		current_opcode = nullptr;
+		total_instructions = 0;
+		total_cycles = 0;
+	}
+
+	void Profiler::begin_instruction(uint8_t rom_bank, uint16_t pc, uint8_t opcode, uint8_t cb_opcode){
+		if (pc >= MMU::ROM_BANK_ONE_START && pc < MMU::GPU_VRAM_START){
+			if (banked.size() <= rom_bank){
+				banked.resize(rom_bank + 1);
+			}
+			if (!banked[rom_bank]){
+				banked[rom_bank] = std::make_unique<std::array<Counter, 0x4000>>();
+			}
+			current_location = &(*banked[rom_bank])[pc - MMU::ROM_BANK_ONE_START];
+		}else{
+			current_location = &unbanked[pc];
+		}
+		current_location->opcode = opcode;
+		current_location->cb_opcode = cb_opcode;
+
+		current_opcode = &opcodes[opcode == 0xCB ? (0x100 + cb_opcode) : opcode];
+	}
+
+	void Profiler::print_report(FILE* file, size_t max_locations, size_t max_opcodes){
+		struct Location{
+			uint8_t rom_bank;
+			uint16_t pc;
+			const Counter* counter;
+		};
+		std::vector<Location> locations;
+		for (uint32_t pc = 0; pc < unbanked.size(); pc++){
+			if (unbanked[pc].instructions > 0)
+				locations.push_back({0, static_cast<uint16_t>(pc), &unbanked[pc]});
+		}
+		for (size_t bank = 0; bank < banked.size(); bank++){
+			if (!banked[bank]) continue;
+			for (uint16_t offset = 0; offset < banked[bank]->size(); offset++){
+				const Counter& counter = (*banked[bank])[offset];
+				if (counter.instructions > 0)
+					locations.push_back({static_cast<uint8_t>(bank), static_cast<uint16_t>(MMU::ROM_BANK_ONE_START + offset), &counter});
+			}
+		}
+		std::sort(locations.begin(), locations.end(), [](const Location& a, const Location& b){
+				return a.counter->cycles > b.counter->cycles;
+			});
+
+		const double cycle_percentage_scale = total_cycles ? (100.0 / total_cycles) : 0.0;
+
+		fprintf(file, "Profile: %" PRIu64 " instructions, %" PRIu64 " cycles\n", total_instructions, total_cycles);
+		fprintf(file, "Bank:PC      Instructions          Cycles  %%Cycles  Disassembly\n");
+		for (size_t i = 0; i < locations.size() && i < max_locations; i++){
+			const Location& location = locations[i];
+			fprintf(file, "0x%02x:0x%04x  %12" PRIu64 "  %14" PRIu64 "  %6.2f%%  %s\n",
+					location.rom_bank, location.pc,
+					location.counter->instructions, location.counter->cycles,
+					location.counter->cycles * cycle_percentage_scale,
+					Instructions::InstructionSet::find_instruction(location.counter->opcode, location.counter->cb_opcode)->disassembly);
+		}
+
+		std::vector<int> opcode_indices;
+		for (int i = 0; i < OPCODE_COUNT; i++){
+			if (opcodes[i].instructions > 0)
+				opcode_indices.push_back(i);
+		}
+		std::sort(opcode_indices.begin(), opcode_indices.end(), [this](int a, int b){
+				return opcodes[a].cycles > opcodes[b].cycles;
+			});
+
+		fprintf(file, "Opcode       Instructions          Cycles  %%Cycles  Disassembly\n");
+		for (size_t i = 0; i < opcode_indices.size() && i < max_opcodes; i++){
+			const int index = opcode_indices[i];
+			const uint8_t opcode = (index >= 0x100) ? 0xCB : index;
+			const uint8_t cb_opcode = index & 0xFF;
+			if (index >= 0x100){
+				fprintf(file, "0xcb 0x%02x    ", cb_opcode);
+			}else{
+				fprintf(file, "0x%02x         ", opcode);
+			}
+			fprintf(file, "%12" PRIu64 "  %14" PRIu64 "  %6.2f%%  %s\n",
+					opcodes[index].instructions, opcodes[index].cycles,
+					opcodes[index].cycles * cycle_percentage_scale,
+					Instructions::InstructionSet::find_instruction(opcode, cb_opcode)->disassembly);
+		}
+	}
+}
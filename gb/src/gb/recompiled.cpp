@@ -0,0 +1,61 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/recompiled.h"
+#include "gb/rom_data.h"
+
+#include <cstdio>
+#include <cstring>
+#include <dlfcn.h>
+
+namespace GB{
+	std::unique_ptr<RecompiledBlocks> RecompiledBlocks::load(const char* path, const std::vector<std::array<uint8_t, 0x4000>>& rom_banks){
+		void* handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+		if (handle == nullptr){
+			fprintf(stderr, "Couldn't load recompiled ROM '%s': %s\n", path, dlerror());
+			return nullptr;
+		}
+		// Owning the handle straight away means it's closed again on every failure below
+		std::unique_ptr<RecompiledBlocks> blocks(new RecompiledBlocks());
+		blocks->handle = handle;
+
+		const RecompiledRom* rom = reinterpret_cast<const RecompiledRom*>(dlsym(handle, RECOMPILED_ROM_SYMBOL));
+		if (rom == nullptr){
+			fprintf(stderr, "'%s' doesn't contain a recompiled ROM\n", path);
+			return nullptr;
+		}
+		if (rom->version != RECOMPILED_ROM_VERSION){
+			fprintf(stderr, "'%s' was made by a different version of the recompiler (%u, expected %u)\n", path, rom->version, RECOMPILED_ROM_VERSION);
+			return nullptr;
+		}
+
+		const uint8_t* header = rom_banks[0].data();
+		char rom_name[17] = {};
+		strncpy(rom_name, reinterpret_cast<const char*>(header) + RomData::ROM_OFFSET_NAME, 16);
+		const uint16_t global_checksum = (header[RomData::ROM_OFFSET_GLOBAL_CHECKSUM] << 8) | header[RomData::ROM_OFFSET_GLOBAL_CHECKSUM + 1];
+		if (strcmp(rom_name, rom->rom_name) != 0 || global_checksum != rom->global_checksum){
+			fprintf(stderr, "'%s' was made from a different ROM ('%s', checksum 0x%04x)\n", path, rom->rom_name, rom->global_checksum);
+			return nullptr;
+		}
+
+		blocks->banked.resize(rom_banks.size());
+		for (size_t i = 0; i < rom->block_count; i++){
+			const RecompiledBlockEntry& entry = rom->blocks[i];
+			if (entry.pc < 0x4000){
+				blocks->bank_zero[entry.pc] = entry.block;
+			}else if (entry.pc < 0x8000 && entry.rom_bank < rom_banks.size()){
+				auto& bank = blocks->banked[entry.rom_bank];
+				if (!bank) bank = std::make_unique<std::array<RecompiledBlock, 0x4000>>();
+				(*bank)[entry.pc - 0x4000] = entry.block;
+			}else{
+				continue;
+			}
+			blocks->count++;
+		}
+		fprintf(stdout, "Loaded %zu recompiled blocks from '%s'\n", blocks->count, path);
+		return blocks;
+	}
+
+	RecompiledBlocks::~RecompiledBlocks(){
+		if (handle != nullptr) dlclose(handle);
+	}
+}
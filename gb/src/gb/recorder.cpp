@@ -0,0 +1,193 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/recorder.h"
+#include "gb/apu.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+
+namespace GB{
+	static_assert(sizeof(AudioFrame) == 4, "The audio is written to the WAV file as it is in memory");
+
+	namespace{
+		// 4194304 / 70224 frames per second, reduced
+		constexpr unsigned int FRAME_RATE_NUMERATOR = 262144;
+		constexpr unsigned int FRAME_RATE_DENOMINATOR = 4389;
+		// Enough for a frame's audio at 48kHz with room to spare, so the vectors never grow once recording
+		constexpr size_t AUDIO_FRAMES_PER_SLOT = 2048;
+		// Big writes, so a long recording spends its time in the disk rather than in syscalls
+		constexpr size_t FILE_BUFFER_SIZE = 1 << 20;
+
+		void put_u16(uint8_t* out, uint16_t value){
+			out[0] = value & 0xFF;
+			out[1] = value >> 8;
+		}
+		void put_u32(uint8_t* out, uint32_t value){
+			put_u16(out, value & 0xFFFF);
+			put_u16(out + 2, value >> 16);
+		}
+	}
+
+	Recorder::Recorder(Policy policy) : policy(policy){}
+
+	std::unique_ptr<Recorder> Recorder::create(const char* video_path, const char* audio_path, Policy policy){
+		std::unique_ptr<Recorder> recorder(new Recorder(policy));
+		if (video_path){
+			recorder->video = fopen(video_path, "wb");
+			if (!recorder->video){
+				fprintf(stderr, "Couldn't open %s for the video: %s\n", video_path, strerror(errno));
+				return nullptr;
+			}
+			setvbuf(recorder->video, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+			fprintf(recorder->video, "YUV4MPEG2 W%d H%d F%u:%u Ip A1:1 Cmono\n",
+					GPU::SCREEN_WIDTH, GPU::SCREEN_HEIGHT, FRAME_RATE_NUMERATOR, FRAME_RATE_DENOMINATOR);
+		}
+		if (audio_path){
+			recorder->audio = fopen(audio_path, "wb");
+			if (!recorder->audio){
+				fprintf(stderr, "Couldn't open %s for the audio: %s\n", audio_path, strerror(errno));
+				return nullptr;
+			}
+			setvbuf(recorder->audio, nullptr, _IOFBF, FILE_BUFFER_SIZE);
+			// The sizes are filled in when the recording finishes
+			recorder->write_wav_header(0);
+		}
+
+		for (size_t i = 0; i < QUEUE_FRAMES; i++){
+			recorder->slots.emplace_back(new Slot());
+			recorder->slots.back()->audio.reserve(AUDIO_FRAMES_PER_SLOT);
+			Slot* slot = recorder->slots.back().get();
+			recorder->free_slots.push(&slot, 1);
+		}
+		recorder->pending_audio.reserve(AUDIO_FRAMES_PER_SLOT);
+
+		recorder->writer = std::thread(&Recorder::run_writer, recorder.get());
+		return recorder;
+	}
+
+	Recorder::~Recorder(){
+		if (writer.joinable()){
+			finishing.store(true, std::memory_order_release);
+			writer_wakeup.notify_one();
+			writer.join();
+		}
+		// Whatever played after the last frame
+		if (audio && !pending_audio.empty()){
+			write_audio(pending_audio);
+		}
+
+		if (audio){
+			// WAV sizes are 32 bits, so a recording past about 6 hours says it's shorter than it is
+			fflush(audio);
+			fseek(audio, 0, SEEK_SET);
+			write_wav_header(std::min<uint64_t>(audio_bytes, UINT32_MAX - 36));
+			fclose(audio);
+		}
+		if (video){
+			fclose(video);
+		}
+		if (frames_captured > 0){
+			fprintf(stdout, "Recorded %" PRIu64 " frames", frames_written.load());
+			if (frames_dropped > 0){
+				fprintf(stdout, ", %" PRIu64 " more were dropped because writing fell behind", frames_dropped);
+			}
+			fprintf(stdout, "\n");
+		}
+	}
+
+	void Recorder::capture_frame(const GPU& gpu){
+		frames_captured++;
+
+		Slot* slot;
+		while (free_slots.pop(&slot, 1) == 0){
+			if (policy == Policy::DropFrames){
+				frames_dropped++;
+				pending_audio.clear();
+				return;
+			}
+			writer_wakeup.notify_one();
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+
+		std::copy(std::begin(gpu.framebuffer), std::end(gpu.framebuffer), slot->framebuffer.begin());
+		// Swapping hands over the audio without copying it, and pending_audio gets the slot's empty vector to fill next
+		slot->audio.clear();
+		slot->audio.swap(pending_audio);
+
+		queued_slots.push(&slot, 1);
+		writer_wakeup.notify_one();
+	}
+
+	void Recorder::write_frames(const AudioFrame* frames, size_t count){
+		if (audio){
+			pending_audio.insert(pending_audio.end(), frames, frames + count);
+		}
+		if (next_sink){
+			next_sink->write_frames(frames, count);
+		}
+	}
+
+	void Recorder::run_writer(){
+		while (true){
+			Slot* slot;
+			if (queued_slots.pop(&slot, 1) == 1){
+				write_slot(*slot);
+				free_slots.push(&slot, 1);
+				frames_written.fetch_add(1, std::memory_order_relaxed);
+				continue;
+			}
+			// Checked after finding the queue empty, and the emulation thread has stopped queueing by the time it's set
+			if (finishing.load(std::memory_order_acquire) && queued_slots.size() == 0){
+				break;
+			}
+			// The timeout covers a notify that comes between finding the queue empty and starting to wait
+			std::unique_lock<std::mutex> lock(writer_mutex);
+			writer_wakeup.wait_for(lock, std::chrono::milliseconds(5));
+		}
+		if (video) fflush(video);
+		if (audio) fflush(audio);
+	}
+
+	void Recorder::write_slot(Slot& slot){
+		if (video){
+			// Y4M's mono is full range luma. The shades go from 0 (white) to 3 (black), the same as the window draws them.
+			std::array<uint8_t, GPU::SCREEN_WIDTH * GPU::SCREEN_HEIGHT> luma;
+			for (size_t i = 0; i < luma.size(); i++){
+				luma[i] = static_cast<uint8_t>(255 - static_cast<int>(slot.framebuffer[i]) * 85);
+			}
+			fputs("FRAME\n", video);
+			fwrite(luma.data(), 1, luma.size(), video);
+		}
+		if (audio){
+			write_audio(slot.audio);
+		}
+	}
+
+	void Recorder::write_audio(const std::vector<AudioFrame>& frames){
+		// WAV is little endian, like AudioFrame on the hosts this runs on
+		fwrite(frames.data(), sizeof(AudioFrame), frames.size(), audio);
+		audio_bytes += frames.size() * sizeof(AudioFrame);
+	}
+
+	void Recorder::write_wav_header(uint32_t data_size){
+		constexpr uint16_t CHANNELS = 2;
+		constexpr uint16_t BITS = 16;
+		uint8_t header[44];
+		memcpy(header, "RIFF", 4);
+		put_u32(header + 4, 36 + data_size);
+		memcpy(header + 8, "WAVEfmt ", 8);
+		put_u32(header + 16, 16);
+		put_u16(header + 20, 1); // PCM
+		put_u16(header + 22, CHANNELS);
+		put_u32(header + 24, APU::SAMPLE_RATE);
+		put_u32(header + 28, APU::SAMPLE_RATE * CHANNELS * BITS / 8);
+		put_u16(header + 32, CHANNELS * BITS / 8);
+		put_u16(header + 34, BITS);
+		memcpy(header + 36, "data", 4);
+		put_u32(header + 40, data_size);
+		fwrite(header, 1, sizeof(header), audio);
+	}
+}
@@ -0,0 +1,102 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/serial.h"
+#include "gb/link_cable.h"
+#include "gb/cpu.h"
+#include "gb/save_state.h"
+
+#include <thread>
+
+namespace GB{
+	void Serial::step(){
+		if (transfer_cycles_left > 0){
+			transfer_cycles_left -= cpu.clock_cycles_this_step;
+			if (transfer_cycles_left <= 0){
+				finish_transfer(cable ? wait_for_reply() : 0xFF);
+			}
+		}
+
+		if (!cable) return;
+
+		// A port waiting for the external clock checks every step, so it answers as soon as the master sends.
+		// Otherwise it only checks occasionally, to tell a master on the other side that nobody's listening.
+		poll_cycles_left -= cpu.clock_cycles_this_step;
+		if (poll_cycles_left <= 0 || (transfer_requested && !internal_clock)){
+			poll_cycles_left = CABLE_POLL_CYCLES;
+			answer_request();
+		}
+	}
+
+	void Serial::reset(){
+		data = 0;
+		transfer_requested = false;
+		internal_clock = false;
+		transfer_cycles_left = 0;
+		poll_cycles_left = CABLE_POLL_CYCLES;
+	}
+
+	// The cable isn't part of the state, a restored port stays connected to whatever it was connected to
+	void Serial::serialize(SaveState& state){
+		state.value(data);
+		state.value(transfer_requested);
+		state.value(internal_clock);
+		state.value(transfer_cycles_left);
+		state.value(poll_cycles_left);
+	}
+
+	void Serial::connect(LinkCable& new_cable, int new_side){
+		cable = &new_cable;
+		side = new_side;
+		cable->connect(side);
+	}
+	void Serial::disconnect(){
+		if (!cable) return;
+		cable->disconnect(side);
+		cable = nullptr;
+	}
+
+	void Serial::write_control(uint8_t new_value){
+		transfer_requested = new_value & 0x80;
+		internal_clock = new_value & 0x01;
+		if (transfer_requested && internal_clock){
+			transfer_cycles_left = TRANSFER_CYCLES;
+			if (cable) cable->send_request(side, data);
+		}else{
+			transfer_cycles_left = 0;
+		}
+	}
+
+	void Serial::finish_transfer(uint8_t received){
+		data = received;
+		transfer_requested = false;
+		transfer_cycles_left = 0;
+		cpu.interrupts.trigger(Interrupt::Serial);
+	}
+
+	void Serial::answer_request(){
+		uint8_t received;
+		if (!cable->take_request(side, received)) return;
+
+		if (transfer_requested && !internal_clock){
+			cable->send_reply(side, data);
+			finish_transfer(received);
+		}else{
+			// Nothing is shifting on this side, so the master reads 1s
+			cable->send_reply(side, 0xFF);
+		}
+	}
+
+	uint8_t Serial::wait_for_reply(){
+		// This is the only place either side waits for the other, so timing is only kept in step when a byte actually crosses the cable
+		uint8_t received;
+		while (!cable->take_reply(side, received)){
+			// The other side might be a master waiting on this side at the same time
+			answer_request();
+			if (!cable->is_connected(LinkCable::other_side(side))){
+				return cable->take_reply(side, received) ? received : 0xFF;
+			}
+			std::this_thread::yield();
+		}
+		return received;
+	}
+}
@@ -0,0 +1,203 @@
+// Copyright Samuel Stark 2017
+
+#include "gb/shared_memory_export.h"
+#include "gb/cpu.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace GB{
+	using namespace SharedExportLayout;
+
+	std::unique_ptr<SharedMemoryExport> SharedMemoryExport::create(const char* name, const std::vector<RamWindow>& windows){
+		if (windows.size() > MAX_RAM_REGIONS){
+			fprintf(stderr, "Can't export more than %d RAM windows\n", MAX_RAM_REGIONS);
+			return nullptr;
+		}
+		for (const RamWindow& window : windows){
+			if (!is_plain_ram(window)){
+				fprintf(stderr, "Can't export %04x:%x, it has to be VRAM, work RAM, sprite info or HRAM\n", window.start, window.length);
+				return nullptr;
+			}
+		}
+
+		// Work out where everything goes in a slot. Slots are kept 64-byte aligned so their sequence counters don't share cache lines.
+		size_t slot_size = sizeof(Slot) + FRAMEBUFFER_SIZE;
+		std::vector<RamRegion> regions;
+		for (const RamWindow& window : windows){
+			regions.push_back(RamRegion{window.start, window.length, static_cast<uint32_t>(slot_size)});
+			slot_size += window.length;
+		}
+		slot_size = (slot_size + alignof(Slot) - 1) & ~(alignof(Slot) - 1);
+		const size_t size = sizeof(Header) + SLOT_COUNT * slot_size;
+
+		int fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+		if (fd < 0){
+			fprintf(stderr, "Couldn't create shared memory '%s': %s\n", name, strerror(errno));
+			return nullptr;
+		}
+		if (ftruncate(fd, size) != 0){
+			fprintf(stderr, "Couldn't resize shared memory '%s': %s\n", name, strerror(errno));
+			close(fd);
+			shm_unlink(name);
+			return nullptr;
+		}
+		void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED){
+			fprintf(stderr, "Couldn't map shared memory '%s': %s\n", name, strerror(errno));
+			shm_unlink(name);
+			return nullptr;
+		}
+
+		std::unique_ptr<SharedMemoryExport> shared_export(new SharedMemoryExport());
+		shared_export->name = name;
+		shared_export->data = static_cast<uint8_t*>(mapping);
+		shared_export->size = size;
+		memset(shared_export->data, 0, size);
+
+		// The magic is written last, so a reader that opens the segment early doesn't see a half filled in header
+		Header* header = new (shared_export->data) Header();
+		header->version = VERSION;
+		header->slot_count = SLOT_COUNT;
+		header->slot_size = slot_size;
+		header->width = GPU::SCREEN_WIDTH;
+		header->height = GPU::SCREEN_HEIGHT;
+		header->ram_region_count = regions.size();
+		std::copy(regions.begin(), regions.end(), header->ram_regions);
+		header->latest_slot.store(-1, std::memory_order_relaxed);
+		shared_export->header = header;
+		for (int i = 0; i < SLOT_COUNT; i++){
+			new (shared_export->slot(i)) Slot();
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+		header->magic = MAGIC;
+
+		fprintf(stdout, "Exporting frames to shared memory '%s' (%zu bytes)\n", name, size);
+		return shared_export;
+	}
+
+	SharedMemoryExport::~SharedMemoryExport(){
+		munmap(data, size);
+		shm_unlink(name.c_str());
+	}
+
+	void SharedMemoryExport::publish(CPU& cpu){
+		frame_number++;
+
+		// Never the latest slot, which readers are going to, and never the one before it, which a slow reader might still be in
+		const int latest = header->latest_slot.load(std::memory_order_relaxed);
+		const int index = (latest + 1) % SLOT_COUNT;
+		Slot* target = slot(index);
+		uint8_t* slot_data = reinterpret_cast<uint8_t*>(target);
+
+		const uint64_t sequence = target->sequence.load(std::memory_order_relaxed);
+		target->sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		target->frame_number = frame_number;
+		uint8_t* framebuffer = slot_data + sizeof(Slot);
+		for (size_t i = 0; i < FRAMEBUFFER_SIZE; i++){
+			framebuffer[i] = static_cast<uint8_t>(cpu.gpu.framebuffer[i]);
+		}
+		for (uint32_t i = 0; i < header->ram_region_count; i++){
+			const RamRegion& region = header->ram_regions[i];
+			uint8_t* ram = slot_data + region.slot_offset;
+			// Straight from the backing arrays, read_byte could have side effects (or stop the CPU during an OAM DMA)
+			for (uint32_t offset = 0; offset < region.length; offset++){
+				ram[offset] = *cpu.mmu.map_plain_ram(region.start + offset);
+			}
+		}
+
+		target->sequence.store(sequence + 2, std::memory_order_release);
+		header->latest_slot.store(index, std::memory_order_release);
+	}
+
+	bool SharedMemoryExport::parse_window(const char* text, RamWindow& window){
+		char* end = nullptr;
+		const unsigned long start = strtoul(text, &end, 16);
+		if (end == text || *end != ':') return false;
+		const char* length_text = end + 1;
+		const unsigned long length = strtoul(length_text, &end, 16);
+		if (end == length_text || *end != '\0') return false;
+		if (length == 0 || start + length > 0x10000) return false;
+
+		window.start = start;
+		window.length = length;
+		return is_plain_ram(window);
+	}
+	bool SharedMemoryExport::is_plain_ram(const RamWindow& window){
+		for (uint32_t address = window.start; address < window.start + window.length; address++){
+			if (!MMU::is_plain_ram(address)) return false;
+		}
+		return true;
+	}
+
+	std::unique_ptr<SharedMemoryReader> SharedMemoryReader::open(const char* name){
+		int fd = shm_open(name, O_RDONLY, 0);
+		if (fd < 0) return nullptr;
+		struct stat info;
+		if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)){
+			close(fd);
+			return nullptr;
+		}
+		void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (mapping == MAP_FAILED) return nullptr;
+
+		std::unique_ptr<SharedMemoryReader> reader(new SharedMemoryReader());
+		reader->data = static_cast<uint8_t*>(mapping);
+		reader->size = info.st_size;
+		reader->header = reinterpret_cast<const Header*>(mapping);
+		if (reader->header->magic != MAGIC || reader->header->version != VERSION){
+			fprintf(stderr, "'%s' isn't a compatible GameBoy export\n", name);
+			return nullptr;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return reader;
+	}
+
+	SharedMemoryReader::~SharedMemoryReader(){
+		munmap(data, size);
+	}
+
+	size_t SharedMemoryReader::ram_size() const{
+		size_t total = 0;
+		for (uint32_t i = 0; i < header->ram_region_count; i++){
+			total += header->ram_regions[i].length;
+		}
+		return total;
+	}
+
+	uint64_t SharedMemoryReader::read_latest(uint8_t* framebuffer, uint8_t* ram){
+		const size_t ram_length = ram_size();
+		while (true){
+			const int index = header->latest_slot.load(std::memory_order_acquire);
+			if (index < 0) return 0;
+
+			const Slot* source = slot(index);
+			const uint8_t* slot_data = reinterpret_cast<const uint8_t*>(source);
+			const uint64_t sequence = source->sequence.load(std::memory_order_acquire);
+			if (sequence & 1) continue;
+
+			const uint64_t frame_number = source->frame_number;
+			memcpy(framebuffer, slot_data + sizeof(Slot), FRAMEBUFFER_SIZE);
+			// The regions are next to each other, straight after the framebuffer
+			memcpy(ram, slot_data + sizeof(Slot) + FRAMEBUFFER_SIZE, ram_length);
+
+			// If the emulator lapped us while copying, the copy could be torn
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (source->sequence.load(std::memory_order_relaxed) == sequence){
+				return frame_number;
+			}
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #include "gb/timer.h"
 #include "gb/cpu.h"
+#include "gb/save_state.h"
 
 namespace GB{
 	void Timer::step(){		
@@ -65,4 +66,15 @@ namespace GB{
 		control.enabled = false;
 		control.speed = Timer::Speed::x1;
 	}
+
+	void Timer::serialize(SaveState& state){
+		state.value(divider);
+		state.value(counter);
+		state.value(modulo);
+		state.value(predivider);
+		state.value(divider_predivider);
+		// One at a time, so the padding in control isn't saved
+		state.value(control.enabled);
+		state.value(control.speed);
+	}
 }
@@ -2,19 +2,43 @@
 
 #include "gb/cpu.h"
 #include "gb/gpu.h"
+#include "gb/link_cable.h"
+#include "gb/audio_sink.h"
+#include "gb/shared_memory_export.h"
+#include "gb/control_server.h"
+#include "gb/recorder.h"
 
+#include <algorithm>
 #include <assert.h>
+#include <atomic>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 #include <string>
+#include <thread>
 
 #include "SDL.h"
-#include "timer.h"
 
 SDL_Window* window = nullptr;
 SDL_Renderer* renderer = nullptr;
 SDL_Texture* texture = nullptr;
 SDL_Joystick* controller = nullptr;
+SDL_AudioDeviceID audio_device = 0;
+GB::RingBufferAudioSink audio_sink;
+// Only set with --shm
+std::unique_ptr<GB::SharedMemoryExport> shared_export;
+// Only set with --record-video or --record-audio
+std::unique_ptr<GB::Recorder> recorder;
+// Only set with --control, which runs without a window
+std::unique_ptr<GB::ControlServer> control_server;
+
+// The second GameBoy when --link is used. It runs on its own thread, so the main thread only talks to it once per frame.
+GB::CPU* linked_cpu = nullptr;
+std::mutex linked_framebuffer_mutex;
+GB::GPU::Pixel linked_framebuffer[GB::GPU::SCREEN_WIDTH * GB::GPU::SCREEN_HEIGHT];
+// The pressed buttons, in the same bits as Input::set_pressed()
+std::atomic<uint8_t> linked_input_state(0);
+bool keyboard_controls_linked = false;
 
 int sdl_setup(int width, int height){
 	/* Initialize SDL. */
@@ -69,7 +93,35 @@ int sdl_setup(int width, int height){
 
 	return 0;
 }
+// Runs on SDL's audio thread, and only ever reads from the ring buffer
+void sdl_audio_callback(void* userdata, Uint8* stream, int length){
+	GB::AudioFrame* frames = reinterpret_cast<GB::AudioFrame*>(stream);
+	const size_t frame_count = length / sizeof(GB::AudioFrame);
+	const size_t read = audio_sink.read_frames(frames, frame_count);
+	// If the emulator fell behind, play silence rather than waiting for it
+	std::fill(frames + read, frames + frame_count, GB::AudioFrame{0, 0});
+}
+int sdl_audio_setup(){
+	SDL_AudioSpec desired = {};
+	desired.freq = GB::APU::SAMPLE_RATE;
+	desired.format = AUDIO_S16SYS;
+	desired.channels = 2;
+	desired.samples = 1024;
+	desired.callback = sdl_audio_callback;
+	audio_device = SDL_OpenAudioDevice(nullptr, 0, &desired, nullptr, 0);
+	if (audio_device == 0){
+		fprintf(stderr, "Failed to open audio device: %s\n", SDL_GetError());
+		return 1;
+	}
+	SDL_PauseAudioDevice(audio_device, 0);
+	return 0;
+}
+
 void sdl_cleanup(){
+	if (audio_device != 0){
+		SDL_CloseAudioDevice(audio_device);
+		audio_device = 0;
+	}
 	SDL_JoystickClose(controller);
 	controller = nullptr;
 	SDL_DestroyTexture(texture);
@@ -80,7 +132,31 @@ void sdl_cleanup(){
 	window = nullptr;
 }
 
-static bool wants_quit = false;
+static std::atomic<bool> wants_quit(false);
+
+void set_direction(GB::CPU& cpu, GB::Input::Direction direction, bool down){
+	if (keyboard_controls_linked){
+		const uint8_t bit = 1 << static_cast<int>(direction);
+		if (down) linked_input_state |= bit;
+		else linked_input_state &= ~bit;
+	}else if (down){
+		cpu.input.on_direction_down(direction);
+	}else{
+		cpu.input.on_direction_up(direction);
+	}
+}
+void set_button(GB::CPU& cpu, GB::Input::Button button, bool down){
+	if (keyboard_controls_linked){
+		const uint8_t bit = 1 << (4 + static_cast<int>(button));
+		if (down) linked_input_state |= bit;
+		else linked_input_state &= ~bit;
+	}else if (down){
+		cpu.input.on_button_down(button);
+	}else{
+		cpu.input.on_button_up(button);
+	}
+}
+
 void test_input(GB::CPU& cpu){
 	constexpr int JOYSTICK_DEADZONE = 8000;
 	
@@ -91,29 +167,39 @@ void test_input(GB::CPU& cpu){
 		else if (keyevent.type == SDL_KEYDOWN){
 			switch(keyevent.key.keysym.sym){
 			case SDLK_UP:
-				cpu.input.on_direction_down(GB::Input::Direction::Up);
+				set_direction(cpu, GB::Input::Direction::Up, true);
 				break;
 			case SDLK_DOWN:
-				cpu.input.on_direction_down(GB::Input::Direction::Down);
+				set_direction(cpu, GB::Input::Direction::Down, true);
 				break;
 			case SDLK_LEFT:
-				cpu.input.on_direction_down(GB::Input::Direction::Left);
+				set_direction(cpu, GB::Input::Direction::Left, true);
 				break;
 			case SDLK_RIGHT:
-				cpu.input.on_direction_down(GB::Input::Direction::Right);
+				set_direction(cpu, GB::Input::Direction::Right, true);
 				break;
 			case SDLK_RETURN:
-				cpu.input.on_button_down(GB::Input::Button::Start);
+				set_button(cpu, GB::Input::Button::Start, true);
 				break;
 			case SDLK_RSHIFT:
-				cpu.input.on_button_down(GB::Input::Button::Select);
+				set_button(cpu, GB::Input::Button::Select, true);
 				break;
 			case SDLK_a:
-				cpu.input.on_button_down(GB::Input::Button::A);
+				set_button(cpu, GB::Input::Button::A, true);
 				break;
 			case SDLK_s:
 			case SDLK_b:
-				cpu.input.on_button_down(GB::Input::Button::B);
+				set_button(cpu, GB::Input::Button::B, true);
+				break;
+			case SDLK_p:
+				if (cpu.is_profiling())
+					cpu.print_profile(stdout);
+				break;
+			case SDLK_TAB:
+				if (linked_cpu){
+					keyboard_controls_linked = !keyboard_controls_linked;
+					fprintf(stdout, "Keyboard now controls the %s GameBoy\n", keyboard_controls_linked ? "right" : "left");
+				}
 				break;
 			default:
 				break;
@@ -121,29 +207,29 @@ void test_input(GB::CPU& cpu){
 		}else if (keyevent.type == SDL_KEYUP){
 			switch(keyevent.key.keysym.sym){
 			case SDLK_UP:
-				cpu.input.on_direction_up(GB::Input::Direction::Up);
+				set_direction(cpu, GB::Input::Direction::Up, false);
 				break;
 			case SDLK_DOWN:
-				cpu.input.on_direction_up(GB::Input::Direction::Down);
+				set_direction(cpu, GB::Input::Direction::Down, false);
 				break;
 			case SDLK_LEFT:
-				cpu.input.on_direction_up(GB::Input::Direction::Left);
+				set_direction(cpu, GB::Input::Direction::Left, false);
 				break;
 			case SDLK_RIGHT:
-				cpu.input.on_direction_up(GB::Input::Direction::Right);
+				set_direction(cpu, GB::Input::Direction::Right, false);
 				break;
 			case SDLK_RETURN:
-				cpu.input.on_button_up(GB::Input::Button::Start);
+				set_button(cpu, GB::Input::Button::Start, false);
 				break;
 			case SDLK_RSHIFT:
-				cpu.input.on_button_up(GB::Input::Button::Select);
+				set_button(cpu, GB::Input::Button::Select, false);
 				break;
 			case SDLK_a:
-				cpu.input.on_button_up(GB::Input::Button::A);
+				set_button(cpu, GB::Input::Button::A, false);
 				break;
 			case SDLK_s:
 			case SDLK_b:
-				cpu.input.on_button_up(GB::Input::Button::B);
+				set_button(cpu, GB::Input::Button::B, false);
 				break;
 			default:
 				break;
@@ -175,29 +261,35 @@ void test_input(GB::CPU& cpu){
 	}
 }
 
+// Called on the linked GameBoy's thread
+void linked_update(GB::CPU& cpu){
+	cpu.input.set_pressed(linked_input_state.load(std::memory_order_relaxed));
+
+	std::lock_guard<std::mutex> lock(linked_framebuffer_mutex);
+	std::copy(std::begin(cpu.gpu.framebuffer), std::end(cpu.gpu.framebuffer), std::begin(linked_framebuffer));
+}
+
+uint32_t pixel_to_rgba(SDL_PixelFormat* pixelFormat, GB::GPU::Pixel pixel){
+	uint8_t color = 255 * (static_cast<int>(pixel) * 1.0f/3);
+	color = 255 - color;
+	return SDL_MapRGBA(pixelFormat, color, color, color, 0);
+}
+
 void sdl_update_window(GB::CPU& cpu){
 	
 	test_input(cpu);
 
+	if (shared_export)
+		shared_export->publish(cpu);
+	if (recorder)
+		recorder->capture_frame(cpu.gpu);
+
 	GB::GPU& gpu = cpu.gpu;
 	
 	uint32_t* pixels = nullptr;
 	int pitch = 0;
 	uint32_t format;
 
-	/*static t_sl_timer sdl_timer;
-	static t_sl_timer sdl_frame_timer;
-	static int sdl_timer_count;
-	if (sdl_timer_count==0) {
-		SL_TIMER_EXIT(sdl_frame_timer);
-		fprintf(stderr,"Each of 100 ticks took %fms\n", SL_TIMER_VALUE_US(sdl_timer) / 1000.f / 100);
-		fprintf(stderr,"100 Frames each took %fms\n", SL_TIMER_VALUE_US(sdl_frame_timer) / 1000.f / 100);
-		SL_TIMER_INIT(sdl_timer);
-		SL_TIMER_INIT(sdl_frame_timer);
-		SL_TIMER_ENTRY(sdl_frame_timer);
-	}
-	sdl_timer_count = (sdl_timer_count+1) % 100;
-	SL_TIMER_ENTRY(sdl_timer);*/
 	SDL_QueryTexture(texture, &format, nullptr, nullptr, nullptr);
 	if (SDL_LockTexture(texture, nullptr, (void**)&pixels, &pitch))
 	{
@@ -207,17 +299,49 @@ void sdl_update_window(GB::CPU& cpu){
 	
 	SDL_PixelFormat* pixelFormat = SDL_AllocFormat(format);
 
-	for (int pixelPosition = 0; pixelPosition < GB::GPU::SCREEN_WIDTH * GB::GPU::SCREEN_HEIGHT; pixelPosition++){
-		uint8_t color = 255 * (static_cast<int>(gpu.framebuffer[pixelPosition]) * 1.0f/3);
-		color = 255 - color;
-		pixels[pixelPosition] = SDL_MapRGBA(pixelFormat, color, color, color, 0);
+	if (linked_cpu){
+		// Both screens side by side, this one on the left
+		const int row_length = pitch / sizeof(uint32_t);
+		std::lock_guard<std::mutex> lock(linked_framebuffer_mutex);
+		for (int y = 0; y < GB::GPU::SCREEN_HEIGHT; y++){
+			for (int x = 0; x < GB::GPU::SCREEN_WIDTH; x++){
+				const int pixelPosition = y * GB::GPU::SCREEN_WIDTH + x;
+				pixels[y * row_length + x] = pixel_to_rgba(pixelFormat, gpu.framebuffer[pixelPosition]);
+				pixels[y * row_length + GB::GPU::SCREEN_WIDTH + x] = pixel_to_rgba(pixelFormat, linked_framebuffer[pixelPosition]);
+			}
+		}
+	}else{
+		for (int pixelPosition = 0; pixelPosition < GB::GPU::SCREEN_WIDTH * GB::GPU::SCREEN_HEIGHT; pixelPosition++){
+			pixels[pixelPosition] = pixel_to_rgba(pixelFormat, gpu.framebuffer[pixelPosition]);
+		}
 	}
 
 	SDL_UnlockTexture(texture);
 	
 	SDL_RenderCopy(renderer, texture, nullptr, nullptr);
 	SDL_RenderPresent(renderer);
-	//SL_TIMER_EXIT(sdl_timer);
+}
+
+// on_vblank when running under --control
+void control_update(GB::CPU& cpu){
+	control_server->on_frame();
+	if (shared_export)
+		shared_export->publish(cpu);
+	if (recorder)
+		recorder->capture_frame(cpu.gpu);
+}
+
+std::vector<uint8_t> load_rom(const char* rom_path){
+	std::vector<uint8_t> rom;
+	std::ifstream rom_file(rom_path, std::ios::binary);
+	rom_file >> std::noskipws;
+	rom_file.seekg(0, std::ios::end);
+	rom.reserve(rom_file.tellg());
+	rom_file.seekg(0, std::ios::beg);
+	rom.insert(rom.begin(),
+			   std::istreambuf_iterator<char>(rom_file),
+               std::istreambuf_iterator<char>());
+	return rom;
 }
 
 int main(int argc, char* argv[]){
@@ -231,31 +355,156 @@ int main(int argc, char* argv[]){
 	bios_file.read(reinterpret_cast<char*>(bios.data()), bios.size());
 	
 	const char* rom_path = argv[2];
-	std::vector<uint8_t> rom;
-	std::ifstream rom_file(rom_path, std::ios::binary);
-	rom_file >> std::noskipws;
-	rom_file.seekg(0, std::ios::end);
-	rom.reserve(rom_file.tellg());
-	rom_file.seekg(0, std::ios::beg);
-	rom.insert(rom.begin(),
-			   std::istreambuf_iterator<char>(rom_file),
-               std::istreambuf_iterator<char>());
+	std::vector<uint8_t> rom = load_rom(rom_path);
 
-	if (argc >= 4 && strcmp(argv[3], "--no-limit") == 0)
-		GB::CPU::limit_fps = false;
+	bool debug_step = false;
+	bool profile = false;
+	const char* linked_rom_path = nullptr;
+	bool audio = true;
+	const char* recompiled_path = nullptr;
+	const char* shm_name = nullptr;
+	std::vector<GB::SharedMemoryExport::RamWindow> shm_windows;
+	const char* control_path = nullptr;
+	bool timings = false;
+	const char* trace_path = nullptr;
+	unsigned long trace_first_frame = 60, trace_frame_count = 5;
+	const char* video_path = nullptr;
+	const char* wav_path = nullptr;
+	GB::Recorder::Policy record_policy = GB::Recorder::Policy::DropFrames;
+	for (int i = 3; i < argc; i++){
+		if (strcmp(argv[i], "--no-limit") == 0)
+			GB::CPU::limit_fps = false;
+		else if (strcmp(argv[i], "--debug") == 0)
+			debug_step = true;
+		else if (strcmp(argv[i], "--profile") == 0)
+			profile = true;
+		else if (strcmp(argv[i], "--link") == 0 && i + 1 < argc)
+			linked_rom_path = argv[++i];
+		else if (strcmp(argv[i], "--no-audio") == 0)
+			audio = false;
+		else if (strcmp(argv[i], "--recompiled") == 0 && i + 1 < argc)
+			recompiled_path = argv[++i];
+		else if (strcmp(argv[i], "--shm") == 0 && i + 1 < argc)
+			shm_name = argv[++i];
+		else if (strcmp(argv[i], "--shm-ram") == 0 && i + 1 < argc){
+			GB::SharedMemoryExport::RamWindow window;
+			if (GB::SharedMemoryExport::parse_window(argv[++i], window))
+				shm_windows.push_back(window);
+			else
+				fprintf(stderr, "Ignoring RAM window '%s', it should look like C000:2000 and only cover VRAM, work RAM, sprite info or HRAM\n", argv[i]);
+		}else if (strcmp(argv[i], "--control") == 0 && i + 1 < argc)
+			control_path = argv[++i];
+		else if (strcmp(argv[i], "--timings") == 0)
+			timings = true;
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc)
+			trace_path = argv[++i];
+		else if (strcmp(argv[i], "--trace-frames") == 0 && i + 1 < argc){
+			if (sscanf(argv[++i], "%lu:%lu", &trace_first_frame, &trace_frame_count) != 2 || trace_frame_count == 0)
+				fprintf(stderr, "Ignoring trace frames '%s', it should look like 60:5\n", argv[i]);
+		}else if (strcmp(argv[i], "--record-video") == 0 && i + 1 < argc)
+			video_path = argv[++i];
+		else if (strcmp(argv[i], "--record-audio") == 0 && i + 1 < argc)
+			wav_path = argv[++i];
+		else if (strcmp(argv[i], "--record-lossless") == 0)
+			record_policy = GB::Recorder::Policy::Block;
+	}
 	
+	/* Under --control the clients decide when the CPU runs, as fast as it can, and nothing is shown */
+	if (control_path){
+		control_server = GB::ControlServer::create(control_path);
+		if (!control_server)
+			return 1;
+		GB::CPU::limit_fps = false;
+	}
+
 	/* Create the CPU */
-	GB::CPU cpu(std::move(bios), std::move(rom), sdl_update_window);
+	GB::CPU cpu(bios, std::move(rom), control_server ? control_update : sdl_update_window, debug_step, profile);
 	cpu.reset();
+	if (recompiled_path && !cpu.load_recompiled(recompiled_path))
+		fprintf(stderr, "Running %s without recompiled blocks\n", rom_path);
 	//cpu.check_instructions();
 	//return 0;
 	//cpu.manual_step_requested = true;
 	cpu.exit_bios();
 	cpu.registers.pc = 0x100;
+
+	/* Time where the host spends each frame */
+	if (timings || trace_path){
+		if (GB::Instrumentation::compiled_in){
+			cpu.instrumentation = std::make_unique<GB::Instrumentation>();
+			if (trace_path)
+				cpu.instrumentation->trace_frames(trace_path, trace_first_frame, trace_frame_count);
+		}else{
+			fprintf(stderr, "Ignoring --timings and --trace, the timers are only compiled in with make INSTRUMENT=1\n");
+		}
+	}
+
+	/* Export frames for other processes. By default that's with all of WRAM and HRAM */
+	if (shm_name){
+		if (shm_windows.empty()){
+			shm_windows.push_back({GB::MMU::INT_RAM_START, GB::MMU::INT_RAM_MIRROR_START - GB::MMU::INT_RAM_START});
+			shm_windows.push_back({GB::MMU::ZP_RAM_START, GB::MMU::INTERRUPTS_ENABLED_ADDRESS - GB::MMU::ZP_RAM_START});
+		}
+		shared_export = GB::SharedMemoryExport::create(shm_name, shm_windows);
+	}
+
+	/* Record the first GameBoy's screen and sound */
+	if (video_path || wav_path){
+		recorder = GB::Recorder::create(video_path, wav_path, record_policy);
+		if (!recorder)
+			return 1;
+		if (wav_path)
+			cpu.apu.set_sink(*recorder);
+	}
+
+	/* Create the second CPU, connected by a link cable and running on its own thread */
+	GB::LinkCable link_cable;
+	std::unique_ptr<GB::CPU> second_cpu;
+	std::thread second_cpu_thread;
+	if (linked_rom_path){
+		second_cpu = std::make_unique<GB::CPU>(bios, load_rom(linked_rom_path), linked_update);
+		second_cpu->reset();
+		second_cpu->exit_bios();
+		second_cpu->registers.pc = 0x100;
+		linked_cpu = second_cpu.get();
+
+		cpu.serial.connect(link_cable, 0);
+		second_cpu->serial.connect(link_cable, 1);
+		second_cpu_thread = std::thread([](GB::CPU* linked){
+				while(!linked->stopped && !wants_quit){
+					linked->step();
+				}
+				// Don't leave the other side waiting for a reply that will never come
+				linked->serial.disconnect();
+			}, linked_cpu);
+	}
 	
+	if (control_server){
+		control_server->run(cpu);
+		wants_quit = true;
+		cpu.serial.disconnect();
+		if (second_cpu_thread.joinable())
+			second_cpu_thread.join();
+		if (cpu.is_profiling())
+			cpu.print_profile(stdout);
+		if (timings && cpu.instrumentation)
+			cpu.instrumentation->print_report(stdout);
+		recorder.reset();
+		return 0;
+	}
+
 	/* Setup the Graphics */
-	if (sdl_setup(GB::GPU::SCREEN_WIDTH, GB::GPU::SCREEN_HEIGHT) == 1)
+	const int screen_count = linked_cpu ? 2 : 1;
+	if (sdl_setup(GB::GPU::SCREEN_WIDTH * screen_count, GB::GPU::SCREEN_HEIGHT) == 1)
 		return 1;
+
+	/* Setup the Audio. Only the first GameBoy is heard, the linked one keeps the default null sink */
+	if (audio && sdl_audio_setup() == 0){
+		if (recorder && wav_path)
+			recorder->forward_audio_to(&audio_sink);
+		else
+			cpu.apu.set_sink(audio_sink);
+	}
 	
 	while(!cpu.stopped && !wants_quit){
 		if (cpu.manual_step_requested){
@@ -270,7 +519,13 @@ int main(int argc, char* argv[]){
 		}
 		cpu.step();
 	}
+	cpu.serial.disconnect();
+	recorder.reset();
 
+	if (cpu.is_profiling())
+		cpu.print_profile(stdout);
+	if (timings && cpu.instrumentation)
+		cpu.instrumentation->print_report(stdout);
 
 	SDL_Event keyevent;    //The SDL event that we will poll to get events.
 	while (!wants_quit && SDL_WaitEvent(&keyevent))   //Poll our SDL key event for any keystrokes.
@@ -279,6 +534,9 @@ int main(int argc, char* argv[]){
 			wants_quit = true;
 	}
 
+	if (second_cpu_thread.joinable())
+		second_cpu_thread.join();
+
 	sdl_cleanup();
 	
 	return 0;
@@ -0,0 +1,97 @@
+// Copyright Samuel Stark 2017
+
+// Runs the control commands without a socket, and checks that restoring a snapshot puts back exactly the state that was saved,
+// and that peeking and poking during an OAM DMA never stops the CPU.
+
+#include "test.h"
+
+#include "gb/control_server.h"
+
+#include <string>
+
+namespace{
+	// Counts the bytes written into work RAM at $C000 forever, with the LCD on so frames are drawn
+	const std::vector<uint8_t> COUNTING_LOOP = {
+		0x21, 0x00, 0xC0, // LD HL,$C000
+		0x34,             // INC (HL)
+		0x18, 0xFD,       // JR -3
+	};
+
+	class TestControlServer : public GB::ControlServer{
+	public:
+		// The one line reply, without its newline
+		std::string command(GB::CPU& cpu, const std::string& line){
+			std::string replies;
+			execute(cpu, line, replies);
+			CHECK(!replies.empty() && replies.back() == '\n');
+			if (!replies.empty()) replies.pop_back();
+			return replies;
+		}
+		const std::vector<uint8_t>& snapshot(int slot){
+			return snapshots[slot];
+		}
+	};
+
+	TestControlServer* server = nullptr;
+	void count_frame(GB::CPU&){
+		server->on_frame();
+	}
+
+	bool starts_with(const std::string& text, const std::string& start){
+		return text.compare(0, start.size(), start) == 0;
+	}
+}
+
+int main(){
+	TestControlServer test_server;
+	server = &test_server;
+	GB::CPU cpu(Test::empty_bios(), Test::plain_rom(COUNTING_LOOP), &count_frame);
+
+	CHECK(test_server.command(cpu, "run 2") == "ok 2");
+	CHECK(test_server.command(cpu, "write C100 0102ff") == "ok");
+	CHECK(test_server.command(cpu, "read C100 3") == "ok 0102ff");
+	CHECK(test_server.command(cpu, "write FF80 42") == "ok");
+	CHECK(test_server.command(cpu, "read FF80 1") == "ok 42");
+	CHECK(test_server.command(cpu, "input 11") == "ok");
+
+	// Restoring a snapshot brings back everything, including what was written and the counter the program keeps
+	CHECK(test_server.command(cpu, "snapshot 3") == "ok");
+	const std::string saved_counter = test_server.command(cpu, "read C000 1");
+	const std::string saved_hash = test_server.command(cpu, "hash");
+	CHECK(test_server.snapshot(3) == cpu.save_state());
+	CHECK(test_server.command(cpu, "run 3") == "ok 5");
+	CHECK(test_server.command(cpu, "write C100 aabbcc") == "ok");
+	CHECK(test_server.command(cpu, "input 0") == "ok");
+	CHECK(test_server.snapshot(3) != cpu.save_state());
+	CHECK(test_server.command(cpu, "restore 3") == "ok");
+	CHECK(test_server.snapshot(3) == cpu.save_state());
+	CHECK(test_server.command(cpu, "read C100 3") == "ok 0102ff");
+	CHECK(test_server.command(cpu, "read C000 1") == saved_counter);
+	CHECK(test_server.command(cpu, "hash") == saved_hash);
+	CHECK(starts_with(test_server.command(cpu, "restore 4"), "error"));
+	CHECK(starts_with(test_server.command(cpu, "snapshot 16"), "error"));
+
+	// Lengths that would wrap around past the end of the address space
+	CHECK(starts_with(test_server.command(cpu, "read 10 ffffffff"), "error"));
+	CHECK(starts_with(test_server.command(cpu, "read fff0 11"), "error"));
+	CHECK(starts_with(test_server.command(cpu, "read 10000 1"), "error"));
+	CHECK(test_server.command(cpu, "read ffff 1") != "");
+	CHECK(starts_with(test_server.command(cpu, "write ffff 0102"), "error"));
+
+	// Start an OAM DMA. RAM can still be used (and the DMA has already copied into the sprite info), but the ROM and IO would be bus conflicts, so they're refused.
+	CHECK(test_server.command(cpu, "write ff46 c1") == "ok");
+	CHECK(cpu.mmu.dma_timer >= 0);
+	CHECK(test_server.command(cpu, "read C100 3") == "ok 0102ff");
+	CHECK(test_server.command(cpu, "write C101 77") == "ok");
+	CHECK(test_server.command(cpu, "read C101 1") == "ok 77");
+	CHECK(test_server.command(cpu, "read FE00 3") == "ok 0102ff");
+	CHECK(starts_with(test_server.command(cpu, "read 0100 1"), "error"));
+	CHECK(starts_with(test_server.command(cpu, "read FF40 1"), "error"));
+	CHECK(starts_with(test_server.command(cpu, "write FF47 e4"), "error"));
+	CHECK(!cpu.stopped);
+	CHECK(cpu.mmu.dma_timer >= 0);
+
+	CHECK(starts_with(test_server.command(cpu, "jump 100"), "error"));
+
+	return Test::result();
+}
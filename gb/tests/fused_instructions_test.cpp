@@ -0,0 +1,140 @@
+// Copyright Samuel Stark 2017
+
+// Runs programs made of the fused sequences with fusing (the release step policy) and without (profiled stepping never fuses),
+// and checks the registers, memory and cycle count all come out the same. Interrupts are left disabled, as a fused sequence
+// only takes one at its end.
+
+#include "test.h"
+
+#include <memory>
+
+namespace{
+	// After the cartridge header, which the entry point jumps over
+	constexpr uint16_t CODE_START = 0x150;
+	// Leaves the CPU looping on JR -2 here
+	constexpr uint16_t DONE_PC = 0x1F0;
+	constexpr unsigned int MAX_CYCLES = 70224 * 10;
+
+	void put(std::vector<uint8_t>& rom, uint16_t address, const std::vector<uint8_t>& bytes){
+		std::copy(bytes.begin(), bytes.end(), rom.begin() + address);
+	}
+
+	std::vector<uint8_t> sequences_rom(){
+		std::vector<uint8_t> rom = Test::plain_rom({0xC3, static_cast<uint8_t>(CODE_START), static_cast<uint8_t>(CODE_START >> 8)});
+		put(rom, CODE_START, {
+			0x31, 0xF0, 0xDF, // LD SP,$DFF0
+			0x21, 0x00, 0xC0, 0x3E, 0x5A, 0x06, 0x40, // LD HL,$C000  LD A,$5A  LD B,$40
+			0x22, 0x05, 0x20, 0xFC, // LD (HL+),A; DEC B; JR NZ
+			0x21, 0xFF, 0xC0, 0x3E, 0xA5, 0x0E, 0x20, // LD HL,$C0FF  LD A,$A5  LD C,$20
+			0x32, 0x0D, 0x20, 0xFC, // LD (HL-),A; DEC C; JR NZ
+			0x21, 0x00, 0x03, 0x11, 0x00, 0xC2, 0x06, 0x30, // LD HL,$0300  LD DE,$C200  LD B,$30
+			0x2A, 0x12, 0x13, 0x05, 0x20, 0xFA, // LD A,(HL+); LD (DE),A; INC DE; DEC B; JR NZ
+			0x0E, 0x21, // LD C,$21
+			0x2A, 0x12, 0x13, 0x0D, 0x20, 0xFA, // LD A,(HL+); LD (DE),A; INC DE; DEC C; JR NZ
+			0x01, 0x23, 0x01, // LD BC,$0123
+			0x2A, 0x12, 0x13, 0x0B, 0x78, 0xB1, 0x20, 0xF8, // LD A,(HL+); LD (DE),A; INC DE; DEC BC; LD A,B; OR C; JR NZ
+			0x2A, 0x12, 0x13, // LD A,(HL+); LD (DE),A; INC DE
+			0xAF, 0x22, 0xAF, 0x22, // XOR A; LD (HL+),A, twice
+			0xF0, 0x44, 0xFE, 0x90, 0x20, 0xFA, // LDH A,($44); CP $90; JR NZ (wait for VBlank)
+			0xF0, 0x44, 0xFE, 0x10, 0x28, 0xFA, // LDH A,($44); CP $10; JR Z
+			0xF0, 0x41, 0xE6, 0x03, 0x20, 0xFA, // LDH A,($41); AND 3; JR NZ (wait for HBlank)
+			0xF0, 0x41, 0xE6, 0x03, 0x28, 0xFA, // LDH A,($41); AND 3; JR Z
+			0xF0, 0x44, 0xFE, 0x42, // LDH A,($44); CP $42
+			0xC3, static_cast<uint8_t>(DONE_PC), static_cast<uint8_t>(DONE_PC >> 8), // JP DONE_PC
+		});
+		put(rom, DONE_PC, {0x18, 0xFE});
+		// Something to copy
+		for (int i = 0; i < 0x200; i++){
+			rom[0x300 + i] = static_cast<uint8_t>(i * 7 + 3);
+		}
+		return rom;
+	}
+
+	// An MBC1 ROM with a fill loop at $4000 in bank 1, and the same bytes without the JR in bank 2,
+	// so a sequence remembered for one bank mustn't be used for the other
+	std::vector<uint8_t> banked_rom(){
+		std::vector<uint8_t> rom(4 * GB::RomData::ROM_BANK_SIZE, 0x00);
+		rom[GB::RomData::ROM_OFFSET_TYPE] = GB::RomData::ROM_MBC1;
+		rom[GB::RomData::ROM_OFFSET_ROM_SIZE] = 0x01; // 4 banks
+		put(rom, 0x100, {0xC3, static_cast<uint8_t>(CODE_START), static_cast<uint8_t>(CODE_START >> 8)});
+		put(rom, CODE_START, {
+			0x31, 0xF0, 0xDF, // LD SP,$DFF0
+			0x21, 0x00, 0xC0, 0x3E, 0x77, // LD HL,$C000  LD A,$77
+			0x06, 0x01, 0x78, 0xEA, 0x00, 0x20, // LD B,1  LD A,B  LD ($2000),A: bank 1
+			0x3E, 0x77, 0x06, 0x10, 0xCD, 0x00, 0x40, // LD A,$77  LD B,$10  CALL $4000
+			0x3E, 0x02, 0xEA, 0x00, 0x20, // LD A,2  LD ($2000),A: bank 2
+			0x3E, 0x66, 0x06, 0x10, 0xCD, 0x00, 0x40, // LD A,$66  LD B,$10  CALL $4000
+			0x3E, 0x01, 0xEA, 0x00, 0x20, // Back to bank 1
+			0x3E, 0x55, 0x06, 0x08, 0xCD, 0x00, 0x40, // LD A,$55  LD B,$08  CALL $4000
+			0xC3, static_cast<uint8_t>(DONE_PC), static_cast<uint8_t>(DONE_PC >> 8), // JP DONE_PC
+		});
+		put(rom, DONE_PC, {0x18, 0xFE});
+		put(rom, 1 * GB::RomData::ROM_BANK_SIZE, {0x22, 0x05, 0x20, 0xFC, 0xC9}); // LD (HL+),A; DEC B; JR NZ; RET
+		put(rom, 2 * GB::RomData::ROM_BANK_SIZE, {0x22, 0x05, 0x00, 0x00, 0xC9}); // LD (HL+),A; DEC B; NOP; NOP; RET
+		return rom;
+	}
+
+	struct Run{
+		std::unique_ptr<GB::CPU> cpu;
+		unsigned int steps = 0;
+	};
+	Run run_to_done(const std::vector<uint8_t>& rom, bool fuse){
+		Run run;
+		// Profiling turns fusing off
+		run.cpu.reset(new GB::CPU(Test::empty_bios(), rom, Test::ignore_vblank, false, !fuse));
+		GB::CPU& cpu = *run.cpu;
+		cpu.reset();
+		cpu.exit_bios();
+		cpu.registers.pc = 0x100;
+		while (!cpu.stopped && cpu.registers.pc != DONE_PC && cpu.clock_cycles < MAX_CYCLES){
+			cpu.step();
+			run.steps++;
+		}
+		return run;
+	}
+
+	void check_same(const std::vector<uint8_t>& rom){
+		Run fused = run_to_done(rom, true);
+		Run stepped = run_to_done(rom, false);
+		GB::CPU& a = *fused.cpu;
+		GB::CPU& b = *stepped.cpu;
+
+		CHECK(a.registers.pc == DONE_PC);
+		CHECK(b.registers.pc == DONE_PC);
+		CHECK(a.registers.af == b.registers.af);
+		CHECK(a.registers.bc == b.registers.bc);
+		CHECK(a.registers.de == b.registers.de);
+		CHECK(a.registers.hl == b.registers.hl);
+		CHECK(a.registers.sp == b.registers.sp);
+		CHECK(a.clock_cycles == b.clock_cycles);
+		// Otherwise nothing was fused
+		CHECK(fused.steps < stepped.steps);
+
+		size_t differences = 0;
+		for (uint32_t address = GB::MMU::INT_RAM_START; address < GB::MMU::INT_RAM_MIRROR_START; address++){
+			if (*a.mmu.map_plain_ram(address) != *b.mmu.map_plain_ram(address)) differences++;
+		}
+		for (uint32_t address = GB::MMU::ZP_RAM_START; address < GB::MMU::INTERRUPTS_ENABLED_ADDRESS; address++){
+			if (*a.mmu.map_plain_ram(address) != *b.mmu.map_plain_ram(address)) differences++;
+		}
+		CHECK(differences == 0);
+	}
+}
+
+int main(){
+	GB::CPU::limit_fps = false;
+
+	check_same(sequences_rom());
+	check_same(banked_rom());
+
+	// The bank 2 routine only writes one byte, and bank 1's fill loop picks up straight after it
+	Run banked = run_to_done(banked_rom(), true);
+	GB::CPU& cpu = *banked.cpu;
+	CHECK(*cpu.mmu.map_plain_ram(0xC00F) == 0x77);
+	CHECK(*cpu.mmu.map_plain_ram(0xC010) == 0x66);
+	CHECK(*cpu.mmu.map_plain_ram(0xC011) == 0x55);
+	CHECK(*cpu.mmu.map_plain_ram(0xC018) == 0x55);
+	CHECK(*cpu.mmu.map_plain_ram(0xC019) == 0x00);
+
+	return Test::result();
+}
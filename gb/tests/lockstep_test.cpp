@@ -0,0 +1,171 @@
+// Copyright Samuel Stark 2017
+
+// Checks GB::Lockstep's lane kernels against the instruction handlers, one opcode at a time with F's unused low nibble set
+// (POP AF can load it, and the handlers leave it alone), and then whole programs against CPU::step().
+
+#include "test.h"
+#include "gb/lockstep.h"
+#include "gb/instructions/instruction_set.h"
+
+#include <memory>
+
+namespace{
+	constexpr unsigned int CYCLES = 70224 * 3;
+
+	// Gives the test the kernels on their own
+	class KernelLockstep : public GB::Lockstep{
+	public:
+		using Lockstep::Lockstep;
+		using Lockstep::has_kernel;
+
+		void run_kernel_on_all(uint8_t opcode){
+			LaneMask all;
+			all.fill(0xFF);
+			for (int lane = 0; lane < static_cast<int>(cpus.size()); lane++) gather(lane);
+			run_kernel(opcode, all);
+			for (int lane = 0; lane < static_cast<int>(cpus.size()); lane++) scatter(lane);
+		}
+	};
+
+	void set_registers(GB::CPU& cpu, int lane, int seed){
+		const int value = lane * 37 + seed * 101;
+		cpu.registers.a = value * 3 + 0x11;
+		cpu.registers.b = value * 5 + 0x0F;
+		cpu.registers.c = value * 7 + 0xF0;
+		cpu.registers.d = value * 11;
+		cpu.registers.e = value * 13 + 0x01;
+		cpu.registers.h = value * 17 + 0xFF;
+		cpu.registers.l = value * 19 + 0x80;
+		// Every combination of the flags, always with something in the low nibble
+		cpu.registers.f = ((value & 0xF) << 4) | ((value % 15) + 1);
+		cpu.registers.sp = 0xDFF0;
+		cpu.registers.pc = 0x100;
+	}
+
+	void check_kernels_match_handlers(){
+		std::vector<std::unique_ptr<GB::CPU>> expected, lanes;
+		std::vector<GB::CPU*> lane_pointers;
+		for (int lane = 0; lane < GB::Lockstep::MAX_INSTANCES; lane++){
+			expected.emplace_back(new GB::CPU(Test::empty_bios(), Test::plain_rom({}), Test::ignore_vblank));
+			lanes.emplace_back(new GB::CPU(Test::empty_bios(), Test::plain_rom({}), Test::ignore_vblank));
+			lane_pointers.push_back(lanes.back().get());
+		}
+		KernelLockstep lockstep(lane_pointers);
+
+		int kernels = 0;
+		for (int opcode = 0; opcode < 0x100; opcode++){
+			if (!KernelLockstep::has_kernel(opcode)) continue;
+			kernels++;
+			const GB::Instructions::Instruction& instruction = GB::Instructions::InstructionSet::instructions[opcode];
+			for (int seed = 0; seed < 16; seed++){
+				for (int lane = 0; lane < GB::Lockstep::MAX_INSTANCES; lane++){
+					set_registers(*expected[lane], lane, seed);
+					set_registers(*lanes[lane], lane, seed);
+					expected[lane]->registers.pc++;
+					instruction.execute(*expected[lane]);
+					expected[lane]->clear_operand();
+					// The kernels leave the PC to Lockstep
+					expected[lane]->registers.pc--;
+				}
+				lockstep.run_kernel_on_all(opcode);
+				for (int lane = 0; lane < GB::Lockstep::MAX_INSTANCES; lane++){
+					const GB::CPU::Registers& want = expected[lane]->registers;
+					const GB::CPU::Registers& got = lanes[lane]->registers;
+					const bool matches = want.af == got.af && want.bc == got.bc && want.de == got.de && want.hl == got.hl;
+					if (!matches){
+						fprintf(stderr, "0x%02x (%s): AF %04x BC %04x DE %04x HL %04x, expected AF %04x BC %04x DE %04x HL %04x\n",
+								opcode, instruction.disassembly, got.af, got.bc, got.de, got.hl, want.af, want.bc, want.de, want.hl);
+					}
+					CHECK(matches);
+				}
+			}
+		}
+		CHECK(kernels > 0);
+	}
+
+	// A loop of register-only instructions (which have lane kernels), with a PUSH/POP AF before each run of them.
+	// Each lane starts with different registers, so the flags go every which way.
+	// (step_components() clears F's low nibble after every instruction, so it's the kernel check above that covers it.)
+	std::vector<uint8_t> program(int lane){
+		const uint16_t bc = 0x3A07 + lane * 0x1111;
+		const uint16_t de = 0x91C5 + lane * 0x0B3D;
+		const uint16_t hl = 0x5E2B + lane * 0x2F17;
+		std::vector<uint8_t> code = {
+			0x31, 0xF0, 0xDF, // LD SP,$DFF0
+			0x01, static_cast<uint8_t>(bc), static_cast<uint8_t>(bc >> 8), // LD BC,nn
+			0x11, static_cast<uint8_t>(de), static_cast<uint8_t>(de >> 8), // LD DE,nn
+			0x21, static_cast<uint8_t>(hl), static_cast<uint8_t>(hl >> 8), // LD HL,nn
+			0x3E, static_cast<uint8_t>(0x40 + lane * 13), // LD A,n
+		};
+		const std::vector<uint8_t> loop = {
+			0xC5, 0xF1, // PUSH BC, POP AF
+			0x80, 0x89, 0x92, 0x9B, 0xA4, 0xAD, 0xB0, 0xB9, // ADD A,B  ADC A,C  SUB D  SBC A,E  AND H  XOR L  OR B  CP C
+			0x04, 0x0D, 0x14, 0x1D, 0x24, 0x2D, 0x3C, 0x3D, // INC B  DEC C  INC D  DEC E  INC H  DEC L  INC A  DEC A
+			0x2F, // CPL
+			0x47, 0x59, 0x62, 0x6B, 0x4F, // LD B,A  LD E,C  LD H,D  LD L,E  LD C,A
+			0x81, 0x8A, 0x93, 0x9C, 0x0C, 0x15, // ADD A,C  ADC A,D  SUB E  SBC A,H  INC C  DEC D
+			0xD5, 0xF1, // PUSH DE, POP AF
+			0x88, 0x99, 0xA8, 0x2F, 0x00, 0xBA, 0xB5, // ADC A,B  SBC A,C  XOR B  CPL  NOP  CP D  OR L
+		};
+		code.insert(code.end(), loop.begin(), loop.end());
+		code.push_back(0x18); // JR back to the start of the loop
+		code.push_back(static_cast<uint8_t>(-static_cast<int>(loop.size() + 2)));
+		return code;
+	}
+
+	std::vector<std::unique_ptr<GB::CPU>> make_cpus(){
+		std::vector<std::unique_ptr<GB::CPU>> cpus;
+		for (int lane = 0; lane < GB::Lockstep::MAX_INSTANCES; lane++){
+			cpus.emplace_back(new GB::CPU(Test::empty_bios(), Test::plain_rom(program(lane)), Test::ignore_vblank));
+			GB::CPU& cpu = *cpus.back();
+			cpu.reset();
+			cpu.exit_bios();
+			cpu.registers.pc = 0x100;
+		}
+		return cpus;
+	}
+	std::vector<GB::CPU*> pointers(const std::vector<std::unique_ptr<GB::CPU>>& cpus){
+		std::vector<GB::CPU*> result;
+		for (auto& cpu : cpus) result.push_back(cpu.get());
+		return result;
+	}
+	bool same_state(const GB::CPU& a, const GB::CPU& b){
+		return a.registers.af == b.registers.af && a.registers.bc == b.registers.bc
+			&& a.registers.de == b.registers.de && a.registers.hl == b.registers.hl
+			&& a.registers.sp == b.registers.sp && a.registers.pc == b.registers.pc
+			&& a.clock_cycles == b.clock_cycles && a.stopped == b.stopped;
+	}
+}
+
+int main(){
+	GB::CPU::limit_fps = false;
+
+	check_kernels_match_handlers();
+
+	auto scalar = make_cpus();
+	for (auto& cpu : scalar){
+		const unsigned int start = cpu->clock_cycles;
+		while (!cpu->stopped && cpu->clock_cycles - start < CYCLES){
+			cpu->step();
+		}
+	}
+
+	auto vector = make_cpus();
+	GB::Lockstep lockstep(pointers(vector));
+	lockstep.run(CYCLES);
+	CHECK(lockstep.vector_instructions > lockstep.scalar_instructions);
+
+	auto verified = make_cpus();
+	GB::Lockstep verifying_lockstep(pointers(verified));
+	verifying_lockstep.verify_kernels = true;
+	verifying_lockstep.run(CYCLES);
+
+	for (int lane = 0; lane < GB::Lockstep::MAX_INSTANCES; lane++){
+		CHECK(!scalar[lane]->stopped);
+		CHECK(same_state(*scalar[lane], *vector[lane]));
+		// check_kernel stops the CPU if a kernel disagrees with the handler
+		CHECK(same_state(*scalar[lane], *verified[lane]));
+	}
+
+	return Test::result();
+}
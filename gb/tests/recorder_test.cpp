@@ -0,0 +1,62 @@
+// Copyright Samuel Stark 2017
+
+// Records one known frame and checks the Y4M file's luma against the shades the window would draw
+
+#include "test.h"
+#include "gb/recorder.h"
+
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+int main(){
+	char path[] = "/tmp/gb_recorder_test_XXXXXX";
+	const int fd = mkstemp(path);
+	CHECK(fd >= 0);
+	if (fd < 0) return Test::result();
+	close(fd);
+
+	GB::CPU cpu(Test::empty_bios(), Test::plain_rom({}), Test::ignore_vblank);
+	constexpr size_t PIXEL_COUNT = GB::GPU::SCREEN_WIDTH * GB::GPU::SCREEN_HEIGHT;
+	for (size_t i = 0; i < PIXEL_COUNT; i++){
+		cpu.gpu.framebuffer[i] = static_cast<GB::GPU::Pixel>(i % 4);
+	}
+
+	auto recorder = GB::Recorder::create(path, nullptr, GB::Recorder::Policy::Block);
+	CHECK(recorder != nullptr);
+	if (!recorder) return Test::result();
+	recorder->capture_frame(cpu.gpu);
+	// Finishes the file
+	recorder.reset();
+
+	FILE* file = fopen(path, "rb");
+	CHECK(file != nullptr);
+	if (!file) return Test::result();
+	std::string contents;
+	char buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0){
+		contents.append(buffer, read);
+	}
+	fclose(file);
+	unlink(path);
+
+	const size_t header_end = contents.find('\n');
+	CHECK(header_end != std::string::npos);
+	CHECK(contents.compare(0, 10, "YUV4MPEG2 ") == 0);
+	const size_t frame_start = header_end + 1;
+	CHECK(contents.compare(frame_start, 6, "FRAME\n") == 0);
+	const size_t luma_start = frame_start + 6;
+	CHECK(contents.size() == luma_start + PIXEL_COUNT);
+	if (contents.size() != luma_start + PIXEL_COUNT) return Test::result();
+
+	// Shade 0 is white and 3 is black
+	const uint8_t expected_luma[4] = { 255, 170, 85, 0 };
+	size_t mismatches = 0;
+	for (size_t i = 0; i < PIXEL_COUNT; i++){
+		if (static_cast<uint8_t>(contents[luma_start + i]) != expected_luma[i % 4]) mismatches++;
+	}
+	CHECK(mismatches == 0);
+
+	return Test::result();
+}
@@ -0,0 +1,43 @@
+// Copyright Samuel Stark 2017
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include "gb/cpu.h"
+#include "gb/rom_data.h"
+
+// Each test is its own executable, which prints the checks that failed to stderr and fails if there were any.
+// make test-units builds and runs all of them.
+namespace Test{
+	inline int failures = 0;
+	// For main() to return
+	inline int result(){
+		return failures == 0 ? 0 : 1;
+	}
+
+	// A plain 32KB ROM with code at the entry point, for constructing a CPU without a cartridge
+	inline std::vector<uint8_t> plain_rom(const std::vector<uint8_t>& code, uint16_t address = 0x100){
+		std::vector<uint8_t> rom(2 * GB::RomData::ROM_BANK_SIZE, 0x00);
+		std::copy(code.begin(), code.end(), rom.begin() + address);
+		return rom;
+	}
+	// For the CPU's on_vblank
+	inline void ignore_vblank(GB::CPU&){}
+	inline std::array<uint8_t, GB::MMU::BIOS_SIZE> empty_bios(){
+		std::array<uint8_t, GB::MMU::BIOS_SIZE> bios;
+		bios.fill(0x00);
+		return bios;
+	}
+}
+
+#define CHECK(condition) do { \
+		if (!(condition)){ \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			Test::failures++; \
+		} \
+	} while (0)
@@ -0,0 +1,284 @@
+// Copyright Samuel Stark 2017
+
+// Walks the code reachable from the fixed entry points of a ROM (0x100, the RST vectors and the interrupt handlers),
+// splits it into basic blocks for each ROM bank, and writes out C++ that runs each block.
+// Every instruction in a block calls the same handler the interpreter would, through instruction_tables.h,
+// so the semantics are identical. What goes away is the fetch, the decode and the indirect call.
+// The output is built into a plugin with "make recompiled/<name>.so", and loaded with --recompiled.
+
+#include "gb/cartridge.h"
+#include "gb/rom_data.h"
+#include "gb/recompiled.h"
+#include "gb/instructions/instruction_set.h"
+
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace{
+	using GB::Instructions::Instruction;
+	using GB::Instructions::InstructionSet;
+	using Bank = std::array<uint8_t, 0x4000>;
+
+	constexpr int MAX_BLOCK_INSTRUCTIONS = 64;
+
+	// A (ROM bank, PC) pair. The bank is always 0 below 0x4000.
+	using Location = std::pair<int, uint16_t>;
+
+	enum class Flow{
+		Continue, // Carries on to the next instruction
+		Jump, // Never carries on to the next instruction
+		Branch, // Might carry on to the next instruction
+		Interpreter, // Has to be run by the interpreter (HALT, STOP and unknown opcodes)
+	};
+
+	struct Decoded{
+		uint16_t pc;
+		uint8_t opcode;
+		uint8_t cb_opcode;
+		uint16_t operand;
+		const Instruction* instruction;
+		Flow flow;
+		// Where a jump/call/RST goes, if it's known
+		bool has_target;
+		uint16_t target;
+		// Writes to memory that could be an MBC register, so a block in the switchable bank has to check it's still mapped
+		bool might_switch_bank;
+	};
+
+	class Recompiler{
+	public:
+		Recompiler(const std::vector<Bank>& rom_banks, bool all_banks) : rom_banks(rom_banks), all_banks(all_banks) {}
+
+		void find_blocks(){
+			std::vector<uint16_t> entry_points = { 0x100 };
+			for (uint16_t vector = 0x00; vector <= 0x38; vector += 0x08) entry_points.push_back(vector);
+			for (uint16_t handler = 0x40; handler <= 0x60; handler += 0x08) entry_points.push_back(handler);
+			for (uint16_t pc : entry_points) add_leader(0, 0, pc);
+
+			while (!worklist.empty()){
+				const Location location = worklist.front();
+				worklist.pop_front();
+				walk(location);
+			}
+		}
+
+		void write(FILE* out, const char* rom_name, uint16_t global_checksum){
+			fprintf(out, "// Generated by tools/recompiler.cpp from '%s'. Don't edit this, regenerate it.\n\n", rom_name);
+			fprintf(out, "#include \"gb/cpu.h\"\n#include \"gb/recompiled.h\"\n#include \"gb/instructions/instruction_tables.h\"\n\n");
+			fprintf(out, "using GB::CPU;\nusing GB::Instructions::instruction_table;\nusing GB::Instructions::cb_instruction_table;\n\n");
+			fprintf(out, "namespace{\n");
+			size_t instruction_count = 0;
+			for (const Location& leader : leaders){
+				instruction_count += write_block(out, leader);
+			}
+			fprintf(out, "}\n\n");
+
+			fprintf(out, "static const GB::RecompiledBlockEntry blocks[] = {\n");
+			for (const Location& leader : leaders){
+				fprintf(out, "\t{ 0x%02x, 0x%04x, block_%02x_%04x },\n", leader.first, leader.second, leader.first, leader.second);
+			}
+			fprintf(out, "};\n\n");
+			fprintf(out, "extern \"C\" const GB::RecompiledRom gb_recompiled_rom = {\n");
+			fprintf(out, "\tGB::RECOMPILED_ROM_VERSION,\n\t\"%s\",\n\t0x%04x,\n\tblocks,\n\tsizeof(blocks) / sizeof(blocks[0])\n};\n", rom_name, global_checksum);
+
+			fprintf(stdout, "Wrote %zu blocks, %zu instructions\n", leaders.size(), instruction_count);
+		}
+
+	protected:
+		const std::vector<Bank>& rom_banks;
+		const bool all_banks;
+		std::set<Location> leaders;
+		std::deque<Location> worklist;
+
+		inline uint8_t read(int bank, uint16_t pc){
+			return (pc < 0x4000) ? rom_banks[0][pc] : rom_banks[bank][pc - 0x4000];
+		}
+		// Blocks never cross from one 16kB region into the other
+		inline uint16_t region_end(uint16_t pc){
+			return (pc < 0x4000) ? 0x4000 : 0x8000;
+		}
+
+		// from_bank is the bank of the code jumping to pc
+		void add_leader(int from_bank, int bank, uint16_t pc){
+			if (pc >= 0x8000) return; // RAM, which can change, is always interpreted
+			if (pc < 0x4000){
+				bank = 0;
+			}else if (bank == 0){
+				// Code in bank 0 can call into whichever bank is mapped, which can't be known from here.
+				// By default assume bank 1, which is what's mapped at power on.
+				if (all_banks){
+					for (int switchable = 1; switchable < static_cast<int>(rom_banks.size()); switchable++){
+						add_leader(from_bank, switchable, pc);
+					}
+					return;
+				}
+				bank = 1;
+			}
+			if (bank >= static_cast<int>(rom_banks.size())) return;
+			if (leaders.insert(Location(bank, pc)).second){
+				worklist.push_back(Location(bank, pc));
+			}
+		}
+
+		bool decode(int bank, uint16_t pc, Decoded& decoded){
+			decoded = {};
+			decoded.pc = pc;
+			decoded.opcode = read(bank, pc);
+			if (decoded.opcode == 0xCB){
+				if (pc + 1 >= region_end(pc)) return false;
+				decoded.cb_opcode = read(bank, pc + 1);
+			}
+			decoded.instruction = InstructionSet::find_instruction(decoded.opcode, decoded.cb_opcode);
+			if (pc + decoded.instruction->length > region_end(pc)) return false;
+
+			const int operand_bytes = (decoded.opcode == 0xCB) ? 0 : decoded.instruction->length - 1;
+			if (operand_bytes == 1) decoded.operand = read(bank, pc + 1);
+			if (operand_bytes == 2) decoded.operand = read(bank, pc + 1) | (read(bank, pc + 2) << 8);
+
+			const uint8_t op = decoded.opcode;
+			const uint16_t next_pc = pc + decoded.instruction->length;
+			if (strncmp(decoded.instruction->disassembly, "UNK", 3) == 0 || op == 0x76 || op == 0x10){
+				decoded.flow = Flow::Interpreter;
+			}else if (op == 0xC3 || op == 0xCD){ // JP a16, CALL a16
+				decoded.flow = (op == 0xC3) ? Flow::Jump : Flow::Branch;
+				decoded.has_target = true;
+				decoded.target = decoded.operand;
+			}else if (op == 0xC2 || op == 0xCA || op == 0xD2 || op == 0xDA || op == 0xC4 || op == 0xCC || op == 0xD4 || op == 0xDC){ // JP cc / CALL cc
+				decoded.flow = Flow::Branch;
+				decoded.has_target = true;
+				decoded.target = decoded.operand;
+			}else if (op == 0x18 || op == 0x20 || op == 0x28 || op == 0x30 || op == 0x38){ // JR / JR cc
+				decoded.flow = (op == 0x18) ? Flow::Jump : Flow::Branch;
+				decoded.has_target = true;
+				decoded.target = next_pc + static_cast<int8_t>(decoded.operand);
+			}else if ((op & 0xC7) == 0xC7){ // RST
+				// Returns to the next instruction, like a call
+				decoded.flow = Flow::Branch;
+				decoded.has_target = true;
+				decoded.target = op & 0x38;
+			}else if (op == 0xE9 || op == 0xC9 || op == 0xD9){ // JP (HL), RET, RETI
+				decoded.flow = Flow::Jump;
+			}else if (op == 0xC0 || op == 0xC8 || op == 0xD0 || op == 0xD8){ // RET cc
+				decoded.flow = Flow::Branch;
+			}else{
+				decoded.flow = Flow::Continue;
+			}
+
+			const bool writes_hl = (op == 0x34 || op == 0x35 || op == 0x36 || op == 0x22 || op == 0x32 || (op >= 0x70 && op <= 0x77 && op != 0x76));
+			const bool writes_cb_hl = (op == 0xCB) && ((decoded.cb_opcode & 0x7) == 6) && !(decoded.cb_opcode >= 0x40 && decoded.cb_opcode < 0x80);
+			decoded.might_switch_bank = writes_hl || writes_cb_hl || op == 0x02 || op == 0x12 || op == 0xEA || op == 0x08;
+			return true;
+		}
+
+		// Finds where this block goes next, and queues those up as blocks of their own
+		void walk(const Location& start){
+			const int bank = start.first;
+			uint16_t pc = start.second;
+			Decoded decoded;
+			for (int i = 0; i < MAX_BLOCK_INSTRUCTIONS; i++){
+				if (!decode(bank, pc, decoded) || decoded.flow == Flow::Interpreter) return;
+
+				const uint16_t next_pc = pc + decoded.instruction->length;
+				if (decoded.has_target) add_leader(bank, bank, decoded.target);
+				if (decoded.flow == Flow::Jump) return;
+				if (decoded.flow == Flow::Branch){
+					add_leader(bank, bank, next_pc);
+					return;
+				}
+				if (next_pc >= region_end(pc)) return;
+				pc = next_pc;
+			}
+			// Too long, so the rest of it becomes another block
+			add_leader(bank, bank, pc);
+		}
+
+		size_t write_block(FILE* out, const Location& start){
+			const int bank = start.first;
+			uint16_t pc = start.second;
+			fprintf(out, "\tvoid block_%02x_%04x(CPU& cpu){\n", bank, pc);
+
+			size_t count = 0;
+			Decoded decoded;
+			for (int i = 0; i < MAX_BLOCK_INSTRUCTIONS; i++){
+				// Stop before anything the interpreter has to run, and before running into another block
+				if (i > 0 && leaders.count(Location(bank, pc))) break;
+				if (!decode(bank, pc, decoded) || decoded.flow == Flow::Interpreter) break;
+
+				const uint16_t next_pc = pc + decoded.instruction->length;
+				fprintf(out, "\t\t// 0x%04x: %s", pc, decoded.instruction->disassembly);
+				if (decoded.instruction->length > 1 && decoded.opcode != 0xCB) fprintf(out, " (0x%0*x)", (decoded.instruction->length - 1) * 2, decoded.operand);
+				fprintf(out, "\n\t\tcpu.registers.pc = 0x%04x;\n", next_pc);
+				if (decoded.opcode == 0xCB){
+					fprintf(out, "\t\tcpu.preload_operand(0x%02x, 1);\n", decoded.cb_opcode);
+				}else if (decoded.instruction->length > 1){
+					fprintf(out, "\t\tcpu.preload_operand(0x%04x, %d);\n", decoded.operand, decoded.instruction->length - 1);
+				}
+				const std::string execute = (decoded.opcode == 0xCB)
+					? "cb_instruction_table[0x" + hex(decoded.cb_opcode) + "].execute(cpu)"
+					: "instruction_table[0x" + hex(decoded.opcode) + "].execute(cpu)";
+				count++;
+
+				const bool last = decoded.flow != Flow::Continue || next_pc >= region_end(pc);
+				if (last){
+					fprintf(out, "\t\tcpu.finish_recompiled_instruction(%s);\n", execute.c_str());
+					break;
+				}
+				if (bank != 0 && decoded.might_switch_bank){
+					fprintf(out, "\t\tif (!cpu.finish_recompiled_instruction(%s) || cpu.cartridge.mbc->current_rom_bank() != 0x%02x) return;\n", execute.c_str(), bank);
+				}else{
+					fprintf(out, "\t\tif (!cpu.finish_recompiled_instruction(%s)) return;\n", execute.c_str());
+				}
+				pc = next_pc;
+			}
+			fprintf(out, "\t}\n");
+			return count;
+		}
+
+		static std::string hex(uint8_t value){
+			char buffer[3];
+			snprintf(buffer, sizeof(buffer), "%02x", value);
+			return buffer;
+		}
+	};
+}
+
+int main(int argc, char* argv[]){
+	if (argc < 3){
+		fprintf(stderr, "Usage: %s <rom> <output.cpp> [--all-banks]\n", argv[0]);
+		fprintf(stderr, "--all-banks assumes a call from bank 0 into 0x4000-0x7FFF could go to any bank, instead of just bank 1\n");
+		return 1;
+	}
+	const bool all_banks = (argc > 3 && strcmp(argv[3], "--all-banks") == 0);
+
+	std::ifstream rom_file(argv[1], std::ios::binary);
+	if (!rom_file){
+		fprintf(stderr, "Couldn't open ROM '%s'\n", argv[1]);
+		return 1;
+	}
+	std::vector<uint8_t> rom((std::istreambuf_iterator<char>(rom_file)), std::istreambuf_iterator<char>());
+	GB::Cartridge cartridge(rom);
+	const std::vector<Bank>& rom_banks = cartridge.mbc->rom_banks;
+
+	char rom_name[17] = {};
+	strncpy(rom_name, reinterpret_cast<const char*>(rom.data()) + GB::RomData::ROM_OFFSET_NAME, 16);
+	const uint16_t global_checksum = (rom[GB::RomData::ROM_OFFSET_GLOBAL_CHECKSUM] << 8) | rom[GB::RomData::ROM_OFFSET_GLOBAL_CHECKSUM + 1];
+
+	Recompiler recompiler(rom_banks, all_banks);
+	recompiler.find_blocks();
+
+	FILE* out = fopen(argv[2], "w");
+	if (out == nullptr){
+		fprintf(stderr, "Couldn't write to '%s'\n", argv[2]);
+		return 1;
+	}
+	recompiler.write(out, rom_name, global_checksum);
+	fclose(out);
+	return 0;
+}
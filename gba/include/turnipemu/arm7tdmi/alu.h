@@ -166,6 +166,28 @@ namespace TurnipEmu::ARM7TDMI::ALU {
 		friend std::ostream& operator << (std::ostream&, const MultiplyRequest&);
 	};
 
+	// ARM data processing instructions don't go through Request and Operation.
+	// There's a handler for every combination of opcode, S bit and form of operand 2, and decoding picks one.
+	namespace DataProcessing {
+		// Operand 2 is an immediate, or a register shifted by an immediate or by a register (one form for each ShiftType)
+		constexpr static uint8_t Operand2Forms = 9;
+		constexpr inline uint8_t operand2Form(bool immediate, bool shiftedByRegister, RequestInput::ShiftType shiftType){
+			if (immediate) return 0;
+			return (shiftedByRegister ? 5 : 1) + static_cast<uint8_t>(shiftType);
+		}
+		
+		struct Operands {
+			word immediate; // Already rotated
+			uint8_t operand1Register;
+			uint8_t operand2Register;
+			uint8_t shift; // The amount, or the register holding it
+			uint8_t destinationRegister;
+		};
+
+		// Fills in decoded.data with the Operands and picks the handler
+		void decode(word instructionWord, Instructions::DecodedInstruction& decoded);
+	}
+
 	// Arithmetic Ops
 	const extern ALU::Operation ADD;
 	const extern ALU::Operation ADC;
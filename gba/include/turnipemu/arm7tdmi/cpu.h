@@ -5,12 +5,14 @@
 #include "turnipemu/memory/map.h"
 
 #include "turnipemu/arm7tdmi/debug_windows.h"
+#include "turnipemu/arm7tdmi/decode_cache.h"
 #include "turnipemu/arm7tdmi/exceptions.h"
 #include "turnipemu/arm7tdmi/instruction_category.h"
 #include "turnipemu/arm7tdmi/modes.h"
 #include "turnipemu/arm7tdmi/pipeline.h"
 #include "turnipemu/arm7tdmi/registers.h"
 
+#include <array>
 #include <string>
 #include <memory>
 
@@ -27,23 +29,30 @@ namespace TurnipEmu::ARM7TDMI {
 		bool changedRegisters[16] = {false};
 
 		uint32_t cyclesThisTick;
-		uint32_t cyclesTotal;
+		uint64_t cyclesTotal = 0;
 			
 		// Only one of these can be in use at any one time. If it switches, the new one must be flushed to reset the variables
 		union {
 			Pipeline<ARM::InstructionCategory, word> armPipeline;
 			Pipeline<Thumb::InstructionCategory, halfword> thumbPipeline;
 		};
-		const PipelineBase* currentPipelineBaseData();
+		// The mode whose banked registers are in registers.main and registers.spsr.
+		// When the CPSR's mode doesn't match it any more, switchRegisterBank() has to be called.
+		Mode registerBankMode;
+		
+		const PipelineBase* currentPipelineBaseData() const;
 
-		// Determines the register pointers for the current state, taking into account the execution state and current instruction type
-		const RegisterPointers usableRegisters(bool shouldThrow = true);
+		const RegisterPointers usableRegisters();
+		// Puts the registers for registerBankMode back into their bank and swaps the ones for the CPSR's mode in.
+		// Throws if the CPSR's mode isn't valid.
+		void switchRegisterBank();
 
 		void resetPerTickVariables();
 	};
 	
 	class CPU {
 		friend class Debug::CPUStateWindow;
+		friend class Debug::ExecutionTrace;
 		
 	public:	   
 		CPU(Emulator& emulator, const Memory::Map& memoryMap);
@@ -54,7 +63,14 @@ namespace TurnipEmu::ARM7TDMI {
 
 		void reset();
 
-		inline uint32_t totalCycles(){
+		// Records every tick for the instruction inspector. It's off by default, and when it's off the CPU uses
+		// the fast pipeline, which doesn't keep the state the inspector shows.
+		void setTracing(bool enabled);
+		inline bool isTracing() const {
+			return tracing;
+		}
+
+		inline uint64_t totalCycles() const {
 			return state.cyclesTotal;
 		}
 
@@ -63,9 +79,12 @@ namespace TurnipEmu::ARM7TDMI {
 
 		// TODO: This should be protected and added through a CPU::registerDebugWindows function
 		Debug::CPUStateWindow debugStateWindow;
+		// Used by the pipelines, and has to be registered with the Memory::Map to see code being overwritten
+		DecodeCache decodeCache;
 	protected:		
 
 		CPUState state;
+		bool tracing = false;
 		
 		static void setupInstructions();
 		// These have to be vectors of unique_ptr because InstructionCategory is virtual
@@ -75,6 +94,19 @@ namespace TurnipEmu::ARM7TDMI {
 		static const ARM::InstructionCategory* matchArmInstruction(word instruction);
 		static const Thumb::InstructionCategory* matchThumbInstruction(halfword instruction);
 
+		// Decoding looks the category up from these instead of testing every mask.
+		// ARM is indexed by bits 27-20 and 7-4, Thumb by bits 15-6, and they're built from the same masks in the same order.
+		// A few ARM categories (BX, MRS, MSR, Single Data Swap) also check bits outside of the index,
+		// so where one of those could match the entry is nullptr and decoding falls back to the masks.
+		static std::array<const ARM::InstructionCategory*, 4096> armDecodeTable;
+		static std::array<const Thumb::InstructionCategory*, 1024> thumbDecodeTable;
+		inline static size_t armDecodeIndex(word instruction){
+			return ((instruction >> 16) & 0xFF0) | ((instruction >> 4) & 0xF);
+		}
+		inline static size_t thumbDecodeIndex(halfword instruction){
+			return instruction >> 6;
+		}
+
 		std::vector<word> breakpoints;
 		
 		const char* const logTag = "ARM7";
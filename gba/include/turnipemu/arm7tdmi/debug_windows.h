@@ -1,8 +1,7 @@
 #pragma once
 
-#include <deque>
-
 #include "turnipemu/display.h"
+#include "turnipemu/arm7tdmi/execution_trace.h"
 
 namespace TurnipEmu::ARM7TDMI {
 	class CPU;
@@ -24,14 +23,13 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 		CPU& cpu;
 		char newBreakpointIndex[9];
 		char instructionFilter[50];
-		std::deque<CPUState> stateHistory;
+		ExecutionTrace trace;
 		int selectedStateIndex = 0;
 		bool teleportToSelected = false;
 		bool showPartialPipelineStates = false;
 		bool mergeTightLoops = true;
 		int selectedRegister = -1;
 		int registerTraceStartStateIndex = -1;
-		constexpr static int maxStateMemory = 100'000;
 		constexpr static int maxTightLoopSize = 4;
 	};
 }
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "turnipemu/types.h"
+#include "turnipemu/memory/map.h"
+#include "turnipemu/arm7tdmi/instruction_category.h"
+
+#include <vector>
+
+namespace TurnipEmu::ARM7TDMI {
+	// Remembers the DecodedInstruction for each address the CPU has executed from, so loops only decode their instructions once.
+	// It's direct mapped, and an entry only matches if the instruction at the address is still the one that was decoded,
+	// so code that changes is always decoded again even if the write went through a mirror or wasn't seen.
+	// Writes to RAM pages which have decoded instructions in them also throw those entries away.
+	class DecodeCache : public Memory::WriteObserver {
+	public:
+		constexpr static size_t EntryCount = 4096;
+		// Only RAM can be written to and executed from
+		constexpr static word RAMStart = 0x0'0200'0000;
+		constexpr static word RAMEnd = 0x0'0400'0000;
+		constexpr static word PageSize = 1024;
+
+		DecodeCache();
+
+		// Returns nullptr if decodeInstructionFunction can't decode the instruction.
+		// The DecodedInstruction stays valid until another instruction of the same type is looked up.
+		template<typename InstructionType, typename DecodeInstructionFunction>
+		const Instructions::DecodedInstruction* lookup(word address, InstructionType instruction, DecodeInstructionFunction decodeInstructionFunction){
+			auto& entries = (sizeof(InstructionType) == sizeof(word)) ? armEntries : thumbEntries;
+			Entry& entry = entries[(address / sizeof(InstructionType)) % EntryCount];
+			if (entry.valid && entry.address == address && entry.decoded.instruction == instruction){
+				return &entry.decoded;
+			}
+
+			const auto* category = decodeInstructionFunction(instruction);
+			if (!category){
+				entry.valid = false;
+				return nullptr;
+			}
+			entry.address = address;
+			entry.decoded.category = category;
+			entry.decoded.instruction = instruction;
+			entry.decoded.condition = category->getCondition(instruction).code;
+			category->decode(instruction, entry.decoded);
+			entry.valid = true;
+			if (RAMStart <= address && address < RAMEnd){
+				codePages[(address - RAMStart) / PageSize] = true;
+			}
+			return &entry.decoded;
+		}
+		void clear();
+
+		void onWrite(uint32_t address, uint8_t byteWidth) override;
+
+	protected:
+		struct Entry {
+			bool valid;
+			word address;
+			Instructions::DecodedInstruction decoded;
+		};
+
+		void invalidatePage(word pageStart);
+
+		std::vector<Entry> armEntries;
+		std::vector<Entry> thumbEntries;
+		// One for each RAM page, set when an instruction from the page is decoded
+		std::vector<bool> codePages;
+	};
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "turnipemu/types.h"
+#include "turnipemu/arm7tdmi/modes.h"
+#include "turnipemu/arm7tdmi/registers.h"
+
+#include <deque>
+#include <vector>
+
+namespace TurnipEmu::ARM7TDMI {
+	struct CPUState;
+}
+
+namespace TurnipEmu::ARM7TDMI::Debug {
+	// What the CPU did on each tick, for the instruction inspector.
+	// Each tick only stores the registers it wrote, into fixed size ring buffers, and the full registers are kept every
+	// KeyframeInterval ticks and whenever the banked registers are swapped. A CPUState is rebuilt from those when it's needed.
+	class ExecutionTrace {
+	public:
+		constexpr static size_t Capacity = 1 << 17;
+		// When these run out the oldest records are dropped, even if there's space for them
+		constexpr static size_t ValueCapacity = Capacity * 2;
+		constexpr static size_t KeyframeInterval = 1024;
+
+		struct Record {
+			enum PipelineStage : uint8_t {
+				Fetched = 1 << 0,
+				Decoded = 1 << 1,
+				Executed = 1 << 2,
+			};
+			
+			word pc;
+			word decodedInstruction;
+			ProgramStatusRegister cpsr;
+			ProgramStatusRegister spsr;
+			uint32_t firstValue; // The new values of the changed registers, from r0 upwards, start here
+			uint16_t changedRegisters; // Bit n is set if rn was written to
+			uint8_t pipelineStages;
+
+			inline bool has(PipelineStage stage) const {
+				return pipelineStages & stage;
+			}
+			// The instruction which will be executed next
+			inline word decodedInstructionAddress() const {
+				return pc - 2 * instructionSize();
+			}
+			inline word instructionSize() const {
+				return (cpsr.state == CPUExecState::Thumb) ? sizeof(halfword) : sizeof(word);
+			}
+		};
+
+		// Has to be called before the first record
+		void clear(const CPUState& state);
+		// Called after every tick
+		void record(const CPUState& state);
+
+		// 0 is the oldest
+		inline size_t size() const {
+			return count;
+		}
+		inline const Record& operator[](size_t index) const {
+			return records[(start + index) % Capacity];
+		}
+		// The state of the CPU after that record, as far as the inspector needs it
+		void reconstruct(size_t index, CPUState& state) const;
+
+	protected:
+		struct Keyframe {
+			uint64_t recordNumber;
+			AllRegisters registers;
+			Mode registerBankMode;
+		};
+
+		void addKeyframe(const CPUState& state);
+		void dropOldest();
+		// Writes the registers the record changed
+		void replay(const Record& record, AllRegisters& registers) const;
+
+		std::vector<Record> records;
+		size_t start = 0;
+		size_t count = 0;
+		// Every record that's been made, including the dropped ones
+		uint64_t totalRecords = 0;
+
+		std::vector<word> values;
+		uint32_t totalValues = 0;
+
+		// The first one is always at the oldest record, and is rolled forward as records are dropped
+		std::deque<Keyframe> keyframes;
+		Mode lastRegisterBankMode;
+	};
+}
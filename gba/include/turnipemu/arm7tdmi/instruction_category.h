@@ -1,13 +1,16 @@
 #pragma once
 
+#include "turnipemu/arm7tdmi/pipeline.h"
 #include "turnipemu/arm7tdmi/registers.h"
 #include "turnipemu/utils.h"
 
-#include <functional>
+#include <array>
+#include <string>
+#include <new>
+#include <type_traits>
 
 namespace TurnipEmu::ARM7TDMI {
 	class CPU;
-	class PipelineBase;
 }
 
 namespace TurnipEmu::ARM7TDMI::Instructions {
@@ -72,10 +75,24 @@ namespace TurnipEmu::ARM7TDMI::Instructions {
 
 		word getNextInstructionAddress() const;
 
-		word get(int index);
-		void set(int index, word value) const;
-		ProgramStatusRegister& cpsr() const;
-		ProgramStatusRegister& spsr() const;
+		inline word get(int index){
+			assert(0 <= index && index <= 15);
+			if (index == 15 && reads >= 2) throw std::runtime_error("Not allowed to read the PC, could have incorrect value");
+			reads++;
+			return registers.main[index];
+		}
+		inline void set(int index, word value) const {
+			assert(0 <= index && index <= 15);
+			if (index == 15) pipeline->queueFlushFromInstruction();
+			registers.main[index] = value;
+			registers.changedRegisters[index] = true;
+		}
+		inline ProgramStatusRegister& cpsr() const {
+			return *registers.cpsr;
+		}
+		inline ProgramStatusRegister& spsr() const {
+			return *registers.spsr;
+		}
 	private:
 	    PipelineBase* const pipeline;
 		const RegisterPointers registers;
@@ -83,10 +100,80 @@ namespace TurnipEmu::ARM7TDMI::Instructions {
 		int reads = 0;
 	};
 	
+	// Bit n of the result is set if the condition passes when the NZCV flags (the top 4 bits of the CPSR) are n
+	constexpr uint16_t conditionPassMask(uint8_t conditionCode){
+		uint16_t passMask = 0;
+		for (uint8_t flags = 0; flags < 16; flags++){
+			const bool negative = flags & 0b1000;
+			const bool zero = flags & 0b0100;
+			const bool carry = flags & 0b0010;
+			const bool overflow = flags & 0b0001;
+			bool passes = false;
+			switch(conditionCode){
+			case 0x0: passes = zero; break;
+			case 0x1: passes = !zero; break;
+			case 0x2: passes = carry; break;
+			case 0x3: passes = !carry; break;
+			case 0x4: passes = negative; break;
+			case 0x5: passes = !negative; break;
+			case 0x6: passes = overflow; break;
+			case 0x7: passes = !overflow; break;
+			case 0x8: passes = carry && !zero; break;
+			case 0x9: passes = !carry || zero; break;
+			case 0xA: passes = negative == overflow; break;
+			case 0xB: passes = negative != overflow; break;
+			case 0xC: passes = !zero && (negative == overflow); break;
+			case 0xD: passes = zero || (negative != overflow); break;
+			case 0xE: passes = true; break;
+			default: passes = false; break; // NV, never on the ARM7TDMI
+			}
+			if (passes) passMask |= (1 << flags);
+		}
+		return passMask;
+	}
+	constexpr std::array<uint16_t, 16> makeConditionPassMasks(){
+		std::array<uint16_t, 16> passMasks = {};
+		for (uint8_t conditionCode = 0; conditionCode < 16; conditionCode++){
+			passMasks[conditionCode] = conditionPassMask(conditionCode);
+		}
+		return passMasks;
+	}
+	
 	struct Condition {
+		constexpr static std::array<uint16_t, 16> passMasks = makeConditionPassMasks();
+		constexpr static uint8_t Always = 0xE;
+		
+		inline static bool passes(uint8_t conditionCode, ProgramStatusRegister status){
+			return (passMasks[conditionCode] >> (status.value >> 28)) & 1;
+		}
+
+		// Only used for debugging, evaluating conditions only needs the code
+		uint8_t code;
 		char name[3];
-		std::string debugString;
-		std::function<bool(ProgramStatusRegister)> fulfilsCondition;
+		const char* debugString;
+
+		inline bool fulfilsCondition(ProgramStatusRegister status) const {
+			return passes(code, status);
+		}
+	};
+
+	class BaseInstructionCategory;
+
+	// An instruction that has already been decoded, kept by the DecodeCache so it doesn't have to be decoded again.
+	// data holds the category's own InstructionData, and handler executes from it directly.
+	struct DecodedInstruction {
+		using Handler = void(*)(const BaseInstructionCategory& category, CPU& cpu, InstructionRegisterInterface registers, const DecodedInstruction& decoded);
+		
+		const BaseInstructionCategory* category;
+		Handler handler;
+		word instruction;
+		uint8_t condition;
+		alignas(8) std::array<uint8_t, 144> data; // Thumb::ALULowRegistersInstruction is the biggest
+
+		template<typename DataType>
+		inline const DataType& as() const {
+			return *reinterpret_cast<const DataType*>(data.data());
+		}
 	};
 
 	class BaseInstructionCategory {
@@ -101,11 +188,44 @@ namespace TurnipEmu::ARM7TDMI::Instructions {
 		virtual void execute(CPU& cpu, InstructionRegisterInterface, word instruction) const {
 			throw std::runtime_error(Utils::streamFormat("Instruction '", name ,"' is not implemented!"));
 		}
+		// Fills in decoded.handler and decoded.data. By default the handler just calls execute() with the instruction.
+		virtual void decode(word instruction, DecodedInstruction& decoded) const {
+			decoded.handler = [](const BaseInstructionCategory& category, CPU& cpu, InstructionRegisterInterface registers, const DecodedInstruction& decoded){
+				category.execute(cpu, registers, decoded.instruction);
+			};
+		}
 
 		const std::string name;
 		const Mask<word> mask;
 	};
 
+	// For categories which decode the instruction into an InstructionData and then execute from that.
+	// Derived must have InstructionData(InstructionType) and executeDecoded(CPU&, InstructionRegisterInterface, InstructionData&),
+	// and make this a friend if they're private. The InstructionData is copied before executeDecoded, so it can be changed.
+	template<typename Derived, typename Base>
+	class CachedDecode : public Base {
+	public:
+		using Base::Base;
+
+		void decode(word instruction, DecodedInstruction& decoded) const override {
+			using InstructionData = typename Derived::InstructionData;
+			static_assert(sizeof(InstructionData) <= sizeof(DecodedInstruction::data), "InstructionData doesn't fit in a DecodedInstruction");
+			static_assert(alignof(InstructionData) <= alignof(DecodedInstruction), "InstructionData doesn't fit in a DecodedInstruction");
+			static_assert(std::is_trivially_copyable<InstructionData>::value && std::is_trivially_destructible<InstructionData>::value,
+						  "InstructionData is copied around as bytes");
+			
+			new (decoded.data.data()) InstructionData(instruction);
+			decoded.handler = [](const BaseInstructionCategory& category, CPU& cpu, InstructionRegisterInterface registers, const DecodedInstruction& decoded){
+				InstructionData data = decoded.as<InstructionData>();
+				static_cast<const Derived&>(category).executeDecoded(cpu, registers, data);
+			};
+		}
+		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
+			typename Derived::InstructionData data(instruction);
+			static_cast<const Derived*>(this)->executeDecoded(cpu, registers, data);
+		}
+	};
+
 	namespace ARM {
 		class InstructionCategory : public BaseInstructionCategory {
 		public:
@@ -115,7 +235,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions {
 			
 			const Condition& getCondition(word instruction) const override;
 
-			const static std::array<const Condition, 15> conditions;
+			const static std::array<const Condition, 16> conditions;
 		};
 	}
 	namespace Thumb {
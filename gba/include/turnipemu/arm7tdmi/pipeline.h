@@ -2,13 +2,12 @@
 
 #include "registers.h"
 
-#include <functional>
-
 namespace TurnipEmu::ARM7TDMI {
 
 	class CPU;
 	namespace Instructions {
 		class BaseInstructionCategory;
+		struct DecodedInstruction;
 	};
 		
 	class PipelineBase {
@@ -19,6 +18,8 @@ namespace TurnipEmu::ARM7TDMI {
 		bool hasDecodedInstruction;
 		word decodedInstructionAddress;
 		const Instructions::BaseInstructionCategory* decodedInstructionCategory;
+		// Owned by the CPU's DecodeCache
+		const Instructions::DecodedInstruction* decodedInstructionData;
 
 		bool hasExecutedInstruction;
 		word executedInstructionAddress;
@@ -32,14 +33,31 @@ namespace TurnipEmu::ARM7TDMI {
 		bool flushQueuedByInstruction;
 	};
 	
+	// tick() goes through every stage and keeps all of the fields up to date, for the instruction inspector.
+	// fastTick() only keeps track of hasFetchedInstruction and hasDecodedInstruction, and works out which instruction
+	// to execute from the PC (it's always two instructions behind). The instruction is read and decoded when it's executed,
+	// so unlike the hardware it will see writes to the next two instructions.
+	// materialize() fills the rest of the fields back in, to go from fastTick() to tick().
 	template<typename InstructionCategoryType, typename InstructionType>
 	class Pipeline : public PipelineBase {
 	public:
+		using DecodeInstructionFunction = const InstructionCategoryType*(*)(InstructionType);
+		
 		InstructionType fetchedInstruction;
 			
 		InstructionType decodedInstruction;
 
-		void tick(CPU& cpu, RegisterPointers currentRegisters, std::function<const InstructionCategoryType*(InstructionType)> decodeInstructionFunction);
+		template<DecodeInstructionFunction Decode>
+		void tick(CPU& cpu, RegisterPointers currentRegisters);
+		template<DecodeInstructionFunction Decode>
+		void fastTick(CPU& cpu, RegisterPointers currentRegisters);
+		template<DecodeInstructionFunction Decode>
+		void materialize(CPU& cpu, RegisterPointers currentRegisters);
 		void flush();
+
+	protected:
+		InstructionType fetch(CPU& cpu, word address);
+		template<DecodeInstructionFunction Decode>
+		const Instructions::DecodedInstruction* decode(CPU& cpu, word address, InstructionType instruction);
 	};
 }
@@ -29,23 +29,26 @@ namespace TurnipEmu::ARM7TDMI {
 		
     // This is used by the instructions 
 	struct RegisterPointers{
-		word* main[16] = {nullptr};
-		bool* changedRegisters[16] = {nullptr};
+		word* main = nullptr; // The 16 registers for the current mode
+		bool* changedRegisters = nullptr;
 			
 		ProgramStatusRegister* cpsr = nullptr;
 		ProgramStatusRegister* spsr = nullptr; // Not enabled in System/User mode
 
 		inline word& pc() const {
-			return *main[15];
+			return main[15];
 		}
 		inline word& lr() const {
-			return *main[14];
+			return main[14];
 		}
 		inline word& sp() const {
-			return *main[13];
+			return main[13];
 		}
 	};
 
+	// main and spsr are the registers for the current mode.
+	// The banked registers are only swapped in and out of them when the mode changes (see CPUState::switchRegisterBank),
+	// so the banks only hold the values for the modes which aren't being used.
 	struct AllRegisters{	
 		word main[16];
 
@@ -54,7 +57,18 @@ namespace TurnipEmu::ARM7TDMI {
 		}
 		
 		ProgramStatusRegister cpsr;
-			
+		ProgramStatusRegister spsr;
+
+		// Shared by User and System mode, and r8-r12 are also used by every mode except FIQ
+		struct{
+			word r8;
+			word r9;
+			word r10;
+			word r11;
+			word r12;
+			word r13;
+			word r14;
+		} user;
 		struct{
 			word r8;
 			word r9;
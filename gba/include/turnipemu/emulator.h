@@ -17,7 +17,7 @@ namespace TurnipEmu{
 		}
 		
 		virtual void tick() = 0;
-		void tickUntilVSyncOrStopped(){
+		virtual void tickUntilVSyncOrStopped(){
 			while(!paused && !stopped && !vsyncReady){
 				this->tick();
 			}
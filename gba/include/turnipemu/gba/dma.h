@@ -2,20 +2,30 @@
 
 #include "turnipemu/types.h"
 #include "turnipemu/memory/map.h"
+#include "turnipemu/gba/scheduler.h"
+
+#include <array>
 
 namespace TurnipEmu::GBA{
 	class DMAEngine : public Memory::RangeController {
 	public:
-		DMAEngine();
+		DMAEngine(Scheduler& scheduler);
 		
+		// Called for the DMA event, and at the start of HBlank and VBlank
 		void execute(Memory::Map& memoryMap);
 
 		bool allowRead(uint32_t address) const override;
 		byte read(uint32_t address) const override;
 		bool allowWrite(uint32_t address) const override;
 		void write(uint32_t address, byte value) override;
+		void write16(uint32_t address, halfword value) override;
+		void write32(uint32_t address, word value) override;
 
 	protected:
+		void writeBytes(uint32_t address, word value, int byteWidth);
+
+		Scheduler& scheduler;
+		
 #pragma pack(1) // No Padding
 		enum class AddressControl : uint8_t {
 			Increment = 0,
@@ -64,6 +74,12 @@ namespace TurnipEmu::GBA{
 			inline bool enabled(){
 				return externalState.enable;
 			}
+			// Called when the channel is enabled
+			inline void latch(){
+				sourceAddress = externalState.sourceAddressOnStart;
+				destinationAddress = externalState.destinationAddressOnStartOrReload;
+				transferCount = externalState.transferCountOnStart;
+			}
 		};
 		std::array<DMAChannel, 4> channels;
 #pragma pack()
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "turnipemu/display.h"
@@ -17,7 +19,7 @@ namespace TurnipEmu::GBA{
 		}
 		byte read(uint32_t address) const override {
 			uint32_t rel_address = address - startAddress;
-			if (rel_address < 0x0E000000){
+			if (address < 0x0E000000){
 				// The ROM is mirrored 3 times
 				// Wait State 0 (0x08000000 - 0x09FFFFFF)
 				// Wait State 1 (0x0A000000 - 0x0BFFFFFF)
@@ -26,15 +28,41 @@ namespace TurnipEmu::GBA{
 				if (rom_address >= rom.size()) return 0;
 				return rom[rom_address];
 			}else{
-				word backup_address = rel_address - 0x0E000000;
+				word backup_address = address - 0x0E000000;
 				if (backup_address >= backup.size()) return 0;
 				return backup[backup_address];
 			}
 		}
+		// The backup is on an 8 bit bus, so only the ROM is read at full width
+		halfword read16(uint32_t address) const override {
+			return readRom<halfword>(address);
+		}
+		word read32(uint32_t address) const override {
+			return readRom<word>(address);
+		}
+		// Only the ROM itself, reading past its end and the backup go through read()
+		Memory::DirectMemory directMemory(uint32_t address, uint32_t maxSize) override {
+			if (address < startAddress || address >= 0x0E000000) return {};
+			word rom_address = (address - startAddress) % 0x02000000;
+			if (rom_address >= rom.size()) return {};
+			return { &rom[rom_address], nullptr, static_cast<uint32_t>(std::min<size_t>(maxSize, rom.size() - rom_address)) };
+		}
 
 		void drawCustomWindowContents() override;
 		
 	protected:
+		template<typename T>
+		T readRom(uint32_t address) const {
+			word rom_address = (address - startAddress) % 0x02000000;
+			if (address >= 0x0E000000 || rom_address + sizeof(T) > rom.size()){
+				if constexpr (sizeof(T) == sizeof(halfword)) return Memory::Controller::read16(address);
+				else return Memory::Controller::read32(address);
+			}
+			T value;
+			memcpy(&value, &rom[rom_address], sizeof(T));
+			return value;
+		}
+		
 		struct {
 			char title[12 + 1];
 			char gameCode[4 + 1];
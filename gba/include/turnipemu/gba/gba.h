@@ -11,6 +11,7 @@
 #include "turnipemu/gba/internal_ram.h"
 #include "turnipemu/gba/interrupt_control.h"
 #include "turnipemu/gba/keypad.h"
+#include "turnipemu/gba/scheduler.h"
 #include "turnipemu/gba/sound.h"
 #include "turnipemu/gba/timer.h"
 #include "turnipemu/gba/unused_memory.h"
@@ -21,7 +22,10 @@ namespace TurnipEmu::GBA{
 	public:
 		GBA(Display& display, std::vector<byte> biosData, GamePak gamePak);
 
+		// One instruction, and any events which are due after it
 		void tick() override;
+		// Runs the CPU without stopping until each event is due
+		void tickUntilVSyncOrStopped() override;
 		
 		void reset() override;
 		void reset(GamePak newGamePak);		
@@ -29,6 +33,7 @@ namespace TurnipEmu::GBA{
 		Memory::Map memoryMap;
 		
 		ARM7TDMI::CPU cpu;
+		Scheduler scheduler;
 		
 		Memory::StaticDataRangeController<std::vector<byte>> bios;
 		GamePak gamePak;
@@ -47,6 +52,9 @@ namespace TurnipEmu::GBA{
 		OnBoardRam boardRam;
 		OnChipRam chipRam;
 
+		void runDueEvents();
+		void handleException(const std::exception& e);
+
 		const char* const logTag = "GBA";
 	};
 }
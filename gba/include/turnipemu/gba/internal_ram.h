@@ -1,8 +1,11 @@
 #pragma once
 
 #include "turnipemu/types.h"
+#include "turnipemu/memory/controllers.h"
 
+#include <algorithm>
 #include <array>
+#include <cstring>
 
 namespace TurnipEmu::GBA {
 	template<size_t RangeStart, size_t RangeEnd, size_t Size>
@@ -24,7 +27,36 @@ namespace TurnipEmu::GBA {
 		void write(uint32_t address, uint8_t value) override {
 			data[(address - RangeStart) % Size] = value;
 		}
+		halfword read16(uint32_t address) const override {
+			return readSized<halfword>(address);
+		}
+		word read32(uint32_t address) const override {
+			return readSized<word>(address);
+		}
+		void write16(uint32_t address, halfword value) override {
+			writeSized(address, value);
+		}
+		void write32(uint32_t address, word value) override {
+			writeSized(address, value);
+		}
+		Memory::DirectMemory directMemory(uint32_t address, uint32_t maxSize) override {
+			if (!ownsAddress(address)) return {};
+			const size_t offset = (address - RangeStart) % Size;
+			return { &data[offset], &data[offset], static_cast<uint32_t>(std::min<size_t>(maxSize, Size - offset)) };
+		}
 	protected:
+		// Size is a multiple of 4, so an aligned access never wraps around the mirror
+		template<typename T>
+		T readSized(uint32_t address) const {
+			T value;
+			memcpy(&value, &data[(address - RangeStart) % Size], sizeof(T));
+			return value;
+		}
+		template<typename T>
+		void writeSized(uint32_t address, T value){
+			memcpy(&data[(address - RangeStart) % Size], &value, sizeof(T));
+		}
+		
 		std::array<byte, Size> data;
 	};
 
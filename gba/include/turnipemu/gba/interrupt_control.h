@@ -6,6 +6,24 @@
 namespace TurnipEmu::GBA{
 	class InterruptControl : public Memory::Controller {
 	public:
+		// The bits in IE and IF
+		enum class Interrupt : halfword {
+			VBlank = 1 << 0,
+			HBlank = 1 << 1,
+			VCountMatch = 1 << 2,
+			Timer0Overflow = 1 << 3,
+			Timer1Overflow = 1 << 4,
+			Timer2Overflow = 1 << 5,
+			Timer3Overflow = 1 << 6,
+			Serial = 1 << 7,
+			DMA0 = 1 << 8,
+			DMA1 = 1 << 9,
+			DMA2 = 1 << 10,
+			DMA3 = 1 << 11,
+			Keypad = 1 << 12,
+			External = 1 << 13,
+		};
+		
 		bool ownsAddress(uint32_t address) const override;
 		bool allowRead(uint32_t address) const override;
 		byte read(uint32_t address) const override;
@@ -13,6 +31,8 @@ namespace TurnipEmu::GBA{
 		void write(uint32_t address, byte value) override;
 
 		void tick(); // TODO: Implement
+		// Sets the interrupt's bit in IF. The CPU doesn't take interrupts yet.
+		void request(Interrupt interrupt);
 		
 		void reset();
 	protected:
@@ -7,19 +7,46 @@
 #include "turnipemu/memory/map.h"
 
 namespace TurnipEmu::GBA{
+	class InterruptControl;
+	
 	class LCDEngine : public Memory::Controller{
 	public:
+		// In CPU cycles. HBlank takes up the rest of the scanline.
+		constexpr static uint32_t HDrawCycles = 960;
+		constexpr static uint32_t ScanlineCycles = 1232;
+		// VBlank takes up the rest of the scanlines
+		constexpr static uint8_t VisibleScanlines = 160;
+		constexpr static uint8_t TotalScanlines = 228;
+		
 		// TODO: Everything else
+
+		void reset();
+		// These are called by the GBA's scheduled events, and set DISPSTAT and request its interrupts.
+		void startHBlank(InterruptControl& interrupts);
+		// Returns true if it's the first scanline of VBlank
+		bool nextScanline(InterruptControl& interrupts);
 		
 		bool ownsAddress(uint32_t address) const override;
 		bool allowRead(uint32_t address) const override;
 		byte read(uint32_t address) const override;
 		bool allowWrite(uint32_t address) const override;
 		void write(uint32_t address, byte value) override;
+		halfword read16(uint32_t address) const override;
+		word read32(uint32_t address) const override;
+		// The IO registers are still written a byte at a time, for DISPSTAT's read only bits
+		void write16(uint32_t address, halfword value) override;
+		void write32(uint32_t address, word value) override;
+		// Palette RAM, VRAM and OAM. The IO registers have side effects.
+		Memory::DirectMemory directMemory(uint32_t address, uint32_t maxSize) override;
 		// TODO: Memory cycles
 
 	protected:
 		byte* ownedAddressToByte(uint32_t address);
+		const byte* ownedAddressToByte(uint32_t address) const;
+		template<typename T>
+		T readSized(uint32_t address) const;
+		template<typename T>
+		void writeSized(uint32_t address, T value);
 		
 #pragma pack(1) // No Padding
 
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "turnipemu/types.h"
+
+#include <array>
+#include <limits>
+
+namespace TurnipEmu::ARM7TDMI {
+	class CPU;
+}
+
+namespace TurnipEmu::GBA{
+	// Everything which happens at a given cycle rather than on an access, against the CPU's cycle count.
+	// Each kind of event is either scheduled once or not at all, so the CPU only has to compare its cycle count
+	// against nextEventCycle() to know if it can keep running.
+	class Scheduler {
+	public:
+		enum class Event : uint8_t {
+			HBlank, // The visible part of the scanline has been drawn
+			ScanlineEnd, // Moves on to the next scanline, which can start or end VBlank
+			Timer0Overflow,
+			Timer1Overflow,
+			Timer2Overflow,
+			Timer3Overflow,
+			DMA, // A DMA channel was started straight away
+			Count
+		};
+		constexpr static size_t EventCount = static_cast<size_t>(Event::Count);
+		constexpr static uint64_t Never = std::numeric_limits<uint64_t>::max();
+
+		Scheduler(const ARM7TDMI::CPU& cpu);
+
+		// The cycle the CPU is on
+		uint64_t now() const;
+
+		void reset();
+		// Replaces the event if it's already scheduled
+		void schedule(Event event, uint64_t cycle);
+		inline void scheduleAfter(Event event, uint64_t cycles){
+			schedule(event, now() + cycles);
+		}
+		void cancel(Event event);
+		inline bool isScheduled(Event event) const {
+			return eventCycles[static_cast<size_t>(event)] != Never;
+		}
+		inline uint64_t cycleOf(Event event) const {
+			return eventCycles[static_cast<size_t>(event)];
+		}
+
+		inline uint64_t nextEventCycle() const {
+			return nextCycle;
+		}
+		// Unschedules the earliest event due by cycle and returns true, or returns false if there isn't one.
+		// cycle is set to the cycle it was due on, which repeating events should be scheduled from so they don't drift.
+		bool popDueEvent(uint64_t now, Event& event, uint64_t& cycle);
+
+	protected:
+		void findNextEvent();
+
+		const ARM7TDMI::CPU& cpu;
+
+		std::array<uint64_t, EventCount> eventCycles;
+		uint64_t nextCycle = Never;
+	};
+}
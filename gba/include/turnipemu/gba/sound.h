@@ -5,13 +5,16 @@
 #include "turnipemu/types.h"
 #include "turnipemu/utils.h"
 #include "turnipemu/memory/map.h"
+#include "turnipemu/gba/timer.h"
 
 namespace TurnipEmu::GBA{
-	class SoundEngine : public Memory::RangeController {
+	class SoundEngine : public Memory::RangeController, public TimerOverflowObserver {
 	public:
 		SoundEngine();
 
 		const std::vector<uint8_t>& generateSamples(size_t count);
+		// Direct Sound A and B each move on to their FIFO's next sample when the timer they've selected overflows
+		void onTimerOverflow(int timerIndex, uint64_t cycle) override;
 		
 		// TODO: Define sound behaviour
 
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "turnipemu/memory/controllers.h"
+#include "turnipemu/memory/map.h"
 #include "turnipemu/types.h"
 
 namespace TurnipEmu::GBA{
+	// Also works out how long each area of memory takes to access, and gives it to the Map whenever the waitstates change
 	class SystemControl : public Memory::Controller {
 	public:
+		SystemControl(Memory::Map& memoryMap);
+		
 		bool ownsAddress(uint32_t address) const override;
 		bool allowRead(uint32_t address) const override;
 		byte read(uint32_t address) const override;
@@ -14,6 +18,10 @@ namespace TurnipEmu::GBA{
 		
 		void reset();
 	protected:
+		void updateMemoryTiming();
+
+		Memory::Map& memoryMap;
+		
 #pragma pack(1)
 		// Access cycle data through public functions, not 
 		union WaitstateControl {
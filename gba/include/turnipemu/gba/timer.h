@@ -2,22 +2,51 @@
 
 #include "turnipemu/types.h"
 #include "turnipemu/memory/controllers.h"
+#include "turnipemu/gba/scheduler.h"
+
+#include <array>
+#include <vector>
 
 namespace TurnipEmu::GBA{
 	class InterruptControl;
+
+	// Told about every overflow, after the timer has been reloaded. Timers 0 and 1 drive the Direct Sound FIFOs.
+	class TimerOverflowObserver {
+	public:
+		virtual ~TimerOverflowObserver() = default;
+		virtual void onTimerOverflow(int timerIndex, uint64_t cycle) = 0;
+	};
 	
+	// Nothing happens per cycle. A running timer remembers the cycle it started counting from, its counter is worked out
+	// from that when it's read, and its overflow is scheduled. Count up timers are only changed by the previous timer's overflow.
 	class TimerEngine : public Memory::RangeController {
 	public:
-		TimerEngine();
+		TimerEngine(Scheduler& scheduler);
 
-		void execute(InterruptControl&);
+		void reset();
+		void registerOverflowObserver(TimerOverflowObserver* overflowObserver);
+		// Called for the timer's overflow event. cycle is the one it overflowed on.
+		// Reloads it, requests its interrupt, tells the observers and increments the next timer if that counts up.
+		void overflow(int timerIndex, uint64_t cycle, InterruptControl& interrupts);
 		
 		bool allowRead(uint32_t address) const override;
 		byte read(uint32_t address) const override;
 		bool allowWrite(uint32_t address) const override;
 		void write(uint32_t address, byte value) override;
+		void write16(uint32_t address, halfword value) override;
+		void write32(uint32_t address, word value) override;
 
 	private:
+		void writeBytes(uint32_t address, word value, int byteWidth);
+		// True if the timer counts cycles, rather than the previous timer's overflows
+		bool runsOnClock(int timerIndex) const;
+		halfword counterValue(int timerIndex) const;
+		// Schedules the overflow event from startCycle and counter, or cancels it
+		void scheduleOverflow(int timerIndex);
+
+		Scheduler& scheduler;
+		std::vector<TimerOverflowObserver*> overflowObservers;
+		
 #pragma pack(1)
 		struct TimerData {
 			union {
@@ -31,12 +60,19 @@ namespace TurnipEmu::GBA{
 					uint8_t dummy1 : 8; // Bits 8-15
 				};
 			} control;
+			// For a timer that runsOnClock() it's the value at startCycle, otherwise it's the current value
 			halfword counter = 0;
 			halfword reload; // The counter is reset to this value 1) on overflow 2) when control.enable is set to true
+			uint64_t startCycle = 0;
 
-			inline bool enabled(){
+			inline bool enabled() const {
 				return control.enable;
 			}
+			// The counter goes up once every 1, 64, 256 or 1024 cycles
+			inline uint32_t prescalerShift() const {
+				constexpr static uint8_t shifts[4] = { 0, 6, 8, 10 };
+				return shifts[control.prescalerSelection];
+			}
 			
 			TimerData() {
 				control.enable = false;
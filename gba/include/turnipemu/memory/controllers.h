@@ -1,15 +1,29 @@
 #pragma once
 
 #include <assert.h>
+#include <algorithm>
 #include <memory>
 
 #include "turnipemu/types.h"
 
 namespace TurnipEmu::Memory{
+	// Memory that's a plain array of bytes, which the Map can read and write itself without going through a Controller
+	struct DirectMemory {
+		const byte* read = nullptr;
+		byte* write = nullptr; // nullptr if writes have to go through the Controller
+		uint32_t size = 0; // How many bytes from the requested address can be accessed through the pointers
+	};
+
     // An interface for reading and writing bytes from memory. 
 	class Controller {
 	public:
 		virtual bool ownsAddress(uint32_t address) const = 0;
+
+		// The Map asks for every page, and accesses the returned memory directly instead of calling read() and write().
+		// Only memory that doesn't overlap any other Controller and has no side effects on access should be returned.
+		virtual DirectMemory directMemory(uint32_t address, uint32_t maxSize){
+			return {};
+		}
 	
 		virtual bool allowRead(uint32_t address) const = 0;
 		virtual byte read(uint32_t address) const = 0;
@@ -18,27 +32,21 @@ namespace TurnipEmu::Memory{
 		}
 		virtual void write(uint32_t address, byte value){}
 
-		virtual uint8_t cyclesForRead(uint32_t address, uint8_t byteWidth) const {
-			switch(byteWidth){
-			case 1:
-			case 2:
-			case 4:
-				return 1;
-			default:
-				assert(false);
-				return 0; // 0 is for an unsupported read width
-			}
+		// Aligned halfword and word accesses. By default they're made of byte accesses from the lowest address up,
+		// controllers override them to access their memory at full width or to act on a register once it's been completely written.
+		virtual halfword read16(uint32_t address) const {
+			return read(address) | (read(address + 1) << 8);
 		}
-		virtual uint8_t cyclesForWrite(uint32_t address, uint8_t byteWidth) const {
-			switch(byteWidth){
-			case 1:
-			case 2:
-			case 4:
-				return 1;
-			default:
-				assert(false);
-				return 0; // 0 is for an unsupported read width
-			}
+		virtual word read32(uint32_t address) const {
+			return read16(address) | (word(read16(address + 2)) << 16);
+		}
+		virtual void write16(uint32_t address, halfword value){
+			write(address, value & 0xFF);
+			write(address + 1, value >> 8);
+		}
+		virtual void write32(uint32_t address, word value){
+			write16(address, value & 0xFFFF);
+			write16(address + 2, value >> 16);
 		}
 	};
 
@@ -70,6 +78,10 @@ namespace TurnipEmu::Memory{
 		byte read(uint32_t address) const override {
 			return data[address - startAddress];
 		}
+		DirectMemory directMemory(uint32_t address, uint32_t maxSize) override {
+			if (!ownsAddress(address)) return {};
+			return { &data[address - startAddress], nullptr, std::min(maxSize, endAddress - address) };
+		}
 	protected:
 		StorageClass data;
 	};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <assert.h>
+#include <cstring>
 #include <vector>
 #include <optional>
 
@@ -11,6 +12,19 @@ namespace TurnipEmu{
 	class Emulator;
 	
 	namespace Memory{
+		// Told about every successful write through the Map, after it's happened
+		class WriteObserver {
+		public:
+			virtual ~WriteObserver() = default;
+			virtual void onWrite(uint32_t address, uint8_t byteWidth) = 0;
+		};
+
+		// How many cycles an access takes, counting the one every access takes
+		struct AccessTiming {
+			// Indexed by [sequential][0 for a byte, 1 for a halfword, 2 for a word]
+			uint8_t cycles[2][3] = { { 1, 1, 1 }, { 1, 1, 1 } };
+		};
+		
 		class Map {
 			// Read/Write Pseudocode
 			// 1. Check if there's a DMA transfer either TO or FROM this address. Disallow if so. (TODO: Allow writes when transferring from?)
@@ -19,28 +33,105 @@ namespace TurnipEmu{
 			// 4. Do the op.
 		
 		public:
+			// The address bus is 28 bits wide, anything above is always an invalid access
+			constexpr static uint32_t AddressSpaceSize = 0x1000'0000;
+			constexpr static uint32_t PageBits = 14; // 16KB pages
+			constexpr static uint32_t PageSize = 1 << PageBits;
+			constexpr static uint32_t PageCount = AddressSpaceSize / PageSize;
+			
 			Map(Emulator& emulator);
+			// Controllers registered first take priority
 			void registerMemoryController(Controller* memoryController);
+			void registerWriteObserver(WriteObserver* writeObserver);
+			// Asks every controller for its direct memory again, for when the storage behind it has moved
+			void remapDirectMemory();
 
-			void beginTick();
-			void endTick();
+			// For every page in [startAddress, endAddress), which have to be on page boundaries
+			void setTiming(uint32_t startAddress, uint32_t endAddress, const AccessTiming& timing);
+			// Adds an access's cycles to the total, without doing it.
+			// An access is sequential if it's to the address just after the previous one.
+			template<typename AccessType>
+			inline void addAccessCycles(uint32_t address) const {
+				if (address >= AddressSpaceSize) return;
+				const bool sequential = (address == nextSequentialAddress);
+				accessCycles += pages[address >> PageBits].timing.cycles[sequential][sizeof(AccessType) >> 1];
+				nextSequentialAddress = address + sizeof(AccessType);
+			}
+			// The cycles taken by the emulator's accesses since the last call
+			inline uint32_t takeAccessCycles() const {
+				const uint32_t cycles = accessCycles;
+				accessCycles = 0;
+				return cycles;
+			}
 		
-			// Instantiated for byte, halfword, word
+			// Instantiated for byte, halfword, word.
+			// Accesses by the emulator take cycles, the ones by the debugger don't.
 			template<typename ReadType>
-			std::optional<ReadType> read(uint32_t address, bool accessByEmulator = true) const;
+			inline std::optional<ReadType> read(uint32_t address, bool accessByEmulator = true) const {
+				if (accessByEmulator) addAccessCycles<ReadType>(address);
+				return readWithoutTiming<ReadType>(address, accessByEmulator);
+			}
+			// For reads which don't happen on the bus when they're made, like the fast pipeline's instruction reads
+			template<typename ReadType>
+			inline std::optional<ReadType> readWithoutTiming(uint32_t address, bool accessByEmulator = true) const {
+				if (address < AddressSpaceSize && address % sizeof(ReadType) == 0){
+					const Page& page = pages[address >> PageBits];
+					const uint32_t offset = address & (PageSize - 1);
+					if (offset < page.size){
+						ReadType value;
+						memcpy(&value, page.read + offset, sizeof(ReadType));
+						return {value};
+					}
+				}
+				return readThroughController<ReadType>(address, accessByEmulator);
+			}
 			template<typename WriteType>
-			bool write(uint32_t address, WriteType value, bool accessByEmulator = true) const;
+			inline bool write(uint32_t address, WriteType value, bool accessByEmulator = true) const {
+				if (accessByEmulator) addAccessCycles<WriteType>(address);
+				if (address < AddressSpaceSize && address % sizeof(WriteType) == 0){
+					const Page& page = pages[address >> PageBits];
+					const uint32_t offset = address & (PageSize - 1);
+					if (offset < page.size && page.write){
+						memcpy(page.write + offset, &value, sizeof(WriteType));
+						notifyWriteObservers(address, sizeof(WriteType));
+						return true;
+					}
+				}
+				return writeThroughController<WriteType>(address, value, accessByEmulator);
+			}
 		protected:
+			// The GBA is little endian, so the host's loads and stores can be used on the direct memory as they are
+			static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Direct memory access assumes a little endian host");
+
+			// Accesses in [0, size) go straight to the pointers, anything else goes through the controllers
+			struct Page {
+				const byte* read = nullptr;
+				byte* write = nullptr;
+				uint32_t size = 0;
+				AccessTiming timing;
+			};
+			
+			void mapDirectMemory(Controller* memoryController);
 			Controller* controllerForAddress(uint32_t address, bool accessByEmulator) const;
+			template<typename ReadType>
+			std::optional<ReadType> readThroughController(uint32_t address, bool accessByEmulator) const;
+			template<typename WriteType>
+			bool writeThroughController(uint32_t address, WriteType value, bool accessByEmulator) const;
+			inline void notifyWriteObservers(uint32_t address, uint8_t byteWidth) const {
+				for (auto* observer : writeObservers){
+					observer->onWrite(address, byteWidth);
+				}
+			}
 
 			std::vector<Controller*> memoryControllers;
-			// TODO: std::unordered_map<uint32_t, MemoryController*> could be used as a cache? Use FIFO to limit total space taken up?
+			std::vector<WriteObserver*> writeObservers;
+			std::vector<Page> pages;
 
 			Emulator& emulator;
 		
-			// TODO: Remember to make this happen still, just without using a ref here
-			// ARM7TDMI& cpu; // Memory reads take cycles, and affect the CPU registers.
-			uint8_t memoryAccessCyclesThisTick;
+			// Reads are const, but still take time
+			mutable uint32_t accessCycles = 0;
+			mutable uint32_t nextSequentialAddress = 0;
 		
 			const char* const logTag = "MEM";
 		};
@@ -3,17 +3,19 @@
 #include "turnipemu/utils.h"
 #include "turnipemu/log.h"
 
+#include <new>
+#include <utility>
+
 namespace TurnipEmu::ARM7TDMI::ALU {
 	template<bool WithCarry>
 	auto Add(word arg1, word arg2, int carryIn){
-		uint64_t ulongResult = (uint64_t)arg1 + (uint64_t)arg2 + (WithCarry ? carryIn : 0);
-		int64_t slongResult = TURNIPEMU_UINT32_TO_SINT64(arg1) + TURNIPEMU_UINT32_TO_SINT64(arg2) + (WithCarry ? carryIn : 0);
-		OpOutput<OpType::Arithmetic> output(
-			word(ulongResult),
-			(ulongResult >> 32) & 1,
-			(slongResult > std::numeric_limits<int32_t>::max()) || (slongResult < std::numeric_limits<int32_t>::lowest())
-			);
-		return output;
+		if (!WithCarry) carryIn = 0;
+		// Adding the carry can only overflow if adding the arguments didn't, and if both overflow the signed result is back in range
+		word partialResult, result;
+		const bool carry = __builtin_add_overflow(arg1, arg2, &partialResult) | __builtin_add_overflow(partialResult, word(carryIn), &result);
+		int32_t signedPartialResult, signedResult;
+		const bool overflow = __builtin_add_overflow(int32_t(arg1), int32_t(arg2), &signedPartialResult) ^ __builtin_add_overflow(signedPartialResult, int32_t(carryIn), &signedResult);
+		return OpOutput<OpType::Arithmetic>(result, carry, overflow);
 	}
 	template<bool WithCarry, bool Reverse>
 	auto Sub(word arg1, word arg2, int carryIn){
@@ -93,6 +95,132 @@ namespace TurnipEmu::ARM7TDMI::ALU {
 
 		return value;
 	}
+	namespace DataProcessing {
+		using ShiftType = RequestInput::ShiftType;
+		
+		template<ShiftType Type, bool ByRegister>
+		inline word Shift(Instructions::InstructionRegisterInterface& registers, word value, word amount, int& shiftedCarryOut){
+			if constexpr (Type == ShiftType::LogicalShiftLeft){
+				if (value != 0) shiftedCarryOut = (value >> (32 - amount)) & 1;
+				return LogicalShiftLeft(value, amount).result;
+			}else if constexpr (Type == ShiftType::LogicalShiftRight){
+				shiftedCarryOut = (value >> (amount - 1)) & 1;
+				return LogicalShiftRight(value, amount).result;
+			}else if constexpr (Type == ShiftType::ArithmeticShiftRight){
+				shiftedCarryOut = (value >> (amount - 1)) & 1;
+				return ArithmeticShiftRight(value, amount, registers.cpsr().carry).result;
+			}else{
+				if (!ByRegister && amount == 0){
+					auto rorxResult = RotateRightExtended(value, amount, registers.cpsr().carry);
+					shiftedCarryOut = rorxResult.carry;
+					return rorxResult.result;
+				}
+				return RotateRight(value, amount).result;
+			}
+		}
+
+		template<uint8_t Form>
+		inline word Operand2(Instructions::InstructionRegisterInterface& registers, const Operands& operands, int& shiftedCarryOut){
+			if constexpr (Form == 0){
+				return operands.immediate;
+			}else{
+				constexpr bool ByRegister = Form >= 5;
+				constexpr ShiftType Type = static_cast<ShiftType>(Form - (ByRegister ? 5 : 1));
+				
+				const word value = registers.get(operands.operand2Register);
+				const word amount = ByRegister ? registers.get(operands.shift) : operands.shift;
+				return Shift<Type, ByRegister>(registers, value, amount, shiftedCarryOut);
+			}
+		}
+
+		template<uint8_t Opcode>
+		constexpr bool IsLogical = (Opcode <= 0x1) || (Opcode == 0x8) || (Opcode == 0x9) || (Opcode >= 0xC);
+		template<uint8_t Opcode>
+		constexpr bool WritesResult = (Opcode < 0x8) || (Opcode >= 0xC);
+
+		template<uint8_t Opcode>
+		inline word Logical(word arg1, word arg2){
+			switch(Opcode){
+			case 0x0: case 0x8: return arg1 & arg2; // AND, TST
+			case 0x1: case 0x9: return arg1 ^ arg2; // EOR, TEQ
+			case 0xC: return arg1 | arg2; // ORR
+			case 0xD: return arg2; // MOV
+			case 0xE: return arg1 & ~arg2; // BIC
+			default: return ~arg2; // MVN
+			}
+		}
+		template<uint8_t Opcode>
+		inline OpOutput<OpType::Arithmetic> Arithmetic(word arg1, word arg2, int carryIn){
+			switch(Opcode){
+			case 0x2: case 0xA: return Sub<false, false>(arg1, arg2, carryIn); // SUB, CMP
+			case 0x3: return Sub<false, true>(arg1, arg2, carryIn); // RSB
+			case 0x4: case 0xB: return Add<false>(arg1, arg2, carryIn); // ADD, CMN
+			case 0x5: return Add<true>(arg1, arg2, carryIn); // ADC
+			case 0x6: return Sub<true, false>(arg1, arg2, carryIn); // SBC
+			default: return Sub<true, true>(arg1, arg2, carryIn); // RSC
+			}
+		}
+
+		template<uint8_t Opcode, bool SetFlags, uint8_t Form>
+		void Execute(const Instructions::BaseInstructionCategory& category, CPU& cpu, Instructions::InstructionRegisterInterface registers, const Instructions::DecodedInstruction& decoded){
+			if constexpr (!WritesResult<Opcode> && !SetFlags){
+				throw std::runtime_error("ALU Request did not set flags or write result!");
+			}else{
+				const Operands& operands = decoded.as<Operands>();
+				
+				int shiftedCarryOut = 0;
+				const word operand1Value = registers.get(operands.operand1Register);
+				const word operand2Value = Operand2<Form>(registers, operands, shiftedCarryOut);
+
+				if constexpr (IsLogical<Opcode>){
+					const OpOutput<OpType::Logical> result(Logical<Opcode>(operand1Value, operand2Value));
+					if constexpr (WritesResult<Opcode>) registers.set(operands.destinationRegister, result.result);
+					if constexpr (SetFlags) result.ApplyToPSR(registers.cpsr(), shiftedCarryOut);
+				}else{
+					const auto result = Arithmetic<Opcode>(operand1Value, operand2Value, registers.cpsr().carry ? 1 : 0);
+					if constexpr (WritesResult<Opcode>) registers.set(operands.destinationRegister, result.result);
+					if constexpr (SetFlags) result.ApplyToPSR(registers.cpsr());
+				}
+			}
+		}
+
+		// Indexed by (opcode << 1 | S bit) * Operand2Forms + form
+		template<size_t... Indices>
+		constexpr std::array<Instructions::DecodedInstruction::Handler, sizeof...(Indices)> makeHandlers(std::index_sequence<Indices...>){
+			return {{ &Execute<((Indices / Operand2Forms) >> 1), ((Indices / Operand2Forms) & 1), (Indices % Operand2Forms)>... }};
+		}
+		constexpr auto handlers = makeHandlers(std::make_index_sequence<16 * 2 * Operand2Forms>());
+
+		void decode(word instructionWord, Instructions::DecodedInstruction& decoded){
+			static_assert(sizeof(Operands) <= sizeof(decoded.data));
+			Operands& operands = *new (decoded.data.data()) Operands();
+			
+			const bool immediate = (instructionWord >> 25) & 1;
+			const bool shiftedByRegister = (instructionWord >> 4) & 1;
+			const auto shiftType = static_cast<ShiftType>((instructionWord >> 5) & 0b11);
+			
+			operands.operand1Register = (instructionWord >> 16) & 0xF;
+			operands.destinationRegister = (instructionWord >> 12) & 0xF;
+			if (immediate){
+				const uint8_t rotation = ((instructionWord >> 8) & 0xF) * 2;
+				operands.immediate = instructionWord & 0xFF;
+				if (rotation) operands.immediate = RotateRight(operands.immediate, rotation).result;
+			}else{
+				operands.operand2Register = instructionWord & 0xF;
+				if (shiftedByRegister){
+					operands.shift = (instructionWord >> 8) & 0xF;
+					assert(operands.shift != 15);
+				}else{
+					operands.shift = (instructionWord >> 7) & 0b11111;
+				}
+			}
+
+			const uint8_t opcode = (instructionWord >> 21) & 0xF;
+			const bool setFlags = (instructionWord >> 20) & 1;
+			decoded.handler = handlers[((opcode << 1) | setFlags) * Operand2Forms + operand2Form(immediate, shiftedByRegister, shiftType)];
+		}
+	}
+
 	std::ostream& operator << (std::ostream& os, const RequestInput& requestInput){
 		if (requestInput.type == RequestInput::ValueType::Immediate){
 			os << Utils::HexFormat<word>(requestInput.immediateValue);
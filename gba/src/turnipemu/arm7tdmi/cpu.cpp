@@ -16,6 +16,8 @@ namespace TurnipEmu::ARM7TDMI{
 	}
 	void CPU::reset(){
 		memset(&state.registers, 0, sizeof(state.registers));
+		state.cyclesTotal = 0;
+		decodeCache.clear();
 
 		breakpoints = { 0x87a };
 
@@ -32,6 +34,8 @@ namespace TurnipEmu::ARM7TDMI{
 			state.registers.cpsr.mode = Mode::System;
 			state.registers.cpsr.state = CPUExecState::ARM;
 		}
+		// Every bank is zero, so there's nothing to swap
+		state.registerBankMode = state.registers.cpsr.mode;
 
 		switch(state.registers.cpsr.state){
 		case CPUExecState::ARM:
@@ -44,7 +48,7 @@ namespace TurnipEmu::ARM7TDMI{
 			assert(false);
 		}
 
-		debugStateWindow.reset();
+		if (tracing) debugStateWindow.reset();
 	}
 
 	
@@ -56,9 +60,15 @@ namespace TurnipEmu::ARM7TDMI{
 			const CPUExecState oldExecState = state.registers.cpsr.state;
 
 			if (currentRegisters.cpsr->state == CPUExecState::Thumb){
-				state.thumbPipeline.tick(*this, currentRegisters, CPU::matchThumbInstruction);
+				if (!tracing) state.thumbPipeline.fastTick<CPU::matchThumbInstruction>(*this, currentRegisters);
+				else state.thumbPipeline.tick<CPU::matchThumbInstruction>(*this, currentRegisters);
 			}else{
-				state.armPipeline.tick(*this, currentRegisters, CPU::matchArmInstruction);
+				if (!tracing) state.armPipeline.fastTick<CPU::matchArmInstruction>(*this, currentRegisters);
+				else state.armPipeline.tick<CPU::matchArmInstruction>(*this, currentRegisters);
+			}
+
+			if (state.registers.cpsr.mode != state.registerBankMode){
+				state.switchRegisterBank();
 			}
 
 			const CPUExecState newExecState = state.registers.cpsr.state;
@@ -76,24 +86,42 @@ namespace TurnipEmu::ARM7TDMI{
 			}
 
 			auto* pipeline = state.currentPipelineBaseData();
-			if (pipeline->hasDecodedInstruction &&
-				std::find(breakpoints.begin(), breakpoints.end(), pipeline->decodedInstructionAddress) != breakpoints.end()){
-				emulator.pause();
+			if (pipeline->hasDecodedInstruction && !breakpoints.empty()){
+				// The fast pipeline doesn't keep decodedInstructionAddress, but it's always two instructions behind the PC
+				const word nextInstructionAddress = tracing ?
+					pipeline->decodedInstructionAddress : state.registers.pc() - 2 * pipeline->instructionTypeSize;
+				if (std::find(breakpoints.begin(), breakpoints.end(), nextInstructionAddress) != breakpoints.end()){
+					emulator.pause();
+				}
 			}
 
-			state.cyclesThisTick = 1;
+			// The fetch and any data accesses, internal cycles aren't counted yet
+			state.cyclesThisTick += memoryMap.takeAccessCycles();
 			state.cyclesTotal += state.cyclesThisTick;
 
-			debugStateWindow.onCPUTick();
+			if (tracing) debugStateWindow.onCPUTick();
 		}catch(...){
 			LogLine("ARM7", "Exception was thrown in the CPU but then was caught!");
-			debugStateWindow.onCPUTick();
+			if (tracing) debugStateWindow.onCPUTick();
 			
 			throw;
 		}
 	}
 
-	const PipelineBase* CPUState::currentPipelineBaseData(){
+	void CPU::setTracing(bool enabled){
+		if (enabled && !tracing){
+			const auto currentRegisters = state.usableRegisters();
+			if (currentRegisters.cpsr->state == CPUExecState::Thumb){
+				state.thumbPipeline.materialize<CPU::matchThumbInstruction>(*this, currentRegisters);
+			}else{
+				state.armPipeline.materialize<CPU::matchArmInstruction>(*this, currentRegisters);
+			}
+			debugStateWindow.reset();
+		}
+		tracing = enabled;
+	}
+
+	const PipelineBase* CPUState::currentPipelineBaseData() const {
 		switch(registers.cpsr.state){
 		case CPUExecState::ARM:
 			return static_cast<const PipelineBase*>(&armPipeline);
@@ -106,59 +134,93 @@ namespace TurnipEmu::ARM7TDMI{
 		}
 	}
 	
-	const RegisterPointers CPUState::usableRegisters(bool shouldThrow) {
+	const RegisterPointers CPUState::usableRegisters() {
 		RegisterPointers pointers;
-
-		for (int i = 0; i < 16; i++){
-			pointers.main[i] = &registers.main[i];
-			pointers.changedRegisters[i] = &changedRegisters[i];
-		}
+		pointers.main = registers.main;
+		pointers.changedRegisters = changedRegisters;
 		pointers.cpsr = &registers.cpsr;
-		
-		switch (registers.cpsr.mode){
-		case Mode::User:
-		case Mode::System:
-			break;
-		case Mode::Supervisor:
-			pointers.main[13] = &registers.svc.r13;
-			pointers.main[14] = &registers.svc.r14;
-			pointers.spsr = &registers.svc.spsr;
-			break;
-		case Mode::FIQ:
-			pointers.main[8] = &registers.fiq.r8;
-			pointers.main[9] = &registers.fiq.r9;
-			pointers.main[10] = &registers.fiq.r10;
-			pointers.main[11] = &registers.fiq.r11;
-			pointers.main[12] = &registers.fiq.r12;
-			pointers.main[13] = &registers.fiq.r13;
-			pointers.main[14] = &registers.fiq.r14;
-			pointers.spsr = &registers.fiq.spsr;
-			break;
-		case Mode::IRQ:
-			pointers.main[13] = &registers.irq.r13;
-			pointers.main[14] = &registers.irq.r14;
-			pointers.spsr = &registers.irq.spsr;
-			break;
-		case Mode::Abort:
-			pointers.main[13] = &registers.abt.r13;
-			pointers.main[14] = &registers.abt.r14;
-			pointers.spsr = &registers.abt.spsr;
-			break;
-		case Mode::Undefined:
-			pointers.main[13] = &registers.und.r13;
-			pointers.main[14] = &registers.und.r14;
-			pointers.spsr = &registers.und.spsr;
-			break;
-		default:
-			if (shouldThrow){
-				// This can still happen, if an invalid value is written to the CPSR by the program.
-				throw std::runtime_error(Utils::streamFormat("Illegal Mode for CPSR. Value = ", (int)registers.cpsr.mode, " which is '", ModeString(registers.cpsr.mode), "'"));
-			}
+		if (registerBankMode != Mode::User && registerBankMode != Mode::System){
+			pointers.spsr = &registers.spsr;
 		}
-		
 		return pointers;
 	}
 
+	namespace {
+		struct RegisterBank {
+			word* r8ToR12[5];
+			word* r13;
+			word* r14;
+			ProgramStatusRegister* spsr;
+		};
+		bool findRegisterBank(AllRegisters& registers, Mode mode, RegisterBank& bank){
+			if (mode == Mode::FIQ){
+				bank = { { &registers.fiq.r8, &registers.fiq.r9, &registers.fiq.r10, &registers.fiq.r11, &registers.fiq.r12 }, nullptr, nullptr, nullptr };
+			}else{
+				bank = { { &registers.user.r8, &registers.user.r9, &registers.user.r10, &registers.user.r11, &registers.user.r12 }, nullptr, nullptr, nullptr };
+			}
+			switch (mode){
+			case Mode::User:
+			case Mode::System:
+				bank.r13 = &registers.user.r13;
+				bank.r14 = &registers.user.r14;
+				return true;
+			case Mode::FIQ:
+				bank.r13 = &registers.fiq.r13;
+				bank.r14 = &registers.fiq.r14;
+				bank.spsr = &registers.fiq.spsr;
+				return true;
+			case Mode::Supervisor:
+				bank.r13 = &registers.svc.r13;
+				bank.r14 = &registers.svc.r14;
+				bank.spsr = &registers.svc.spsr;
+				return true;
+			case Mode::IRQ:
+				bank.r13 = &registers.irq.r13;
+				bank.r14 = &registers.irq.r14;
+				bank.spsr = &registers.irq.spsr;
+				return true;
+			case Mode::Abort:
+				bank.r13 = &registers.abt.r13;
+				bank.r14 = &registers.abt.r14;
+				bank.spsr = &registers.abt.spsr;
+				return true;
+			case Mode::Undefined:
+				bank.r13 = &registers.und.r13;
+				bank.r14 = &registers.und.r14;
+				bank.spsr = &registers.und.spsr;
+				return true;
+			default:
+				return false;
+			}
+		}
+	}
+	void CPUState::switchRegisterBank(){
+		RegisterBank oldBank, newBank;
+		if (!findRegisterBank(registers, registers.cpsr.mode, newBank)){
+			// This can still happen, if an invalid value is written to the CPSR by the program.
+			throw std::runtime_error(Utils::streamFormat("Illegal Mode for CPSR. Value = ", (int)registers.cpsr.mode, " which is '", ModeString(registers.cpsr.mode), "'"));
+		}
+		const bool oldBankValid = findRegisterBank(registers, registerBankMode, oldBank);
+		assert(oldBankValid);
+
+		// When the modes share some registers, they're stored and loaded straight back again
+		for (int i = 0; i < 5; i++){
+			*oldBank.r8ToR12[i] = registers.main[8 + i];
+		}
+		*oldBank.r13 = registers.main[13];
+		*oldBank.r14 = registers.main[14];
+		if (oldBank.spsr) *oldBank.spsr = registers.spsr;
+
+		for (int i = 0; i < 5; i++){
+			registers.main[8 + i] = *newBank.r8ToR12[i];
+		}
+		registers.main[13] = *newBank.r13;
+		registers.main[14] = *newBank.r14;
+		if (newBank.spsr) registers.spsr = *newBank.spsr;
+
+		registerBankMode = registers.cpsr.mode;
+	}
+
 	void CPUState::resetPerTickVariables(){
 		for (bool& b : changedRegisters){
 			b = false;
@@ -5,18 +5,15 @@
 namespace TurnipEmu::ARM7TDMI::Debug {
 	CPUStateWindow::CPUStateWindow(CPU& cpu)
 		: Display::CustomWindow("ARM7TDMI Instruction Inspector", 600, 500), cpu(cpu) {
-		stateHistory = std::deque<CPUState>();
 	}
 
 	void CPUStateWindow::onCPUTick(){
-		if (stateHistory.size() > maxStateMemory) stateHistory.pop_front();
-		stateHistory.push_back(cpu.state);
-		selectedStateIndex = stateHistory.size() - 1;
+		trace.record(cpu.state);
+		selectedStateIndex = trace.size() - 1;
 		teleportToSelected = true;
 	}
 	void CPUStateWindow::reset(){
-		stateHistory.clear();
-		stateHistory.push_back(cpu.state);
+		trace.clear(cpu.state);
 		selectedStateIndex = 0;
 	}
 
@@ -53,7 +50,7 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 				{
 					ImGui::Indent();
 					ImGui::TextWrapped("Condition Code: %s [Fulfilled: %d]",
-								condition.debugString.c_str(),
+								condition.debugString,
 								condition.fulfilsCondition(*currentRegisters.cpsr));
 					ImGui::TextWrapped("Instruction Category: %s", instructionCategory->name.c_str());
 					ImGui::TextWrapped("Instruction Disassembly: %s", instructionCategory->disassembly(pipeline.decodedInstruction).c_str());
@@ -68,7 +65,7 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 	}
 
 	void CPUStateWindow::drawCPUState(CPUState& state){
-		const RegisterPointers registers = state.usableRegisters(false);
+		const RegisterPointers registers = state.usableRegisters();
 		
 		if (registers.cpsr->state == CPUExecState::Thumb){
 			displayPipeline(registers, state.thumbPipeline);
@@ -84,7 +81,7 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 			ImGui::Columns(2, "Registers");
 			for (int i = 0; i < 16; i++){
 				char buf[16];
-				sprintf(buf, "r%-2d: 0x%08x", i, *registers.main[i]);
+				sprintf(buf, "r%-2d: 0x%08x", i, registers.main[i]);
 				bool selected = selectedRegister == i;
 
 				ImGui::PushID(i);
@@ -168,6 +165,9 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 			}
 			ImGui::Unindent();
 
+			bool tracing = cpu.isTracing();
+			if (ImGui::Checkbox("Record History", &tracing))
+				cpu.setTracing(tracing);
 			if (ImGui::Checkbox("Show All Stages", &showPartialPipelineStates))
 				teleportToSelected = true;
 			if (ImGui::Checkbox("Merge Tight Loops", &mergeTightLoops))
@@ -178,29 +178,34 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 			ImGui::BeginChild("CPU History", ImVec2(0,0), true);
 			int tightLoopLength = 0;
 			word tightLoopStartInstruction = 0;
-			for (int i = 0; i < stateHistory.size(); i++){
-				const auto* statePipelineBaseData = stateHistory[i].currentPipelineBaseData();
+			const int historySize = trace.size();
+			for (int i = 0; i < historySize; i++){
+				const auto& record = trace[i];
 
 				if (!showPartialPipelineStates
-					&& !statePipelineBaseData->hasDecodedInstruction
-					&& i != stateHistory.size() - 1) continue;
+					&& !record.has(ExecutionTrace::Record::Decoded)
+					&& i != historySize - 1) continue;
 				if (strlen(instructionFilter) > 0
-					&& statePipelineBaseData->hasDecodedInstruction
-					&& statePipelineBaseData->decodedInstructionCategory->name.find(instructionFilter) == std::string::npos) continue;
+					&& record.has(ExecutionTrace::Record::Decoded)){
+					const BaseInstructionCategory* category = (record.cpsr.state == CPUExecState::Thumb) ?
+						static_cast<const BaseInstructionCategory*>(CPU::matchThumbInstruction(record.decodedInstruction)) :
+						static_cast<const BaseInstructionCategory*>(CPU::matchArmInstruction(record.decodedInstruction));
+					if (category->name.find(instructionFilter) == std::string::npos) continue;
+				}
 				if (selectedRegister != -1
 					&& i != registerTraceStartStateIndex
-					&& i != stateHistory.size() - 1
-					&& !stateHistory[i + 1].changedRegisters[selectedRegister]) continue;
-				if (mergeTightLoops && statePipelineBaseData->hasDecodedInstruction){
+					&& i != historySize - 1
+					&& !((trace[i + 1].changedRegisters >> selectedRegister) & 1)) continue;
+				if (mergeTightLoops && record.has(ExecutionTrace::Record::Decoded)){
 					bool insideTightLoop = false;
-					const auto currentPC = statePipelineBaseData->decodedInstructionAddress;
-					if (i < stateHistory.size() - 2) {
+					const auto currentPC = record.decodedInstructionAddress();
+					if (i < historySize - 2) {
 						int previousValidInstructions = 0;
 						for (int deltaI = -1; previousValidInstructions < maxTightLoopSize; deltaI--){
 							if (i + deltaI < 0) break;
-							const auto* prevStatePipelineBaseData = stateHistory[i + deltaI].currentPipelineBaseData();
-							if (prevStatePipelineBaseData->hasDecodedInstruction){
-								if (currentPC == prevStatePipelineBaseData->decodedInstructionAddress){
+							const auto& previousRecord = trace[i + deltaI];
+							if (previousRecord.has(ExecutionTrace::Record::Decoded)){
+								if (currentPC == previousRecord.decodedInstructionAddress()){
 									insideTightLoop = true;
 									break;
 								}
@@ -228,10 +233,10 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 				
 				char buf[15];
 				snprintf(buf, 15, "0x%08x %c%c%c",
-						statePipelineBaseData->decodedInstructionAddress,
-						statePipelineBaseData->hasFetchedInstruction ? 'F' : '/',
-						statePipelineBaseData->hasDecodedInstruction ? 'D' : '/',
-						statePipelineBaseData->hasExecutedInstruction ? 'E' : '/'
+						record.has(ExecutionTrace::Record::Decoded) ? record.decodedInstructionAddress() : 0,
+						record.has(ExecutionTrace::Record::Fetched) ? 'F' : '/',
+						record.has(ExecutionTrace::Record::Decoded) ? 'D' : '/',
+						record.has(ExecutionTrace::Record::Executed) ? 'E' : '/'
 					);
 				bool selected = selectedStateIndex == i;
 
@@ -253,13 +258,21 @@ namespace TurnipEmu::ARM7TDMI::Debug {
 
 		ImGui::BeginChild("CPU DATA");
 		{
-			if (selectedStateIndex != stateHistory.size() - 1){
+			if (!cpu.isTracing()){
+				ImGui::TextWrapped("Tick \"Record History\" to see what the CPU is doing.");
+				ImGui::Separator();
+			}
+			if (selectedStateIndex != trace.size() - 1){
 				ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1,0,0,1));
 				ImGui::TextWrapped("Warning: This is based on a previous CPU state. Any memory values this uses may have changed.");
 				ImGui::PopStyleColor();
 				ImGui::Separator();
 			}
-			drawCPUState(stateHistory[selectedStateIndex]);
+			if (selectedStateIndex < trace.size()){
+				CPUState selectedState;
+				trace.reconstruct(selectedStateIndex, selectedState);
+				drawCPUState(selectedState);
+			}
 		}
 		ImGui::EndChild();
 		
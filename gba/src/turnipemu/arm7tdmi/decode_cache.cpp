@@ -0,0 +1,38 @@
+#include "turnipemu/arm7tdmi/decode_cache.h"
+
+namespace TurnipEmu::ARM7TDMI {
+	DecodeCache::DecodeCache() : armEntries(EntryCount), thumbEntries(EntryCount), codePages((RAMEnd - RAMStart) / PageSize){
+		clear();
+	}
+
+	void DecodeCache::clear(){
+		for (auto& entry : armEntries){
+			entry.valid = false;
+		}
+		for (auto& entry : thumbEntries){
+			entry.valid = false;
+		}
+		std::fill(codePages.begin(), codePages.end(), false);
+	}
+
+	void DecodeCache::onWrite(uint32_t address, uint8_t byteWidth){
+		if (address < RAMStart || address >= RAMEnd) return;
+		// Writes are aligned to their width, so they can't cross into another page
+		const word page = (address - RAMStart) / PageSize;
+		if (codePages[page]){
+			invalidatePage(RAMStart + page * PageSize);
+			codePages[page] = false;
+		}
+	}
+
+	void DecodeCache::invalidatePage(word pageStart){
+		for (word address = pageStart; address < pageStart + PageSize; address += sizeof(word)){
+			Entry& entry = armEntries[(address / sizeof(word)) % EntryCount];
+			if (entry.address == address) entry.valid = false;
+		}
+		for (word address = pageStart; address < pageStart + PageSize; address += sizeof(halfword)){
+			Entry& entry = thumbEntries[(address / sizeof(halfword)) % EntryCount];
+			if (entry.address == address) entry.valid = false;
+		}
+	}
+}
@@ -0,0 +1,149 @@
+#include "turnipemu/arm7tdmi/execution_trace.h"
+
+#include "turnipemu/arm7tdmi/cpu.h"
+
+namespace TurnipEmu::ARM7TDMI::Debug {
+	void ExecutionTrace::clear(const CPUState& state){
+		// Only allocated once tracing is turned on
+		records.resize(Capacity);
+		values.resize(ValueCapacity);
+		
+		start = 0;
+		count = 0;
+		totalRecords = 0;
+		totalValues = 0;
+		keyframes.clear();
+		record(state);
+	}
+
+	void ExecutionTrace::record(const CPUState& state){
+		uint16_t changedRegisters = 0;
+		uint32_t changedCount = 0;
+		for (int i = 0; i < 16; i++){
+			if (state.changedRegisters[i]){
+				changedRegisters |= (1 << i);
+				changedCount++;
+			}
+		}
+
+		// Make room before anything is overwritten, so the first keyframe can be rolled forward over the records being dropped
+		if (count == Capacity) dropOldest();
+		while (count > 0 && (totalValues + changedCount - (*this)[0].firstValue) > ValueCapacity){
+			dropOldest();
+		}
+		
+		Record& record = records[(start + count) % Capacity];
+		const PipelineBase* pipeline = state.currentPipelineBaseData();
+		
+		record.pc = state.registers.main[15];
+		record.decodedInstruction = (state.registers.cpsr.state == CPUExecState::Thumb) ?
+			state.thumbPipeline.decodedInstruction : state.armPipeline.decodedInstruction;
+		record.cpsr = state.registers.cpsr;
+		record.spsr = state.registers.spsr;
+		record.pipelineStages = (pipeline->hasFetchedInstruction ? Record::Fetched : 0)
+			| (pipeline->hasDecodedInstruction ? Record::Decoded : 0)
+			| (pipeline->hasExecutedInstruction ? Record::Executed : 0);
+		record.changedRegisters = changedRegisters;
+		record.firstValue = totalValues;
+		for (int i = 0; i < 16; i++){
+			if (state.changedRegisters[i]){
+				values[totalValues % ValueCapacity] = state.registers.main[i];
+				totalValues++;
+			}
+		}
+		count++;
+		totalRecords++;
+		
+		if (keyframes.empty() || (totalRecords - 1) % KeyframeInterval == 0 || state.registerBankMode != lastRegisterBankMode){
+			addKeyframe(state);
+		}
+	}
+
+	void ExecutionTrace::addKeyframe(const CPUState& state){
+		keyframes.push_back(Keyframe{ totalRecords - 1, state.registers, state.registerBankMode });
+		lastRegisterBankMode = state.registerBankMode;
+	}
+
+	void ExecutionTrace::dropOldest(){
+		start = (start + 1) % Capacity;
+		count--;
+		if (count == 0) return;
+		
+		const uint64_t oldestRecordNumber = totalRecords - count;
+		while (keyframes.size() > 1 && keyframes[1].recordNumber <= oldestRecordNumber){
+			keyframes.pop_front();
+		}
+		// Nothing before the oldest record can be replayed any more, so the first keyframe has to move up to it
+		Keyframe& first = keyframes.front();
+		if (first.recordNumber < oldestRecordNumber){
+			assert(first.recordNumber + 1 == oldestRecordNumber);
+			const Record& oldest = (*this)[0];
+			replay(oldest, first.registers);
+			first.registers.main[15] = oldest.pc;
+			first.registers.cpsr = oldest.cpsr;
+			first.registers.spsr = oldest.spsr;
+			first.recordNumber = oldestRecordNumber;
+		}
+	}
+
+	void ExecutionTrace::replay(const Record& record, AllRegisters& registers) const {
+		uint32_t valueIndex = record.firstValue;
+		for (int r = 0; r < 16; r++){
+			if ((record.changedRegisters >> r) & 1){
+				registers.main[r] = values[valueIndex % ValueCapacity];
+				valueIndex++;
+			}
+		}
+	}
+
+	void ExecutionTrace::reconstruct(size_t index, CPUState& state) const {
+		assert(index < count);
+		const uint64_t recordNumber = totalRecords - count + index;
+
+		// The last keyframe at or before the record
+		auto keyframe = keyframes.begin();
+		for (auto it = keyframes.begin(); it != keyframes.end() && it->recordNumber <= recordNumber; it++){
+			keyframe = it;
+		}
+		state.registers = keyframe->registers;
+		state.registerBankMode = keyframe->registerBankMode;
+		
+		// Replay the writes since then. Anything else that changes between keyframes is in every record.
+		const size_t keyframeIndex = keyframe->recordNumber - (totalRecords - count);
+		for (size_t i = keyframeIndex + 1; i <= index; i++){
+			replay((*this)[i], state.registers);
+		}
+
+		const Record& record = (*this)[index];
+		state.registers.main[15] = record.pc;
+		state.registers.cpsr = record.cpsr;
+		state.registers.spsr = record.spsr;
+		for (int r = 0; r < 16; r++){
+			state.changedRegisters[r] = (record.changedRegisters >> r) & 1;
+		}
+
+		auto reconstructPipeline = [&record](auto& pipeline, auto decodeInstructionFunction){
+			pipeline.flush();
+			pipeline.hasFetchedInstruction = record.has(Record::Fetched);
+			pipeline.hasDecodedInstruction = record.has(Record::Decoded);
+			pipeline.hasExecutedInstruction = record.has(Record::Executed);
+			if (pipeline.hasFetchedInstruction){
+				pipeline.fetchedInstructionAddress = record.pc - record.instructionSize();
+			}
+			if (pipeline.hasDecodedInstruction){
+				pipeline.decodedInstructionAddress = record.decodedInstructionAddress();
+				pipeline.decodedInstruction = record.decodedInstruction;
+				pipeline.decodedInstructionCategory = decodeInstructionFunction(pipeline.decodedInstruction);
+			}
+			if (pipeline.hasExecutedInstruction){
+				// Nothing has been executed since a flush, so it was just before the decoded instruction
+				pipeline.executedInstructionAddress = record.decodedInstructionAddress() - record.instructionSize();
+			}
+		};
+		if (record.cpsr.state == CPUExecState::Thumb){
+			reconstructPipeline(state.thumbPipeline, CPU::matchThumbInstruction);
+		}else{
+			reconstructPipeline(state.armPipeline, CPU::matchArmInstruction);
+		}
+	}
+}
@@ -70,14 +70,14 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			stream << data.request;
 			return stream.str();
 		}
+		// Executing is done by the handlers in ALU::DataProcessing, InstructionData is only used for the disassembly
+		void decode(word instructionWord, DecodedInstruction& decoded) const override {
+			ALU::DataProcessing::decode(instructionWord, decoded);
+		}
 		void execute(CPU& cpu, InstructionRegisterInterface currentRegisters, word instructionWord) const override {
-			InstructionData data(instructionWord);
-			//if (data.restoreSPSR){
-			//	if (currentRegisters.cpsr().mode == Mode::User) return;
-			//	throw std::runtime_error("Implement SPSR restoration!");
-			//}
-			
-			data.request.Evaluate(currentRegisters);
+			DecodedInstruction decoded;
+			decode(instructionWord, decoded);
+			decoded.handler(*this, cpu, currentRegisters, decoded);
 		}
 	};
 }
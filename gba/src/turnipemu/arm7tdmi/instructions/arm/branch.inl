@@ -1,8 +1,9 @@
 #pragma once
 
 namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
-	class BranchInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class BranchInstruction : public CachedDecode<BranchInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 		
 		struct InstructionData {
 			int64_t offset;
@@ -19,8 +20,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			stream << "Branch by " << data.offset << ", link: " << std::boolalpha << data.link;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			if (data.link){
 				registers.set(registers.LR, registers.getNextInstructionAddress());
 			}
@@ -29,8 +29,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 		}
 	};
 
-	class BranchExchangeInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class BranchExchangeInstruction : public CachedDecode<BranchExchangeInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			bool link;
@@ -47,8 +48,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			stream << "Branch to location [Register " << (int)data.baseRegister << "], if bottom bit is 1 continue in Thumb, else continue in ARM. links: " << std::boolalpha << data.link;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			if (data.link){
 				throw std::runtime_error("Tried to do a Branch and eXchange with link enabled. Is this valid?");
 				//word pcForNextInstruction = *registers.main[15] + 4 - 8; // PC has been prefetched, the -8 undoes that
@@ -1,23 +1,22 @@
 #pragma once
 
 namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
-	#define CONDITION(NAME, CODE) Condition{ NAME, {#CODE}, [](ProgramStatusRegister status) { return CODE; } }
-	const std::array<const Condition, 15> InstructionCategory::conditions = {
-		CONDITION("EQ", status.zero),
-		CONDITION("NE", !status.zero),
-		CONDITION("CS", status.carry),
-		CONDITION("CC", !status.carry),
-		CONDITION("MI", status.negative),
-		CONDITION("PL", !status.negative),
-		CONDITION("VS", status.overflow),
-		CONDITION("VC", !status.overflow),
-		CONDITION("HI", status.carry && !status.zero),
-		CONDITION("LS", !status.carry || status.zero),
-		CONDITION("GE", status.negative == status.overflow),
-		CONDITION("LT", status.negative != status.overflow),
-		CONDITION("GT", !status.zero && (status.negative == status.overflow)),
-		CONDITION("LE", status.zero || (status.negative != status.overflow)),
-		CONDITION("AL", true),
-	};
-#undef CONDITION
+	const std::array<const Condition, 16> InstructionCategory::conditions = {{
+		{ 0x0, "EQ", "zero" },
+		{ 0x1, "NE", "!zero" },
+		{ 0x2, "CS", "carry" },
+		{ 0x3, "CC", "!carry" },
+		{ 0x4, "MI", "negative" },
+		{ 0x5, "PL", "!negative" },
+		{ 0x6, "VS", "overflow" },
+		{ 0x7, "VC", "!overflow" },
+		{ 0x8, "HI", "carry && !zero" },
+		{ 0x9, "LS", "!carry || zero" },
+		{ 0xA, "GE", "negative == overflow" },
+		{ 0xB, "LT", "negative != overflow" },
+		{ 0xC, "GT", "!zero && (negative == overflow)" },
+		{ 0xD, "LE", "zero || (negative != overflow)" },
+		{ 0xE, "AL", "true" },
+		{ 0xF, "NV", "false" },
+	}};
 }
@@ -3,8 +3,9 @@
 #include "turnipemu/arm7tdmi/misc.h"
 
 namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
-	class SingleDataTransferInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class SingleDataTransferInstruction : public CachedDecode<SingleDataTransferInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct TransferSize {
 			constexpr static bool Byte = true;
@@ -65,8 +66,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			stream << "\nIndexing: " << ((data.indexMode == DataTransferInfo::IndexMode::PreIndex) ? "Pre" : "Post");
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instructionWord) const override {
-			InstructionData data(instructionWord);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			
 			int finalOffset = (data.useImmediateOffset ? data.offset.immediateValue : data.offset.registerValue.calculateValue(registers, true)) * data.offsetSign;
 			word address = registers.get(data.addressRegister) + finalOffset;
@@ -100,8 +100,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 		}
 	};
 
-	class BlockDataTransferInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class BlockDataTransferInstruction : public CachedDecode<BlockDataTransferInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			MultipleLoadStore::InstructionData multipleLoadStoreInstruction;
@@ -126,8 +127,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			stream << data.multipleLoadStoreInstruction;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instructionWord) const override {
-			InstructionData data(instructionWord);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			if (data.loadPSR){
 				throw std::runtime_error("TODO: Implement S bit for Block Data Transfer");
@@ -1,7 +1,8 @@
 namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 	// Good Test Instruction: 0x0328f301 (MSR if EQ, from SPSR, flags only, immediate 1 rotated by 6
-	class MSRInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class MSRInstruction : public CachedDecode<MSRInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 		
 		struct InstructionData {
 			bool writeToSpecialPSR;
@@ -38,8 +39,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			}
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instructionWord) const override {
-			InstructionData data(instructionWord);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			word* targetRegister = data.writeToSpecialPSR ? &registers.spsr().value : &registers.cpsr().value;
 			word writeValue = data.operand.calculateValue(registers, true);
@@ -50,8 +50,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			*targetRegister = writeValue;
 		}
 	};
-	class MRSInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class MRSInstruction : public CachedDecode<MRSInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 		
 		struct InstructionData {
 			bool loadFromSpecialPSR;
@@ -74,8 +75,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::ARM {
 			stream << " into Register " << (int)data.destinationRegister;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instructionWord) const override {
-			InstructionData data(instructionWord);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			if (data.loadFromSpecialPSR){
 				registers.set(data.destinationRegister, registers.spsr().value);
 			}else{
@@ -12,6 +12,29 @@ namespace TurnipEmu::ARM7TDMI{
 	bool CPU::instructionsAreSetup = false;
 	std::vector<std::unique_ptr<const ARM::InstructionCategory>> CPU::armInstructions;
 	std::vector<std::unique_ptr<const Thumb::InstructionCategory>> CPU::thumbInstructions;
+	std::array<const ARM::InstructionCategory*, 4096> CPU::armDecodeTable;
+	std::array<const Thumb::InstructionCategory*, 1024> CPU::thumbDecodeTable;
+
+	// indexBits are the instruction bits that make up a table index, and indexToInstruction puts an index back into those bits.
+	// Each entry gets the first category (in priority order) that could match an instruction with that index,
+	// unless that category also needs bits outside of the index to decide.
+	template<typename InstructionCategoryType, size_t TableSize>
+	static void buildDecodeTable(std::array<const InstructionCategoryType*, TableSize>& table,
+								 const std::vector<std::unique_ptr<const InstructionCategoryType>>& instructions,
+								 word indexBits, std::function<word(size_t)> indexToInstruction){
+		for (size_t index = 0; index < TableSize; index++){
+			const word instruction = indexToInstruction(index);
+			table[index] = nullptr;
+			for (auto& instructionUniquePtr : instructions){
+				const Mask<word>& mask = instructionUniquePtr->mask;
+				if ((instruction & mask.mask & indexBits) != (mask.expectedValue & indexBits))
+					continue;
+				if ((mask.mask & ~indexBits) == 0)
+					table[index] = instructionUniquePtr.get();
+				break;
+			}
+		}
+	}
 	
 	void CPU::setupInstructions(){
 		if (instructionsAreSetup) return;
@@ -195,9 +218,19 @@ namespace TurnipEmu::ARM7TDMI{
 											{ 15, 12, 0b1111 }
 										}));
 
+		buildDecodeTable(armDecodeTable, armInstructions, 0x0FF000F0, [](size_t index){
+				return word(((index & 0xFF0) << 16) | ((index & 0xF) << 4));
+			});
+		// Thumb instructions never have bits 31-16 set, which the masks expect, so they count as part of the index
+		buildDecodeTable(thumbDecodeTable, thumbInstructions, 0xFFFFFFC0, [](size_t index){
+				return word(index << 6);
+			});
+
 		instructionsAreSetup = true;
 	}
 	const ARM::InstructionCategory* CPU::matchArmInstruction(word instruction){
+		if (const auto* category = armDecodeTable[armDecodeIndex(instruction)])
+			return category;
 		for (auto& instructionUniquePtr : armInstructions){
 			if (instructionUniquePtr->mask.matches(instruction))
 				return instructionUniquePtr.get();
@@ -205,6 +238,8 @@ namespace TurnipEmu::ARM7TDMI{
 		return nullptr;
 	}
 	const Thumb::InstructionCategory* CPU::matchThumbInstruction(halfword instruction){
+		if (const auto* category = thumbDecodeTable[thumbDecodeIndex(instruction)])
+			return category;
 		for (auto& instructionUniquePtr : thumbInstructions){
 			if (instructionUniquePtr->mask.matches(instruction))
 				return instructionUniquePtr.get();
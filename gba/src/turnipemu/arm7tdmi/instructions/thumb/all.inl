@@ -7,13 +7,7 @@
 #include "misc.inl"
 
 namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
-	const Condition InstructionCategory::always = {
-		"AL",
-		"true",
-		[](ProgramStatusRegister status) {
-			return true;
-		}
-	};
+	const Condition InstructionCategory::always = { Condition::Always, "AL", "true" };
 	
 	InstructionCategory::InstructionCategory(std::string name, Mask<word> mask)
 		: BaseInstructionCategory(name, mask)  {
@@ -2,8 +2,9 @@
 #include "turnipemu/arm7tdmi/instruction_category.h"
 
 namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
-	class ALUMoveShiftedRegisterInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class ALUMoveShiftedRegisterInstruction : public CachedDecode<ALUMoveShiftedRegisterInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		constexpr static std::array<const ALU::Operation*, 4> operations = {{
 				&ALU::Thumb::LSL,
@@ -33,14 +34,14 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			stream << data.request;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			data.request.Evaluate(registers);
 		}
 	};
 	
-	class ALUAddSubInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class ALUAddSubInstruction : public CachedDecode<ALUAddSubInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		constexpr static std::array<const ALU::Operation*, 2> operations = {{
 				&ALU::ADD,
@@ -73,14 +74,14 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			stream << data.request;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			data.request.Evaluate(registers);
 		}
 	};
 
-	class ALUImmediateInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class ALUImmediateInstruction : public CachedDecode<ALUImmediateInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		constexpr static std::array<const ALU::Operation*, 4> operations = {{
 				&ALU::MOV,
@@ -109,14 +110,14 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			stream << data.request;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			data.request.Evaluate(registers);
 		}
 	};
 	
-	class ALULowRegistersInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class ALULowRegistersInstruction : public CachedDecode<ALULowRegistersInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		constexpr static std::array<const ALU::Operation*, 16> operations = {{
 				&ALU::AND,
@@ -176,8 +177,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 				stream << data.multiplyRequest;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			if (data.isNormalRequest)
 				data.request.Evaluate(registers);
 			else
@@ -185,8 +185,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 		}
 	};
 
-	class ALUHighRegistersInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class ALUHighRegistersInstruction : public CachedDecode<ALUHighRegistersInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		constexpr static std::array<const ALU::Operation*, 3> operations = {{
 				&ALU::ADD,
@@ -220,15 +221,15 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			stream << data.request;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			data.request.Evaluate(registers);
 		}
 	};
 
 	
-	class ALULoadAddresswithOffset : public InstructionCategory {
-	using InstructionCategory::InstructionCategory;
+	class ALULoadAddresswithOffset : public CachedDecode<ALULoadAddresswithOffset, InstructionCategory> {
+	using CachedDecode::CachedDecode;
+	friend CachedDecode;
 
 		struct InstructionData {
 			ALU::Request request;
@@ -250,8 +251,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			stream << data.request;
 			return stream.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 			data.request.Evaluate(registers);
 		}
 	};
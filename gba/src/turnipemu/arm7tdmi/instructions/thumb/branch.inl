@@ -3,8 +3,9 @@
 #include "../arm/conditions.inl"
 
 namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
-	class ConditionalBranchInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class ConditionalBranchInstruction : public CachedDecode<ConditionalBranchInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			int16_t offset : 9;
@@ -22,15 +23,15 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 
 			return Utils::streamFormat("Branch by ", (int)data.offset);
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			registers.set(registers.PC, registers.get(registers.PC) + data.offset);
 		}
 	};
 
-	class UnconditionalBranchInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class UnconditionalBranchInstruction : public CachedDecode<UnconditionalBranchInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			int16_t offset : 12;
@@ -45,15 +46,15 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 
 			return Utils::streamFormat("Branch by ", (int)data.offset);
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			registers.set(registers.PC, registers.get(registers.PC) + data.offset);
 		}
 	};
 	
-	class LongBranchLinkInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class LongBranchLinkInstruction : public CachedDecode<LongBranchLinkInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			uint8_t instructionPart : 1; // This instruction is in two 'parts' that have to be executed consecutively
@@ -80,8 +81,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 
 			return Utils::streamFormat("Long Branch with Link part #", data.instructionPart + 1, ": offset to apply = ", Utils::HexFormat(data.offset));
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			if (data.instructionPart == 0){
 				registers.set(registers.LR, registers.get(registers.PC) + data.offset);
@@ -93,8 +93,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 		}
 	};
 
-	class BranchExchangeInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class BranchExchangeInstruction : public CachedDecode<BranchExchangeInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			bool link;
@@ -112,8 +113,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 
 			return Utils::streamFormat("Branch to [Register ", (int)data.baseRegister, "], if bottom bit is 1 then continue in Thumb else continue in ARM");
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			word newAddress = registers.get(data.baseRegister);
 			CPUExecState newState = (newAddress & 1) ? CPUExecState::Thumb : CPUExecState::ARM;
@@ -3,8 +3,9 @@
 #include "turnipemu/log.h"
 
 namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
-	class LoadStoreHalfwordInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class LoadStoreHalfwordInstruction : public CachedDecode<LoadStoreHalfwordInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		enum class TransferMode : bool {
 			Load = true,
@@ -42,8 +43,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			os << "Register " << (int)data.destinationRegister;
 			return os.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			word address = registers.get(data.baseRegister) + data.immediateValue;
 			if (data.transferMode == TransferMode::Load){
@@ -54,8 +54,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 		}
 	};
 
-	class LoadPCRelativeInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class LoadPCRelativeInstruction : public CachedDecode<LoadPCRelativeInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			uint16_t immediateValue : 10;
@@ -79,8 +80,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 				". The PC is forced to be word-aligned by zeroing bit 0."
 				);
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			word address = registers.get(registers.PC);
 			address = address & (word(~0) << 2); // Set bits 0 and 1 to 0, to make sure it's a multiple of 4
@@ -91,8 +91,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 		}
 	};
 
-	class LoadStoreSPRelativeInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class LoadStoreSPRelativeInstruction : public CachedDecode<LoadStoreSPRelativeInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		enum class TransferMode : bool {
 			Load = true,
@@ -128,8 +129,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			os << "Register " << (int)data.destinationRegister;
 			return os.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			word address = registers.get(registers.SP) + data.immediateValue;
 			if (data.transferMode == TransferMode::Load){
@@ -140,8 +140,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 		}
 	};
 
-	class LoadStoreImmediateOffsetInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class LoadStoreImmediateOffsetInstruction : public CachedDecode<LoadStoreImmediateOffsetInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		enum class TransferMode : bool {
 			Load = true,
@@ -190,8 +191,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			os << "Register " << (int)data.sourceRegister;
 			return os.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			word address = registers.get(data.addressRegister) + data.offset;
 			if (data.transferMode == TransferMode::Load){
@@ -210,8 +210,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 		}
 	};
 
-	class LoadStoreRegisterOffsetInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class LoadStoreRegisterOffsetInstruction : public CachedDecode<LoadStoreRegisterOffsetInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		enum class TransferMode : bool {
 			Load = true,
@@ -300,8 +301,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 
 			return os.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			word address = registers.get(data.baseRegister) + registers.get(data.offsetRegister);
 			if (data.transferMode == TransferMode::Load){
@@ -341,8 +341,9 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 		}
 	};
 
-	class MultipleLoadStoreInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class MultipleLoadStoreInstruction : public CachedDecode<MultipleLoadStoreInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 		
 		struct InstructionData : public MultipleLoadStore::InstructionData {
 			InstructionData(halfword instruction) {
@@ -368,8 +369,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			os << data;
 			return os.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			MultipleLoadStore::Execute(data, cpu, registers);
 		}
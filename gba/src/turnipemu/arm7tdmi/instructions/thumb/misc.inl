@@ -1,8 +1,9 @@
 #include "turnipemu/arm7tdmi/instruction_category.h"
 
 namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
-	class OffsetStackPointerInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class OffsetStackPointerInstruction : public CachedDecode<OffsetStackPointerInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 
 		struct InstructionData {
 			int offset;
@@ -19,8 +20,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 
 			return Utils::streamFormat("Offset the Stack Pointer by ", data.offset);
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			registers.set(registers.SP, registers.get(registers.SP) + data.offset);
 		}
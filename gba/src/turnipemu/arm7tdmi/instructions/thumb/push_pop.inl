@@ -4,8 +4,9 @@
 #include "turnipemu/arm7tdmi/misc.h"
 
 namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
-	class PushPopInstruction : public InstructionCategory {
-		using InstructionCategory::InstructionCategory;
+	class PushPopInstruction : public CachedDecode<PushPopInstruction, InstructionCategory> {
+		using CachedDecode::CachedDecode;
+		friend CachedDecode;
 		
 		struct InstructionData : public MultipleLoadStore::InstructionData {
 			InstructionData(halfword instruction) {
@@ -38,8 +39,7 @@ namespace TurnipEmu::ARM7TDMI::Instructions::Thumb {
 			os << data;
 			return os.str();
 		}
-		void execute(CPU& cpu, InstructionRegisterInterface registers, word instruction) const override {
-			InstructionData data(instruction);
+		void executeDecoded(CPU& cpu, InstructionRegisterInterface registers, InstructionData& data) const {
 
 			MultipleLoadStore::Execute(data, cpu, registers);
 		}
@@ -14,6 +14,7 @@ namespace TurnipEmu::ARM7TDMI {
 		
 		hasDecodedInstruction = false;
 		decodedInstructionCategory = nullptr;
+		decodedInstructionData = nullptr;
 		decodedInstruction = 0x0;
 		decodedInstructionAddress = 0x0;
 
@@ -24,19 +25,45 @@ namespace TurnipEmu::ARM7TDMI {
 	}
 
 	template<typename InstructionCategoryType, typename InstructionType>
-	void Pipeline<InstructionCategoryType, InstructionType>::tick(CPU& cpu, const RegisterPointers registers, std::function<const InstructionCategoryType*(InstructionType)> decodeInstructionFunction){
+	InstructionType Pipeline<InstructionCategoryType, InstructionType>::fetch(CPU& cpu, word address){
+		// The time is added when the CPU fetches it, which fastTick() does without reading it
+		if (auto instructionOptional = cpu.memoryMap.readWithoutTiming<InstructionType>(address)){
+			return instructionOptional.value();
+		}
+		throw std::runtime_error("PC is in invalid memory!");
+	}
+	
+	template<typename InstructionCategoryType, typename InstructionType>
+	template<typename Pipeline<InstructionCategoryType, InstructionType>::DecodeInstructionFunction Decode>
+	const Instructions::DecodedInstruction* Pipeline<InstructionCategoryType, InstructionType>::decode(CPU& cpu, word address, InstructionType instruction){
+		const auto* decoded = cpu.decodeCache.lookup(address, instruction, Decode);
+		if (!decoded){
+			throw std::runtime_error(
+				Utils::streamFormat(
+					"Couldn't decode instruction ",
+					Utils::HexFormat(instruction),
+					" (", Utils::BinaryFormat(instruction), ") "
+					)
+				);
+		}
+		return decoded;
+	}
+
+	template<typename InstructionCategoryType, typename InstructionType>
+	template<typename Pipeline<InstructionCategoryType, InstructionType>::DecodeInstructionFunction Decode>
+	void Pipeline<InstructionCategoryType, InstructionType>::tick(CPU& cpu, const RegisterPointers registers){
 
 		flushQueuedByInstruction = false;
 		
 		if (hasFetchedInstruction){
 			if (hasDecodedInstruction){
 				// Execute previously decoded instruction
-				const auto& condition = decodedInstructionCategory->getCondition(decodedInstruction);
-				if (condition.fulfilsCondition(*registers.cpsr)){
+				if (Condition::passes(decodedInstructionData->condition, *registers.cpsr)){
                     // This can flush the pipeline.
-					decodedInstructionCategory->execute(cpu,
-														InstructionRegisterInterface{this, registers},
-														decodedInstruction);
+					decodedInstructionData->handler(*decodedInstructionCategory,
+													cpu,
+													InstructionRegisterInterface{this, registers},
+													*decodedInstructionData);
 				}
 
 				hasExecutedInstruction = true;
@@ -46,16 +73,8 @@ namespace TurnipEmu::ARM7TDMI {
 			// Decode fetched instruction
 			decodedInstructionAddress = fetchedInstructionAddress;
 			decodedInstruction = fetchedInstruction;
-			decodedInstructionCategory = decodeInstructionFunction(decodedInstruction);
-			if (!decodedInstructionCategory){
-				throw std::runtime_error(
-					Utils::streamFormat(
-						"Couldn't decode instruction ",
-						Utils::HexFormat(decodedInstruction),
-						" (", Utils::BinaryFormat(decodedInstruction), ") "
-						)
-					);
-			}
+			decodedInstructionData = decode<Decode>(cpu, decodedInstructionAddress, decodedInstruction);
+			decodedInstructionCategory = decodedInstructionData->category;
 			hasDecodedInstruction = true;
 		}else{
 			assert(!hasDecodedInstruction);
@@ -65,18 +84,62 @@ namespace TurnipEmu::ARM7TDMI {
 			flush();
 		}else{
 			// Fetch the instruction
-			if (auto instructionOptional = cpu.memoryMap.read<InstructionType>(registers.pc())){
-				fetchedInstructionAddress = registers.pc();
-				fetchedInstruction = instructionOptional.value();
-				hasFetchedInstruction = true;
-			}else{
-				throw std::runtime_error("PC is in invalid memory!");
-			}
+			cpu.memoryMap.addAccessCycles<InstructionType>(registers.pc());
+			fetchedInstruction = fetch(cpu, registers.pc());
+			fetchedInstructionAddress = registers.pc();
+			hasFetchedInstruction = true;
 			
 			registers.pc() += sizeof(InstructionType);
 		}
 	}
 
+	template<typename InstructionCategoryType, typename InstructionType>
+	template<typename Pipeline<InstructionCategoryType, InstructionType>::DecodeInstructionFunction Decode>
+	void Pipeline<InstructionCategoryType, InstructionType>::fastTick(CPU& cpu, const RegisterPointers registers){
+		flushQueuedByInstruction = false;
+
+		if (hasDecodedInstruction){
+			// Instructions can ask for the address after theirs, which is worked out from this
+			decodedInstructionAddress = registers.pc() - 2 * sizeof(InstructionType);
+			const auto* decoded = decode<Decode>(cpu, decodedInstructionAddress, fetch(cpu, decodedInstructionAddress));
+			if (Condition::passes(decoded->condition, *registers.cpsr)){
+				decoded->handler(*decoded->category, cpu, InstructionRegisterInterface{this, registers}, *decoded);
+			}
+		}
+
+		if (flushQueuedByInstruction){
+			flush();
+		}else{
+			cpu.memoryMap.addAccessCycles<InstructionType>(registers.pc());
+			hasDecodedInstruction = hasFetchedInstruction;
+			hasFetchedInstruction = true;
+			registers.pc() += sizeof(InstructionType);
+		}
+	}
+
+	template<typename InstructionCategoryType, typename InstructionType>
+	template<typename Pipeline<InstructionCategoryType, InstructionType>::DecodeInstructionFunction Decode>
+	void Pipeline<InstructionCategoryType, InstructionType>::materialize(CPU& cpu, const RegisterPointers registers){
+		hasExecutedInstruction = false;
+		if (hasFetchedInstruction){
+			fetchedInstructionAddress = registers.pc() - sizeof(InstructionType);
+			fetchedInstruction = fetch(cpu, fetchedInstructionAddress);
+		}
+		if (hasDecodedInstruction){
+			decodedInstructionAddress = registers.pc() - 2 * sizeof(InstructionType);
+			decodedInstruction = fetch(cpu, decodedInstructionAddress);
+			decodedInstructionData = decode<Decode>(cpu, decodedInstructionAddress, decodedInstruction);
+			decodedInstructionCategory = decodedInstructionData->category;
+		}
+	}
+
 	template class Pipeline<ARM::InstructionCategory, word>;
 	template class Pipeline<Thumb::InstructionCategory, halfword>;
+
+	template void Pipeline<ARM::InstructionCategory, word>::tick<&CPU::matchArmInstruction>(CPU&, RegisterPointers);
+	template void Pipeline<ARM::InstructionCategory, word>::fastTick<&CPU::matchArmInstruction>(CPU&, RegisterPointers);
+	template void Pipeline<ARM::InstructionCategory, word>::materialize<&CPU::matchArmInstruction>(CPU&, RegisterPointers);
+	template void Pipeline<Thumb::InstructionCategory, halfword>::tick<&CPU::matchThumbInstruction>(CPU&, RegisterPointers);
+	template void Pipeline<Thumb::InstructionCategory, halfword>::fastTick<&CPU::matchThumbInstruction>(CPU&, RegisterPointers);
+	template void Pipeline<Thumb::InstructionCategory, halfword>::materialize<&CPU::matchThumbInstruction>(CPU&, RegisterPointers);
 }
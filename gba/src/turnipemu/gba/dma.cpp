@@ -1,8 +1,8 @@
 #include "turnipemu/gba/dma.h"
 
 namespace TurnipEmu::GBA{
-	DMAEngine::DMAEngine()
-		: Memory::RangeController(0x0'0400'00B0,  0x0'0400'00E0) {
+	DMAEngine::DMAEngine(Scheduler& scheduler)
+		: Memory::RangeController(0x0'0400'00B0,  0x0'0400'00E0), scheduler(scheduler) {
 	}
 	
 	void DMAEngine::execute(Memory::Map& memoryMap){
@@ -26,10 +26,32 @@ namespace TurnipEmu::GBA{
 		return true;
 	}
 	void DMAEngine::write(uint32_t address, byte value) {
+		writeBytes(address, value, 1);
+	}
+	void DMAEngine::write16(uint32_t address, halfword value) {
+		writeBytes(address, value, 2);
+	}
+	void DMAEngine::write32(uint32_t address, word value) {
+		writeBytes(address, value, 4);
+	}
+	void DMAEngine::writeBytes(uint32_t address, word value, int byteWidth) {
 		const uint32_t deltaAddress = (address - 0x0'0400'00B0);
 		const uint32_t channelIndex = deltaAddress / 12;
 		const uint32_t byteIndex = deltaAddress % 12;
 		assert(channelIndex < 4);
-		channels[channelIndex].externalState.data[byteIndex] = value;
+		assert(byteIndex + byteWidth <= 12);
+		
+		DMAChannel& channel = channels[channelIndex];
+		const bool wasEnabled = channel.enabled();
+		for (int i = 0; i < byteWidth; i++){
+			channel.externalState.data[byteIndex + i] = (value >> (8 * i)) & 0xFF;
+		}
+		// Only acted on once the whole value is in, so a word write of the count and control starts with the new count
+		if (!wasEnabled && channel.enabled()){
+			channel.latch();
+			if (channel.externalState.startTiming == StartTiming::Immediate){
+				scheduler.schedule(Scheduler::Event::DMA, scheduler.now());
+			}
+		}
 	}
 }
@@ -3,7 +3,9 @@
 #include "turnipemu/log.h"
 
 namespace TurnipEmu::GBA{
-	GBA::GBA(Display& display, std::vector<byte> biosData, GamePak gamePak) : Emulator(display, "GBA"), memoryMap(*this), cpu(*this, memoryMap), bios(biosData, 0x0), gamePak(gamePak) {
+	GBA::GBA(Display& display, std::vector<byte> biosData, GamePak gamePak) : Emulator(display, "GBA"), memoryMap(*this), cpu(*this, memoryMap), scheduler(cpu), bios(biosData, 0x0), gamePak(gamePak),
+		io{ LCDEngine(), DMAEngine(scheduler), SoundEngine(), TimerEngine(scheduler), Keypad(), UnusedIOMemoryController() },
+		systemControl(memoryMap) {
 		display.registerCustomWindow(this, &this->gamePak);
 		display.registerCustomWindow(this, &this->cpu.debugStateWindow);
 
@@ -20,27 +22,75 @@ namespace TurnipEmu::GBA{
 		memoryMap.registerMemoryController(&this->interruptControl);
 		memoryMap.registerMemoryController(&this->gamePak);
 
+		memoryMap.registerWriteObserver(&this->cpu.decodeCache);
+		io.timerEngine.registerOverflowObserver(&this->io.soundEngine);
+
 		reset();
 	}
 
 	void GBA::tick(){
 		try {
 			cpu.tick();
-			LogLineOverwrite(logTag, "Cycles: %d", cpu.totalCycles());
-			static auto vSyncTick = cpu.totalCycles();
-			if (cpu.totalCycles() - vSyncTick > 100000){
-				vsyncReady = true;
-				vSyncTick = cpu.totalCycles();
-			}else vsyncReady = false;
-			io.dmaEngine.execute(memoryMap);
-			io.timerEngine.execute(interruptControl);
-			// TODO: Handle user input
-			io.keypad.setKeysPressed(0, interruptControl);
+			runDueEvents();
+		} catch (const std::exception& e) {
+			handleException(e);
+		}
+	}
+	void GBA::tickUntilVSyncOrStopped(){
+		try {
+			while (!paused && !stopped && !vsyncReady){
+				// A breakpoint pauses in the middle. The instructions can schedule events themselves (starting a DMA or a timer),
+				// so the next one is checked again after every instruction rather than only once here.
+				while (cpu.totalCycles() < scheduler.nextEventCycle() && !paused){
+					cpu.tick();
+				}
+				runDueEvents();
+			}
 		} catch (const std::exception& e) {
-			LogLine(logTag, "Exception encountered, stopping...");
-			LogLine(logTag, "%s", e.what());
-			stop(std::string(e.what()));
+			handleException(e);
 		}
+		vsyncReady = false;
+	}
+
+	void GBA::runDueEvents(){
+		Scheduler::Event event;
+		uint64_t cycle;
+		while (scheduler.popDueEvent(cpu.totalCycles(), event, cycle)){
+			switch (event){
+			case Scheduler::Event::HBlank:
+				io.lcdEngine.startHBlank(interruptControl);
+				io.dmaEngine.execute(memoryMap);
+				scheduler.schedule(Scheduler::Event::HBlank, cycle + LCDEngine::ScanlineCycles);
+				break;
+			case Scheduler::Event::ScanlineEnd:
+				if (io.lcdEngine.nextScanline(interruptControl)){
+					io.dmaEngine.execute(memoryMap);
+					// TODO: Handle user input
+					io.keypad.setKeysPressed(0, interruptControl);
+					LogLineOverwrite(logTag, "Cycles: %llu", (unsigned long long)cpu.totalCycles());
+					vsyncReady = true;
+				}
+				scheduler.schedule(Scheduler::Event::ScanlineEnd, cycle + LCDEngine::ScanlineCycles);
+				break;
+			case Scheduler::Event::Timer0Overflow:
+			case Scheduler::Event::Timer1Overflow:
+			case Scheduler::Event::Timer2Overflow:
+			case Scheduler::Event::Timer3Overflow:
+				io.timerEngine.overflow(static_cast<int>(event) - static_cast<int>(Scheduler::Event::Timer0Overflow), cycle, interruptControl);
+				break;
+			case Scheduler::Event::DMA:
+				io.dmaEngine.execute(memoryMap);
+				break;
+			default:
+				assert(false);
+			}
+		}
+	}
+
+	void GBA::handleException(const std::exception& e){
+		LogLine(logTag, "Exception encountered, stopping...");
+		LogLine(logTag, "%s", e.what());
+		stop(std::string(e.what()));
 	}
 
 	void GBA::reset(){
@@ -49,9 +99,19 @@ namespace TurnipEmu::GBA{
 		paused = true;
 		cpu.reset();
 		systemControl.reset();
+		interruptControl.reset();
+		io.lcdEngine.reset();
+		io.timerEngine.reset();
+
+		// The CPU's cycles start again from 0
+		scheduler.reset();
+		scheduler.schedule(Scheduler::Event::HBlank, LCDEngine::HDrawCycles);
+		scheduler.schedule(Scheduler::Event::ScanlineEnd, LCDEngine::ScanlineCycles);
 	}
 	void GBA::reset(GamePak newGamePak){
 		gamePak = newGamePak;
+		// The ROM has moved
+		memoryMap.remapDirectMemory();
 		reset();
 	}
 }
@@ -34,14 +34,21 @@ namespace TurnipEmu::GBA{
 		}else if (address == 0x0'0400'0201){
 			enabledInterrupts.data[1] = value;
 		}else if (address == 0x0'0400'0202){
-			flaggedInterrupts.data[0] = value;
+			// Writing a 1 to a bit of IF acknowledges that interrupt
+			flaggedInterrupts.data[0] &= ~value;
 		}else if (address == 0x0'0400'0203){
-			flaggedInterrupts.data[1] = value;
+			flaggedInterrupts.data[1] &= ~value;
 		}else if (address >= 0x0'0400'0208 && address < 0x0'0400'020C){
 			interruptsMasterEnable.data[address - 0x0'0400'0208] = value;
 		}
 	}
 
+	void InterruptControl::request(Interrupt interrupt){
+		const halfword bit = static_cast<halfword>(interrupt);
+		flaggedInterrupts.data[0] |= bit & 0xFF;
+		flaggedInterrupts.data[1] |= bit >> 8;
+	}
+
 	void InterruptControl::reset(){
 		enabledInterrupts.data[0] = 0;
 		enabledInterrupts.data[1] = 0;
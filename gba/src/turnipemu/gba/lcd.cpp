@@ -1,6 +1,41 @@
 #include "turnipemu/gba/lcd.h"
+#include "turnipemu/gba/interrupt_control.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace TurnipEmu::GBA{
+	void LCDEngine::reset(){
+		memset(&io, 0, sizeof(io));
+	}
+	void LCDEngine::startHBlank(InterruptControl& interrupts){
+		io.status.hblankFlag = true;
+		if (io.status.enableHblankInterrupt){
+			interrupts.request(InterruptControl::Interrupt::HBlank);
+		}
+	}
+	bool LCDEngine::nextScanline(InterruptControl& interrupts){
+		io.status.hblankFlag = false;
+		io.status.currentScanline = (io.status.currentScanline + 1) % TotalScanlines;
+
+		const bool vblankStarted = (io.status.currentScanline == VisibleScanlines);
+		if (vblankStarted){
+			io.status.vblankFlag = true;
+			if (io.status.enableVblankInterrupt){
+				interrupts.request(InterruptControl::Interrupt::VBlank);
+			}
+		}else if (io.status.currentScanline == TotalScanlines - 1){
+			// The flag isn't set on the last scanline
+			io.status.vblankFlag = false;
+		}
+
+		io.status.vCountIsEqualToCurrentScanline = (io.status.currentScanline == io.status.vCount);
+		if (io.status.vCountIsEqualToCurrentScanline && io.status.enableVCounterInterrupt){
+			interrupts.request(InterruptControl::Interrupt::VCountMatch);
+		}
+		return vblankStarted;
+	}
+	
 	bool LCDEngine::ownsAddress(uint32_t address) const {
 		return (0x0'0400'0000 <= address && address < 0x0'0400'0060) ||
 			(0x0'0500'0000 <= address && address < 0x0'0500'0400) ||
@@ -32,6 +67,41 @@ namespace TurnipEmu::GBA{
 		}
 		*ownedAddressToByte(address) = value;
 	}
+	halfword LCDEngine::read16(uint32_t address) const {
+		return readSized<halfword>(address);
+	}
+	word LCDEngine::read32(uint32_t address) const {
+		return readSized<word>(address);
+	}
+	void LCDEngine::write16(uint32_t address, halfword value) {
+		if (address < 0x0'0500'0000) Memory::Controller::write16(address, value);
+		else writeSized(address, value);
+	}
+	void LCDEngine::write32(uint32_t address, word value) {
+		if (address < 0x0'0500'0000) Memory::Controller::write32(address, value);
+		else writeSized(address, value);
+	}
+	template<typename T>
+	T LCDEngine::readSized(uint32_t address) const {
+		// Every area is a multiple of 4 bytes long, so an aligned access never runs off the end
+		T value;
+		memcpy(&value, ownedAddressToByte(address), sizeof(T));
+		return value;
+	}
+	template<typename T>
+	void LCDEngine::writeSized(uint32_t address, T value) {
+		memcpy(ownedAddressToByte(address), &value, sizeof(T));
+	}
+	Memory::DirectMemory LCDEngine::directMemory(uint32_t address, uint32_t maxSize) {
+		auto memoryIn = [address, maxSize](byte* data, uint32_t start, uint32_t size) -> Memory::DirectMemory {
+			if (address < start || address >= start + size) return {};
+			byte* pointer = data + (address - start);
+			return { pointer, pointer, std::min(maxSize, start + size - address) };
+		};
+		if (auto memory = memoryIn(paletteRam.data, 0x0'0500'0000, sizeof(paletteRam)); memory.read) return memory;
+		if (auto memory = memoryIn(vram.data, 0x0'0600'0000, sizeof(vram)); memory.read) return memory;
+		return memoryIn(objectAttributes.data, 0x0'0700'0000, sizeof(objectAttributes));
+	}
 	byte* LCDEngine::ownedAddressToByte(uint32_t address){
 		if (0x0'0400'0000 <= address && address < 0x0'0400'0060)
 			return &io.data[address - 0x0'0400'0000];
@@ -44,4 +114,7 @@ namespace TurnipEmu::GBA{
 		assert(false);
 		return nullptr;
 	}
+	const byte* LCDEngine::ownedAddressToByte(uint32_t address) const {
+		return const_cast<LCDEngine*>(this)->ownedAddressToByte(address);
+	}
 }
@@ -0,0 +1,48 @@
+#include "turnipemu/gba/scheduler.h"
+
+#include "turnipemu/arm7tdmi/cpu.h"
+
+namespace TurnipEmu::GBA{
+	Scheduler::Scheduler(const ARM7TDMI::CPU& cpu) : cpu(cpu) {
+		reset();
+	}
+
+	uint64_t Scheduler::now() const {
+		return cpu.totalCycles();
+	}
+
+	void Scheduler::reset(){
+		eventCycles.fill(Never);
+		nextCycle = Never;
+	}
+	void Scheduler::schedule(Event event, uint64_t cycle){
+		eventCycles[static_cast<size_t>(event)] = cycle;
+		findNextEvent();
+	}
+	void Scheduler::cancel(Event event){
+		eventCycles[static_cast<size_t>(event)] = Never;
+		findNextEvent();
+	}
+
+	bool Scheduler::popDueEvent(uint64_t now, Event& event, uint64_t& cycle){
+		if (nextCycle > now) return false;
+
+		// Ties go to the event listed first
+		size_t earliest = 0;
+		for (size_t i = 1; i < EventCount; i++){
+			if (eventCycles[i] < eventCycles[earliest]) earliest = i;
+		}
+		event = static_cast<Event>(earliest);
+		cycle = eventCycles[earliest];
+		eventCycles[earliest] = Never;
+		findNextEvent();
+		return true;
+	}
+
+	void Scheduler::findNextEvent(){
+		nextCycle = Never;
+		for (uint64_t cycle : eventCycles){
+			if (cycle < nextCycle) nextCycle = cycle;
+		}
+	}
+}
@@ -8,6 +8,10 @@ namespace TurnipEmu::GBA{
 	const std::vector<uint8_t>& SoundEngine::generateSamples(size_t count){
 		throw std::runtime_error("Sound has not been implemented!");
 	}
+	void SoundEngine::onTimerOverflow(int timerIndex, uint64_t cycle){
+		// TODO: Direct Sound A and B play their FIFO's next sample here when timerIndex is the one they've selected
+		// (dmaSoundATimerSelect and dmaSoundBTimerSelect), and request a sound DMA once it's half empty. The FIFOs don't exist yet.
+	}
 	
 	bool SoundEngine::allowRead(uint32_t address) const {
 		// TODO: FIFO shouldn't be readable
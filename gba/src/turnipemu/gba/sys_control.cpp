@@ -1,9 +1,13 @@
 #include "turnipemu/gba/sys_control.h"
 #include "turnipemu/utils.h"
 
+#include <algorithm>
 #include <cstring>
 
 namespace TurnipEmu::GBA{  
+	SystemControl::SystemControl(Memory::Map& memoryMap) : memoryMap(memoryMap) {
+	}
+	
 	bool SystemControl::ownsAddress(uint32_t address) const {
 		int ioDelta = address - 0x0'0400'0000;
 		if (ioDelta < 0 || ioDelta > 0x0'00FF'FFFF) return false;
@@ -38,6 +42,7 @@ namespace TurnipEmu::GBA{
 		int ioDelta = address - 0x0'0400'0000;
 		if (0x0204 <= ioDelta && ioDelta < 0x0208){
 			waitstateControl.data[ioDelta - 0x0204] = value;
+			updateMemoryTiming();
 		}else if (ioDelta == 0x0300){
 			postBootFlag.data = value;
 		}else if (ioDelta == 0x0301){
@@ -47,6 +52,7 @@ namespace TurnipEmu::GBA{
 			return;
 		}else if (ioDelta % 0x0800 < 4){
 			internalMemControl.data[ioDelta % 0x0800] = value;
+			updateMemoryTiming();
 		}else{
 			assert(false);
 		}
@@ -63,5 +69,48 @@ namespace TurnipEmu::GBA{
 		
 		postBootFlag.data = 0;
 		haltControl.data = 0;
+
+		updateMemoryTiming();
+	}
+
+	void SystemControl::updateMemoryTiming(){
+		// Every access takes one cycle, plus the waitstates for the area
+		auto timing = [](uint8_t nonSequentialWaitstates, uint8_t sequentialWaitstates, bool bus32) {
+			const uint8_t nonSequential = 1 + nonSequentialWaitstates;
+			const uint8_t sequential = 1 + sequentialWaitstates;
+			Memory::AccessTiming timing;
+			timing.cycles[0][0] = timing.cycles[0][1] = nonSequential;
+			timing.cycles[1][0] = timing.cycles[1][1] = sequential;
+			// On a 16 bit bus a word is two halfwords, and the second one is always sequential
+			timing.cycles[0][2] = bus32 ? nonSequential : nonSequential + sequential;
+			timing.cycles[1][2] = bus32 ? sequential : 2 * sequential;
+			return timing;
+		};
+		
+		// BIOS, 32K WRAM, IO and OAM have no waitstates and a 32 bit bus
+		memoryMap.setTiming(0x0000'0000, 0x0200'0000, timing(0, 0, true));
+		memoryMap.setTiming(0x0300'0000, 0x0500'0000, timing(0, 0, true));
+		memoryMap.setTiming(0x0700'0000, 0x0800'0000, timing(0, 0, true));
+		// Palette RAM and VRAM are on a 16 bit bus
+		memoryMap.setTiming(0x0500'0000, 0x0700'0000, timing(0, 0, false));
+
+		// 15 locks the GBA up, which isn't emulated, so it's treated as 14
+		const uint8_t wram256Waitstates = 15 - std::min<uint8_t>(internalMemControl.wram256WaitState, 14);
+		memoryMap.setTiming(0x0200'0000, 0x0300'0000, timing(wram256Waitstates, wram256Waitstates, false));
+
+		constexpr static uint8_t FirstAccessWaitstates[4] = { 4, 3, 2, 8 };
+		auto gamePakTiming = [&](uint8_t firstAccess, uint8_t secondAccess) {
+			// With prefetching, sequential reads come from the prefetch buffer instead of waiting.
+			// This assumes the buffer always keeps up, which it does for code running straight through ROM.
+			if (waitstateControl.enablePrefetch) return timing(FirstAccessWaitstates[firstAccess], 0, false);
+			return timing(FirstAccessWaitstates[firstAccess], secondAccess, false);
+		};
+		memoryMap.setTiming(0x0800'0000, 0x0A00'0000, gamePakTiming(waitstateControl.ws0FirstAccess, waitstateControl.ws0SecondAccess ? 1 : 2));
+		memoryMap.setTiming(0x0A00'0000, 0x0C00'0000, gamePakTiming(waitstateControl.ws1FirstAccess, waitstateControl.ws1SecondAccess ? 1 : 4));
+		memoryMap.setTiming(0x0C00'0000, 0x0E00'0000, gamePakTiming(waitstateControl.ws2FirstAccess, waitstateControl.ws2SecondAccess ? 1 : 8));
+
+		// SRAM is on an 8 bit bus, but only byte accesses are allowed so that's ignored
+		const uint8_t sramWaitstates = FirstAccessWaitstates[waitstateControl.sramWait];
+		memoryMap.setTiming(0x0E00'0000, Memory::Map::AddressSpaceSize, timing(sramWaitstates, sramWaitstates, false));
 	}
 }
@@ -1,13 +1,73 @@
 #include "turnipemu/gba/timer.h"
+#include "turnipemu/gba/interrupt_control.h"
 #include "turnipemu/log.h"
 
 namespace TurnipEmu::GBA{
-	TimerEngine::TimerEngine()
-		: Memory::RangeController(0x0'0400'0100, 0x0'0400'0110) {}
+	TimerEngine::TimerEngine(Scheduler& scheduler)
+		: Memory::RangeController(0x0'0400'0100, 0x0'0400'0110), scheduler(scheduler) {}
 	
-	void TimerEngine::execute(InterruptControl& interrupts){
-		if (timers[0].enabled() || timers[1].enabled() || timers[2].enabled() || timers[3].enabled())
-			throw std::runtime_error("Timers have not been implemented!");
+	void TimerEngine::reset(){
+		for (TimerData& timer : timers){
+			timer.control.data[0] = 0;
+			timer.control.data[1] = 0;
+			timer.counter = 0;
+			timer.reload = 0;
+			timer.startCycle = 0;
+		}
+	}
+
+	void TimerEngine::registerOverflowObserver(TimerOverflowObserver* overflowObserver){
+		assert(overflowObserver);
+		overflowObservers.push_back(overflowObserver);
+	}
+	void TimerEngine::overflow(int timerIndex, uint64_t cycle, InterruptControl& interrupts){
+		TimerData& timer = timers[timerIndex];
+		timer.counter = timer.reload;
+		timer.startCycle = cycle;
+		if (timer.control.irqOnOverflow){
+			const halfword interruptBit = static_cast<halfword>(InterruptControl::Interrupt::Timer0Overflow) << timerIndex;
+			interrupts.request(static_cast<InterruptControl::Interrupt>(interruptBit));
+		}
+		for (auto* observer : overflowObservers){
+			observer->onTimerOverflow(timerIndex, cycle);
+		}
+		if (timerIndex < 3){
+			TimerData& next = timers[timerIndex + 1];
+			if (next.enabled() && next.control.countUp){
+				next.counter++;
+				if (next.counter == 0){
+					overflow(timerIndex + 1, cycle, interrupts);
+				}
+			}
+		}
+		scheduleOverflow(timerIndex);
+	}
+
+	bool TimerEngine::runsOnClock(int timerIndex) const {
+		// Timer 0 can't count up, it has no previous timer
+		const TimerData& timer = timers[timerIndex];
+		return timer.enabled() && !(timerIndex > 0 && timer.control.countUp);
+	}
+	halfword TimerEngine::counterValue(int timerIndex) const {
+		const TimerData& timer = timers[timerIndex];
+		if (!runsOnClock(timerIndex)) return timer.counter;
+		
+		const uint64_t increments = (scheduler.now() - timer.startCycle) >> timer.prescalerShift();
+		const uint64_t incrementsUntilOverflow = 0x10000 - timer.counter;
+		if (increments < incrementsUntilOverflow){
+			return timer.counter + increments;
+		}
+		// It's overflowed during the current instruction, and the event hasn't been handled yet
+		return timer.reload + (increments - incrementsUntilOverflow) % (0x10000 - timer.reload);
+	}
+	void TimerEngine::scheduleOverflow(int timerIndex){
+		const auto event = static_cast<Scheduler::Event>(static_cast<int>(Scheduler::Event::Timer0Overflow) + timerIndex);
+		const TimerData& timer = timers[timerIndex];
+		if (runsOnClock(timerIndex)){
+			scheduler.schedule(event, timer.startCycle + (uint64_t(0x10000 - timer.counter) << timer.prescalerShift()));
+		}else{
+			scheduler.cancel(event);
+		}
 	}
 	
 	bool TimerEngine::allowRead(uint32_t address) const {
@@ -19,9 +79,9 @@ namespace TurnipEmu::GBA{
 		const uint32_t byteIndex = deltaAddress % 4;
 		switch(byteIndex){
 		case 0:
-			return (timers[timerIndex].counter >> 0) & 0xF;
+			return (counterValue(timerIndex) >> 0) & 0xFF;
 		case 1:
-			return (timers[timerIndex].counter >> 8) & 0xF;
+			return (counterValue(timerIndex) >> 8) & 0xFF;
 		case 2:
 		case 3:
 			return timers[timerIndex].control.data[byteIndex - 2];
@@ -33,20 +93,59 @@ namespace TurnipEmu::GBA{
 		return true;
 	}
 	void TimerEngine::write(uint32_t address, byte value) {
+		writeBytes(address, value, 1);
+	}
+	void TimerEngine::write16(uint32_t address, halfword value) {
+		writeBytes(address, value, 2);
+	}
+	void TimerEngine::write32(uint32_t address, word value) {
+		writeBytes(address, value, 4);
+	}
+	void TimerEngine::writeBytes(uint32_t address, word value, int byteWidth) {
 		const uint32_t deltaAddress = (address - 0x0'0400'0100);
 		const uint32_t timerIndex = deltaAddress / 4;
-		const uint32_t byteIndex = deltaAddress % 4;
-		switch(byteIndex){
-		case 0:
-			timers[timerIndex].reload = (timers[timerIndex].reload & 0xF0) | (value << 0);
-			break;
-		case 1:
-			timers[timerIndex].reload = (timers[timerIndex].reload & 0x0F) | (value << 8);
-			break;
-		case 2:
-		case 3:
-			timers[timerIndex].control.data[byteIndex - 2] = value;
-			break;
+		const uint32_t firstByteIndex = deltaAddress % 4;
+		assert(firstByteIndex + byteWidth <= 4);
+
+		TimerData& timer = timers[timerIndex];
+		const bool wasEnabled = timer.enabled();
+		const bool wasRunningOnClock = runsOnClock(timerIndex);
+		const uint32_t oldPrescalerShift = timer.prescalerShift();
+		// Counted up to now with the old control
+		const halfword currentCounter = counterValue(timerIndex);
+		bool controlWritten = false;
+		for (int i = 0; i < byteWidth; i++){
+			const uint32_t byteIndex = firstByteIndex + i;
+			const byte byteValue = (value >> (8 * i)) & 0xFF;
+			switch(byteIndex){
+			case 0:
+				timer.reload = (timer.reload & 0xFF00) | (byteValue << 0);
+				break;
+			case 1:
+				timer.reload = (timer.reload & 0x00FF) | (byteValue << 8);
+				break;
+			case 2:
+			case 3:
+				timer.control.data[byteIndex - 2] = byteValue;
+				controlWritten = true;
+				break;
+			}
+		}
+		// The reload value isn't used until the next overflow or start
+		if (!controlWritten) return;
+
+		const uint64_t now = scheduler.now();
+		if (!wasEnabled && timer.enabled()){
+			// The counter starts from the reload value, which a word write sets at the same time as starting the timer
+			timer.counter = timer.reload;
+			timer.startCycle = now;
+		}else{
+			// Carries on (or stops) from where it's got to. If it's still counting at the same rate it also keeps
+			// the cycles it's counted towards the next increment.
+			timer.counter = currentCounter;
+			const bool keepsPrescaler = wasRunningOnClock && runsOnClock(timerIndex) && timer.prescalerShift() == oldPrescalerShift;
+			timer.startCycle = keepsPrescaler ? now - ((now - timer.startCycle) & ((1 << oldPrescalerShift) - 1)) : now;
 		}
+		scheduleOverflow(timerIndex);
 	}
 }
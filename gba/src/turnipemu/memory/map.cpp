@@ -4,13 +4,47 @@
 #include "turnipemu/log.h"
 #include "turnipemu/utils.h"
 
+
 namespace TurnipEmu::Memory{
-	Map::Map(Emulator& emulator) : emulator(emulator){
+	Map::Map(Emulator& emulator) : pages(PageCount), emulator(emulator){
 	}
 	
 	void Map::registerMemoryController(Controller* memoryController){
 		assert(memoryController);
 		memoryControllers.push_back(memoryController);
+		mapDirectMemory(memoryController);
+	}
+	void Map::remapDirectMemory(){
+		for (Page& page : pages){
+			page = Page{ nullptr, nullptr, 0, page.timing };
+		}
+		for (auto* controller : memoryControllers){
+			mapDirectMemory(controller);
+		}
+	}
+	void Map::mapDirectMemory(Controller* memoryController){
+		for (uint32_t i = 0; i < PageCount; i++){
+			Page& page = pages[i];
+			if (page.size != 0) continue; // Taken by an earlier controller
+			
+			const DirectMemory memory = memoryController->directMemory(i * PageSize, PageSize);
+			if (memory.read && memory.size > 0){
+				assert(memory.size <= PageSize);
+				assert(!memory.write || memory.write == memory.read);
+				page = Page{ memory.read, memory.write, memory.size };
+			}
+		}
+	}
+	void Map::setTiming(uint32_t startAddress, uint32_t endAddress, const AccessTiming& timing){
+		assert(startAddress % PageSize == 0 && endAddress % PageSize == 0);
+		assert(startAddress <= endAddress && endAddress <= AddressSpaceSize);
+		for (uint32_t i = startAddress / PageSize; i < endAddress / PageSize; i++){
+			pages[i].timing = timing;
+		}
+	}
+	void Map::registerWriteObserver(WriteObserver* writeObserver){
+		assert(writeObserver);
+		writeObservers.push_back(writeObserver);
 	}
 
 	Controller* Map::controllerForAddress(uint32_t address, bool accessByEmulator) const {
@@ -26,7 +60,7 @@ namespace TurnipEmu::Memory{
 	}
 
 	template<typename ReadType>
-	std::optional<ReadType> Map::read(uint32_t address, bool accessByEmulator) const {
+	std::optional<ReadType> Map::readThroughController(uint32_t address, bool accessByEmulator) const {
 		if(address % sizeof(ReadType) != 0){
 			// Byte reads MUST be on byte-boundaries, halfwords on 2-byte boundaries, words on 4-byte boundaries.
 			if (accessByEmulator){
@@ -37,25 +71,28 @@ namespace TurnipEmu::Memory{
 		
 		auto* controller = controllerForAddress(address, accessByEmulator);
 		if (controller){
-			ReadType value = 0;
 			for (int i = 0; i < sizeof(ReadType); i++){
-				if (controller->allowRead(address + i))
-					value = value | controller->read(address + i) << (8 * i);
-				else{
+				if (!controller->allowRead(address + i)){
 					return {};
 				}
 			}
-			return {value};
+			if constexpr (sizeof(ReadType) == sizeof(byte)){
+				return {controller->read(address)};
+			}else if constexpr (sizeof(ReadType) == sizeof(halfword)){
+				return {controller->read16(address)};
+			}else{
+				return {controller->read32(address)};
+			}
 		}else{
 			return {};
 		}
 	}
-	template std::optional<byte> Map::read<byte>(uint32_t, bool) const;
-	template std::optional<halfword> Map::read<halfword>(uint32_t, bool) const;
-	template std::optional<word> Map::read<word>(uint32_t, bool) const;
+	template std::optional<byte> Map::readThroughController<byte>(uint32_t, bool) const;
+	template std::optional<halfword> Map::readThroughController<halfword>(uint32_t, bool) const;
+	template std::optional<word> Map::readThroughController<word>(uint32_t, bool) const;
 
 	template<typename WriteType>
-	bool Map::write(uint32_t address, WriteType value, bool accessByEmulator) const {
+	bool Map::writeThroughController(uint32_t address, WriteType value, bool accessByEmulator) const {
 		if(address % sizeof(WriteType) != 0){
 			// Byte writes MUST be on byte-boundaries, halfwords on 2-byte boundaries, words on 4-byte boundaries.
 			if (accessByEmulator){
@@ -66,18 +103,25 @@ namespace TurnipEmu::Memory{
 		
 		auto* controller = controllerForAddress(address, accessByEmulator);
 		if (controller){
+			// Either the whole value is written or none of it
 			for (int i = 0; i < sizeof(WriteType); i++){
-				if (controller->allowWrite(address + i))
-					controller->write(address + i, (value >> (8 * i)) & 0xFF);
-				else{
+				if (!controller->allowWrite(address + i)){
 					return false;
 				}
 			}
+			if constexpr (sizeof(WriteType) == sizeof(byte)){
+				controller->write(address, value);
+			}else if constexpr (sizeof(WriteType) == sizeof(halfword)){
+				controller->write16(address, value);
+			}else{
+				controller->write32(address, value);
+			}
+			notifyWriteObservers(address, sizeof(WriteType));
 			return true;
 		}
 		return false;
 	}
-	template bool Map::write<byte>(uint32_t, byte, bool) const;
-	template bool Map::write<halfword>(uint32_t, halfword, bool) const;
-	template bool Map::write<word>(uint32_t, word, bool) const;
+	template bool Map::writeThroughController<byte>(uint32_t, byte, bool) const;
+	template bool Map::writeThroughController<halfword>(uint32_t, halfword, bool) const;
+	template bool Map::writeThroughController<word>(uint32_t, word, bool) const;
 }
@@ -0,0 +1,102 @@
+// Records far more ticks than the trace can hold, so its ring wraps (and the first keyframe has to be rolled forward),
+// and checks the registers it reconstructs against the ones that were recorded.
+
+#include "test.h"
+
+#include "turnipemu/arm7tdmi/cpu.h"
+#include "turnipemu/arm7tdmi/execution_trace.h"
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+using namespace TurnipEmu;
+using namespace TurnipEmu::ARM7TDMI;
+using Debug::ExecutionTrace;
+
+namespace {
+	using Registers = std::array<word, 16>;
+
+	class Recorder {
+	public:
+		Recorder(){
+			memset(&state.registers, 0, sizeof(state.registers));
+			state.registers.cpsr.mode = Mode::Supervisor;
+			state.registers.cpsr.state = CPUExecState::ARM;
+			state.registerBankMode = Mode::Supervisor;
+			state.armPipeline.flush();
+			trace.clear(state);
+			remember();
+		}
+
+		// Writes writesPerTick registers (other than the PC) with new values, and swaps the bank every so often
+		void tick(int writesPerTick){
+			state.resetPerTickVariables();
+			for (int i = 0; i < writesPerTick; i++){
+				const int r = (ticks + i * 5) % 15;
+				state.registers.main[r] = ticks * 2654435761u + r;
+				state.changedRegisters[r] = true;
+			}
+			state.registers.main[15] += sizeof(word);
+			if (ticks % 5000 == 4999){
+				const Mode mode = (state.registerBankMode == Mode::Supervisor) ? Mode::IRQ : Mode::Supervisor;
+				state.registers.cpsr.mode = mode;
+				state.registerBankMode = mode;
+			}
+			trace.record(state);
+			remember();
+			ticks++;
+		}
+
+		// Checks a spread of records, including the oldest, ones either side of each keyframe interval and the newest
+		void check(){
+			CHECK(trace.size() <= ExecutionTrace::Capacity);
+			CHECK(trace.size() < history.size());
+			const size_t first = history.size() - trace.size();
+			for (size_t index = 0; index < trace.size(); index++){
+				const bool nearKeyframe = (index % ExecutionTrace::KeyframeInterval) < 2 || (index % ExecutionTrace::KeyframeInterval) > ExecutionTrace::KeyframeInterval - 2;
+				if (!(index < 2 * ExecutionTrace::KeyframeInterval || nearKeyframe || index % 97 == 0 || index + 2 >= trace.size())) continue;
+				
+				CPUState reconstructed;
+				trace.reconstruct(index, reconstructed);
+				Registers registers;
+				std::copy(std::begin(reconstructed.registers.main), std::end(reconstructed.registers.main), registers.begin());
+				CHECK(registers == history[first + index]);
+				if (registers != history[first + index]){
+					fprintf(stderr, "  record %zu of %zu was wrong\n", index, trace.size());
+					return;
+				}
+			}
+		}
+
+	protected:
+		void remember(){
+			Registers registers;
+			std::copy(std::begin(state.registers.main), std::end(state.registers.main), registers.begin());
+			history.push_back(registers);
+		}
+
+		CPUState state;
+		ExecutionTrace trace;
+		std::vector<Registers> history;
+		int ticks = 0;
+	};
+}
+
+int main(){
+	Recorder recorder;
+	
+	// Dropped because the ring of records is full
+	for (size_t i = 0; i < ExecutionTrace::Capacity + ExecutionTrace::KeyframeInterval * 3 + 100; i++){
+		recorder.tick(1);
+	}
+	recorder.check();
+
+	// Dropped because the ring of values is full, several at a time
+	for (size_t i = 0; i < ExecutionTrace::ValueCapacity / 4; i++){
+		recorder.tick(14);
+	}
+	recorder.check();
+
+	return Test::result();
+}
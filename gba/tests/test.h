@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdio>
+
+// Each test is its own executable, which prints the checks that failed to stderr and fails if there were any.
+// make test-units builds and runs all of them.
+namespace TurnipEmu::Test {
+	inline int failures = 0;
+	// For main() to return
+	inline int result(){
+		return failures == 0 ? 0 : 1;
+	}
+}
+
+#define CHECK(condition) do { \
+		if (!(condition)){ \
+			fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+			TurnipEmu::Test::failures++; \
+		} \
+	} while (0)